@@ -1,5 +1,6 @@
 // Copyright Epic Games, Inc. All Rights Reserved.
 
+using System;
 using UnrealBuildTool;
 
 public class MultiplayerSessions : ModuleRules
@@ -27,6 +28,7 @@ public class MultiplayerSessions : ModuleRules
 			{
 				"Core",
 				"OnlineSubsystem",
+				"OnlineSubsystemUtils",
 				"OnlineSubsystemSteam",
 				"UMG",
 				"Slate",
@@ -42,6 +44,8 @@ public class MultiplayerSessions : ModuleRules
 				"Engine",
 				"Slate",
 				"SlateCore",
+				"Sockets",
+				"Networking",
 				// ... add private dependencies that you statically link with here ...	
 			}
 			);
@@ -53,5 +57,37 @@ public class MultiplayerSessions : ModuleRules
 				// ... add any modules that your module loads dynamically here ...
 			}
 			);
+
+		// Fingerprint advertised by created sessions, generated from the net protocol, content and engine versions,
+		// so players only find sessions of builds they can actually join. Bump NetProtocolVersion whenever replicated data changes
+		const int NetProtocolVersion = 1;
+		string ContentVersion = null;
+		if (Target.ProjectFile != null)
+		{
+			ConfigHierarchy GameIni = ConfigCache.ReadHierarchy(ConfigHierarchyType.Game, Target.ProjectFile.Directory, Target.Platform);
+			GameIni.GetString("/Script/EngineSettings.GeneralProjectSettings", "ProjectVersion", out ContentVersion);
+		}
+
+		string FingerprintSource = String.Format(
+			"{0}|{1}|{2}.{3}.{4}|{5}",
+			NetProtocolVersion,
+			ContentVersion ?? "",
+			Target.Version.MajorVersion,
+			Target.Version.MinorVersion,
+			Target.Version.PatchVersion,
+			Target.Version.EffectiveCompatibleChangelist
+			);
+
+		// FNV-1a, as string hash codes aren't stable across runs
+		uint FingerprintHash = 2166136261;
+		foreach (char Character in FingerprintSource)
+		{
+			FingerprintHash = (FingerprintHash ^ Character) * 16777619;
+		}
+
+		// Protocol version lives in the high bits, so compatibility ranges can be checked from the fingerprint alone
+		int BuildFingerprint = ((NetProtocolVersion & 0x7FFF) << 16) | (int)(FingerprintHash & 0xFFFF);
+		PublicDefinitions.Add("MULTIPLAYERSESSIONS_NET_PROTOCOL_VERSION=" + NetProtocolVersion);
+		PublicDefinitions.Add("MULTIPLAYERSESSIONS_BUILD_FINGERPRINT=" + BuildFingerprint);
 	}
 }
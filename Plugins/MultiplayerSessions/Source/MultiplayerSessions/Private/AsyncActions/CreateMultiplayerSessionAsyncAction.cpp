@@ -0,0 +1,49 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "AsyncActions/CreateMultiplayerSessionAsyncAction.h"
+
+// MultiplayerSessions
+#include "Subsystems/MultiplayerSessionsSubsystem.h"
+
+#pragma region ASYNC_ACTION
+
+/** Create multiplayer session */
+UCreateMultiplayerSessionAsyncAction* UCreateMultiplayerSessionAsyncAction::CreateMultiplayerSession(UObject* InWorldContextObject, int32 NumPublicConnections, const FString& MatchType)
+{
+	UCreateMultiplayerSessionAsyncAction* Action = NewObject<UCreateMultiplayerSessionAsyncAction>();
+	Action->WorldContextObject = InWorldContextObject;
+	Action->NumPublicConnections = NumPublicConnections;
+	Action->MatchType = MatchType;
+	Action->RegisterWithGameInstance(InWorldContextObject);
+	return Action;
+}
+
+/** Start request */
+void UCreateMultiplayerSessionAsyncAction::Activate()
+{
+	UMultiplayerSessionsSubsystem* MultiplayerSessionsSubsystem = GetMultiplayerSessionsSubsystem();
+	if (!MultiplayerSessionsSubsystem)
+	{
+		OnFailure.Broadcast();
+		SetReadyToDestroy();
+		return;
+	}
+
+	MultiplayerSessionsSubsystem->CreateSessionAsync(NumPublicConnections, MatchType).Next([WeakThis = TWeakObjectPtr<UCreateMultiplayerSessionAsyncAction>(this)](bool bWasSuccessful)
+	{
+		if (UCreateMultiplayerSessionAsyncAction* This = WeakThis.Get())
+		{
+			if (bWasSuccessful)
+			{
+				This->OnSuccess.Broadcast();
+			}
+			else
+			{
+				This->OnFailure.Broadcast();
+			}
+			This->SetReadyToDestroy();
+		}
+	});
+}
+
+#pragma endregion ASYNC_ACTION
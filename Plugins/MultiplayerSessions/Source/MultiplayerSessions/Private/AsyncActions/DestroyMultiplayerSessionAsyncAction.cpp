@@ -0,0 +1,47 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "AsyncActions/DestroyMultiplayerSessionAsyncAction.h"
+
+// MultiplayerSessions
+#include "Subsystems/MultiplayerSessionsSubsystem.h"
+
+#pragma region ASYNC_ACTION
+
+/** Destroy multiplayer session */
+UDestroyMultiplayerSessionAsyncAction* UDestroyMultiplayerSessionAsyncAction::DestroyMultiplayerSession(UObject* InWorldContextObject)
+{
+	UDestroyMultiplayerSessionAsyncAction* Action = NewObject<UDestroyMultiplayerSessionAsyncAction>();
+	Action->WorldContextObject = InWorldContextObject;
+	Action->RegisterWithGameInstance(InWorldContextObject);
+	return Action;
+}
+
+/** Start request */
+void UDestroyMultiplayerSessionAsyncAction::Activate()
+{
+	UMultiplayerSessionsSubsystem* MultiplayerSessionsSubsystem = GetMultiplayerSessionsSubsystem();
+	if (!MultiplayerSessionsSubsystem)
+	{
+		OnFailure.Broadcast();
+		SetReadyToDestroy();
+		return;
+	}
+
+	MultiplayerSessionsSubsystem->DestroySessionAsync().Next([WeakThis = TWeakObjectPtr<UDestroyMultiplayerSessionAsyncAction>(this)](bool bWasSuccessful)
+	{
+		if (UDestroyMultiplayerSessionAsyncAction* This = WeakThis.Get())
+		{
+			if (bWasSuccessful)
+			{
+				This->OnSuccess.Broadcast();
+			}
+			else
+			{
+				This->OnFailure.Broadcast();
+			}
+			This->SetReadyToDestroy();
+		}
+	});
+}
+
+#pragma endregion ASYNC_ACTION
@@ -0,0 +1,59 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "AsyncActions/FindMultiplayerSessionsAsyncAction.h"
+
+// MultiplayerSessions
+#include "Subsystems/MultiplayerSessionsSubsystem.h"
+
+#pragma region ASYNC_ACTION
+
+/** Find multiplayer sessions of the given match type (any match type if empty) */
+UFindMultiplayerSessionsAsyncAction* UFindMultiplayerSessionsAsyncAction::FindMultiplayerSessions(UObject* InWorldContextObject, int32 MaxSearchResults, const FString& MatchType)
+{
+	UFindMultiplayerSessionsAsyncAction* Action = NewObject<UFindMultiplayerSessionsAsyncAction>();
+	Action->WorldContextObject = InWorldContextObject;
+	Action->MaxSearchResults = MaxSearchResults;
+	Action->MatchType = MatchType;
+	Action->RegisterWithGameInstance(InWorldContextObject);
+	return Action;
+}
+
+/** Start request */
+void UFindMultiplayerSessionsAsyncAction::Activate()
+{
+	UMultiplayerSessionsSubsystem* MultiplayerSessionsSubsystem = GetMultiplayerSessionsSubsystem();
+	if (!MultiplayerSessionsSubsystem)
+	{
+		OnFailure.Broadcast(TArray<FMultiplayerSessionSearchResult>());
+		SetReadyToDestroy();
+		return;
+	}
+
+	MultiplayerSessionsSubsystem->FindSessionsAsync(MaxSearchResults, MatchType).Next([WeakThis = TWeakObjectPtr<UFindMultiplayerSessionsAsyncAction>(this)](const FMultiplayerFindSessionsResult& Result)
+	{
+		UFindMultiplayerSessionsAsyncAction* This = WeakThis.Get();
+		if (!This)
+		{
+			return;
+		}
+
+		TArray<FMultiplayerSessionSearchResult> SessionResults;
+		SessionResults.Reserve(Result.SessionResults.Num());
+		for (const FOnlineSessionSearchResult& SessionResult : Result.SessionResults)
+		{
+			SessionResults.Emplace(SessionResult);
+		}
+
+		if (Result.bWasSuccessful)
+		{
+			This->OnSuccess.Broadcast(SessionResults);
+		}
+		else
+		{
+			This->OnFailure.Broadcast(SessionResults);
+		}
+		This->SetReadyToDestroy();
+	});
+}
+
+#pragma endregion ASYNC_ACTION
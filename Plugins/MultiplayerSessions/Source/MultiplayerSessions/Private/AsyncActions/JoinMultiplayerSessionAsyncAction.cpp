@@ -0,0 +1,53 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "AsyncActions/JoinMultiplayerSessionAsyncAction.h"
+
+// MultiplayerSessions
+#include "Subsystems/MultiplayerSessionsSubsystem.h"
+
+#pragma region ASYNC_ACTION
+
+/** Join multiplayer session, providing the address to travel to */
+UJoinMultiplayerSessionAsyncAction* UJoinMultiplayerSessionAsyncAction::JoinMultiplayerSession(UObject* InWorldContextObject, const FMultiplayerSessionSearchResult& SessionResult)
+{
+	UJoinMultiplayerSessionAsyncAction* Action = NewObject<UJoinMultiplayerSessionAsyncAction>();
+	Action->WorldContextObject = InWorldContextObject;
+	Action->SessionResult = SessionResult;
+	Action->RegisterWithGameInstance(InWorldContextObject);
+	return Action;
+}
+
+/** Start request */
+void UJoinMultiplayerSessionAsyncAction::Activate()
+{
+	UMultiplayerSessionsSubsystem* MultiplayerSessionsSubsystem = GetMultiplayerSessionsSubsystem();
+	if (!MultiplayerSessionsSubsystem)
+	{
+		OnFailure.Broadcast(FString());
+		SetReadyToDestroy();
+		return;
+	}
+
+	MultiplayerSessionsSubsystem->JoinSessionAsync(SessionResult.OnlineResult).Next([WeakThis = TWeakObjectPtr<UJoinMultiplayerSessionAsyncAction>(this)](EOnJoinSessionCompleteResult::Type Result)
+	{
+		UJoinMultiplayerSessionAsyncAction* This = WeakThis.Get();
+		if (!This)
+		{
+			return;
+		}
+
+		FString Address;
+		UMultiplayerSessionsSubsystem* Subsystem = This->GetMultiplayerSessionsSubsystem();
+		if (Result == EOnJoinSessionCompleteResult::Success && Subsystem && Subsystem->GetResolvedConnectString(Address))
+		{
+			This->OnSuccess.Broadcast(Address);
+		}
+		else
+		{
+			This->OnFailure.Broadcast(Address);
+		}
+		This->SetReadyToDestroy();
+	});
+}
+
+#pragma endregion ASYNC_ACTION
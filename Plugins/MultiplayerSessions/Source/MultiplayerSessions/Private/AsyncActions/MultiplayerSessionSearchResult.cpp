@@ -0,0 +1,13 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "AsyncActions/MultiplayerSessionSearchResult.h"
+
+/** Constructor from an online session search result */
+FMultiplayerSessionSearchResult::FMultiplayerSessionSearchResult(const FOnlineSessionSearchResult& InOnlineResult)
+	: NumOpenPublicConnections(InOnlineResult.Session.NumOpenPublicConnections)
+	, NumPublicConnections(InOnlineResult.Session.SessionSettings.NumPublicConnections)
+	, PingInMs(InOnlineResult.PingInMs)
+	, OnlineResult(InOnlineResult)
+{
+	InOnlineResult.Session.SessionSettings.Get(FName("MatchType"), MatchType);
+}
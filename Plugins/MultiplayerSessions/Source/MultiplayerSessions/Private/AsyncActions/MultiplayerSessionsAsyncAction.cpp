@@ -0,0 +1,23 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "AsyncActions/MultiplayerSessionsAsyncAction.h"
+
+// Unreal Engine
+#include "Engine/Engine.h"
+#include "Engine/GameInstance.h"
+#include "Engine/World.h"
+
+// MultiplayerSessions
+#include "Subsystems/MultiplayerSessionsSubsystem.h"
+
+#pragma region ASYNC_ACTION
+
+/** Get multiplayer sessions subsystem from the world context the node was created with */
+UMultiplayerSessionsSubsystem* UMultiplayerSessionsAsyncAction::GetMultiplayerSessionsSubsystem() const
+{
+	const UWorld* World = GEngine ? GEngine->GetWorldFromContextObject(WorldContextObject.Get(), EGetWorldErrorMode::LogAndReturnNull) : nullptr;
+	const UGameInstance* GameInstance = World ? World->GetGameInstance() : nullptr;
+	return GameInstance ? GameInstance->GetSubsystem<UMultiplayerSessionsSubsystem>() : nullptr;
+}
+
+#pragma endregion ASYNC_ACTION
@@ -0,0 +1,47 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "AsyncActions/StartMultiplayerSessionAsyncAction.h"
+
+// MultiplayerSessions
+#include "Subsystems/MultiplayerSessionsSubsystem.h"
+
+#pragma region ASYNC_ACTION
+
+/** Start multiplayer session */
+UStartMultiplayerSessionAsyncAction* UStartMultiplayerSessionAsyncAction::StartMultiplayerSession(UObject* InWorldContextObject)
+{
+	UStartMultiplayerSessionAsyncAction* Action = NewObject<UStartMultiplayerSessionAsyncAction>();
+	Action->WorldContextObject = InWorldContextObject;
+	Action->RegisterWithGameInstance(InWorldContextObject);
+	return Action;
+}
+
+/** Start request */
+void UStartMultiplayerSessionAsyncAction::Activate()
+{
+	UMultiplayerSessionsSubsystem* MultiplayerSessionsSubsystem = GetMultiplayerSessionsSubsystem();
+	if (!MultiplayerSessionsSubsystem)
+	{
+		OnFailure.Broadcast();
+		SetReadyToDestroy();
+		return;
+	}
+
+	MultiplayerSessionsSubsystem->StartSessionAsync().Next([WeakThis = TWeakObjectPtr<UStartMultiplayerSessionAsyncAction>(this)](bool bWasSuccessful)
+	{
+		if (UStartMultiplayerSessionAsyncAction* This = WeakThis.Get())
+		{
+			if (bWasSuccessful)
+			{
+				This->OnSuccess.Broadcast();
+			}
+			else
+			{
+				This->OnFailure.Broadcast();
+			}
+			This->SetReadyToDestroy();
+		}
+	});
+}
+
+#pragma endregion ASYNC_ACTION
@@ -0,0 +1,83 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Beacons/MultiplayerSessionsBeaconClient.h"
+
+// Unreal Engine
+#include "Engine/World.h"
+#include "Engine/NetConnection.h"
+
+// MultiplayerSessions
+#include "Beacons/MultiplayerSessionsBeaconHostObject.h"
+
+#pragma region OVERRIDES
+
+/** Called when the connection to the beacon host is established */
+void AMultiplayerSessionsBeaconClient::OnConnected()
+{
+	Super::OnConnected();
+	ServerRequestReservation(BuildUniqueId, MatchType);
+}
+
+/** Called when the connection to the beacon host fails */
+void AMultiplayerSessionsBeaconClient::OnFailure()
+{
+	CompleteReservation(EMultiplayerReservationResult::ConnectionFailed);
+	Super::OnFailure();
+}
+
+#pragma endregion OVERRIDES
+
+#pragma region RESERVATION
+
+/** Connect to the beacon host at the given address and request a slot */
+bool AMultiplayerSessionsBeaconClient::RequestReservation(const FString& ConnectInfo, const FString& InPlayerId, int32 InBuildUniqueId, const FString& InMatchType)
+{
+	PlayerId = InPlayerId;
+	BuildUniqueId = InBuildUniqueId;
+	MatchType = InMatchType;
+	bReservationComplete = false;
+
+	FURL BeaconURL(nullptr, *ConnectInfo, TRAVEL_Absolute);
+	return InitClient(BeaconURL);
+}
+
+/** Request slot to the beacon host, for the player the beacon connection was validated for */
+void AMultiplayerSessionsBeaconClient::ServerRequestReservation_Implementation(int32 InBuildUniqueId, const FString& InMatchType)
+{
+	// Reservations are keyed by the id the connection logged in with, never by one the client claims
+	const UNetConnection* Connection = GetNetConnection();
+	const FUniqueNetIdRepl ConnectionPlayerId = Connection ? Connection->PlayerId : FUniqueNetIdRepl();
+
+	EMultiplayerReservationResult Result = EMultiplayerReservationResult::ConnectionFailed;
+	if (!ConnectionPlayerId.IsValid())
+	{
+		Result = EMultiplayerReservationResult::InvalidPlayerId;
+	}
+	else if (AMultiplayerSessionsBeaconHostObject* HostObject = Cast<AMultiplayerSessionsBeaconHostObject>(GetBeaconOwner()))
+	{
+		PlayerId = ConnectionPlayerId.ToString();
+		Result = HostObject->ProcessReservationRequest(PlayerId, InBuildUniqueId, InMatchType);
+	}
+
+	ClientReservationResponse(Result);
+}
+
+/** Receive beacon host's response to the slot request */
+void AMultiplayerSessionsBeaconClient::ClientReservationResponse_Implementation(EMultiplayerReservationResult Result)
+{
+	CompleteReservation(Result);
+}
+
+/** Notify result and close the connection */
+void AMultiplayerSessionsBeaconClient::CompleteReservation(EMultiplayerReservationResult Result)
+{
+	if (bReservationComplete)
+	{
+		return;
+	}
+
+	bReservationComplete = true;
+	OnReservationCompleteDelegate.ExecuteIfBound(Result);
+}
+
+#pragma endregion RESERVATION
@@ -0,0 +1,114 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Beacons/MultiplayerSessionsBeaconHostObject.h"
+
+// Unreal Engine
+#include "Engine/World.h"
+#include "GameFramework/GameStateBase.h"
+#include "GameFramework/PlayerState.h"
+
+// MultiplayerSessions
+#include "Subsystems/MultiplayerSessionsBuildFingerprint.h"
+
+#pragma region INITIALIZATION
+
+/** Constructor */
+AMultiplayerSessionsBeaconHostObject::AMultiplayerSessionsBeaconHostObject()
+{
+	ClientBeaconActorClass = AMultiplayerSessionsBeaconClient::StaticClass();
+	BeaconTypeName = ClientBeaconActorClass->GetName();
+}
+
+/** Setup session's requirements for accepting reservations */
+void AMultiplayerSessionsBeaconHostObject::SetupReservations(int32 InNumPublicConnections, int32 InBuildUniqueId, int32 InBuildCompatibilityRange, const FString& InMatchType)
+{
+	NumPublicConnections = InNumPublicConnections;
+	BuildUniqueId = InBuildUniqueId;
+	BuildCompatibilityRange = InBuildCompatibilityRange;
+	MatchType = InMatchType;
+	Reservations.Reset();
+}
+
+#pragma endregion INITIALIZATION
+
+#pragma region RESERVATION
+
+/** Check request against session's requirements and reserve a slot if there's room */
+EMultiplayerReservationResult AMultiplayerSessionsBeaconHostObject::ProcessReservationRequest(const FString& PlayerId, int32 InBuildUniqueId, const FString& InMatchType)
+{
+	if (PlayerId.IsEmpty())
+	{
+		return EMultiplayerReservationResult::InvalidPlayerId;
+	}
+
+	if (!MultiplayerSessionsBuildFingerprint::AreCompatible(BuildUniqueId, InBuildUniqueId, BuildCompatibilityRange))
+	{
+		return EMultiplayerReservationResult::IncompatibleBuild;
+	}
+
+	if (!InMatchType.IsEmpty() && !InMatchType.Equals(MatchType))
+	{
+		return EMultiplayerReservationResult::IncompatibleMatchType;
+	}
+
+	// Player retrying keeps its slot
+	if (double* ReservationTime = Reservations.Find(PlayerId))
+	{
+		*ReservationTime = FPlatformTime::Seconds();
+		return EMultiplayerReservationResult::Success;
+	}
+
+	if (GetNumUsedSlots() >= NumPublicConnections)
+	{
+		return EMultiplayerReservationResult::SessionFull;
+	}
+
+	Reservations.Add(PlayerId, FPlatformTime::Seconds());
+	return EMultiplayerReservationResult::Success;
+}
+
+/** Number of slots taken, including connected players and pending reservations. Spectators watch from private slots, so they aren't counted */
+int32 AMultiplayerSessionsBeaconHostObject::GetNumUsedSlots()
+{
+	PruneReservations();
+
+	int32 NumPlayers = 0;
+	if (const AGameStateBase* GameState = GetWorld() ? GetWorld()->GetGameState() : nullptr)
+	{
+		for (const APlayerState* PlayerState : GameState->PlayerArray)
+		{
+			if (PlayerState && !PlayerState->IsOnlyASpectator())
+			{
+				++NumPlayers;
+			}
+		}
+	}
+	return NumPlayers + Reservations.Num();
+}
+
+/** Remove reservations that timed out or whose player already logged in */
+void AMultiplayerSessionsBeaconHostObject::PruneReservations()
+{
+	const double ExpirationTime = FPlatformTime::Seconds() - ReservationTimeout;
+	for (auto It = Reservations.CreateIterator(); It; ++It)
+	{
+		if (It.Value() < ExpirationTime)
+		{
+			It.RemoveCurrent();
+		}
+	}
+
+	// Logged in players are already counted by the game state
+	if (const AGameStateBase* GameState = GetWorld() ? GetWorld()->GetGameState() : nullptr)
+	{
+		for (const APlayerState* PlayerState : GameState->PlayerArray)
+		{
+			if (PlayerState && PlayerState->GetUniqueId().IsValid())
+			{
+				Reservations.Remove(PlayerState->GetUniqueId()->ToString());
+			}
+		}
+	}
+}
+
+#pragma endregion RESERVATION
@@ -0,0 +1,54 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Commandlets/LobbyFleetCommandlet.h"
+
+// MultiplayerSessions
+#include "Fleet/LobbyFleetManager.h"
+#include "Fleet/LobbyFleetProtocol.h"
+
+#pragma region OVERRIDES
+
+/** Constructor */
+ULobbyFleetCommandlet::ULobbyFleetCommandlet()
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = false;
+	LogToConsole = true;
+}
+
+/** Run commandlet */
+int32 ULobbyFleetCommandlet::Main(const FString& Params)
+{
+	int32 Port = LobbyFleetProtocol::DefaultPort;
+	FParse::Value(*Params, TEXT("Port="), Port);
+
+	FLobbyFleetManager Manager;
+	FParse::Value(*Params, TEXT("MaxServers="), Manager.MaxServers);
+	FParse::Value(*Params, TEXT("MinIdleServers="), Manager.MinIdleServers);
+	FParse::Value(*Params, TEXT("FirstGamePort="), Manager.FirstGamePort);
+	FParse::Value(*Params, TEXT("FirstBeaconPort="), Manager.FirstBeaconPort);
+	FParse::Value(*Params, TEXT("PublicHost="), Manager.PublicHost);
+	FParse::Value(*Params, TEXT("ServerExecutable="), Manager.ServerExecutable);
+	FParse::Value(*Params, TEXT("ServerMap="), Manager.ServerMap);
+	FParse::Value(*Params, TEXT("ServerArguments="), Manager.ServerArguments, false);
+	FParse::Value(*Params, TEXT("MaxTotalMemoryMB="), Manager.MaxTotalMemoryMB);
+	FParse::Value(*Params, TEXT("RecycleMemoryMB="), Manager.RecycleMemoryMB);
+	FParse::Value(*Params, TEXT("RecycleEmptyTime="), Manager.RecycleEmptyTime);
+
+	if (!Manager.Start(Port))
+	{
+		return 1;
+	}
+
+	// Run the fleet until the process is asked to exit
+	while (!IsEngineExitRequested())
+	{
+		Manager.Tick(0.1f);
+	}
+
+	Manager.Stop();
+	return 0;
+}
+
+#pragma endregion OVERRIDES
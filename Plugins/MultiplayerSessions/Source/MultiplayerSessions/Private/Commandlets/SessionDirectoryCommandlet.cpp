@@ -0,0 +1,44 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Commandlets/SessionDirectoryCommandlet.h"
+
+// MultiplayerSessions
+#include "SessionDirectory/SessionDirectoryServer.h"
+#include "SessionDirectory/SessionDirectoryProtocol.h"
+
+#pragma region OVERRIDES
+
+/** Constructor */
+USessionDirectoryCommandlet::USessionDirectoryCommandlet()
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = false;
+	LogToConsole = true;
+}
+
+/** Run commandlet */
+int32 USessionDirectoryCommandlet::Main(const FString& Params)
+{
+	int32 Port = SessionDirectoryProtocol::DefaultPort;
+	FParse::Value(*Params, TEXT("Port="), Port);
+
+	FSessionDirectoryServer Server;
+	FParse::Value(*Params, TEXT("HeartbeatTimeout="), Server.HeartbeatTimeout);
+
+	if (!Server.Start(Port))
+	{
+		return 1;
+	}
+
+	// Serve requests until the process is asked to exit
+	while (!IsEngineExitRequested())
+	{
+		Server.Tick(0.1f);
+	}
+
+	Server.Stop();
+	return 0;
+}
+
+#pragma endregion OVERRIDES
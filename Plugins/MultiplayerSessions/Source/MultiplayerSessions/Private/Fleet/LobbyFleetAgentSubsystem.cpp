@@ -0,0 +1,210 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Fleet/LobbyFleetAgentSubsystem.h"
+
+// Unreal Engine
+#include "Common/UdpSocketBuilder.h"
+#include "SocketSubsystem.h"
+#include "Engine/GameInstance.h"
+#include "Engine/NetDriver.h"
+#include "Engine/World.h"
+#include "HAL/PlatformMemory.h"
+#include "Misc/CommandLine.h"
+#include "Misc/Parse.h"
+
+// MultiplayerSessions
+#include "MultiplayerSessions.h"
+#include "Fleet/LobbyFleetProtocol.h"
+#include "Subsystems/MultiplayerSessionsSubsystem.h"
+
+#pragma region INITIALIZATION
+
+/** Only create the subsystem on servers started by the lobby fleet */
+bool ULobbyFleetAgentSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+	FString ManagerAddress;
+	return IsRunningDedicatedServer() && FParse::Value(FCommandLine::Get(), TEXT("FleetManager="), ManagerAddress) && Super::ShouldCreateSubsystem(Outer);
+}
+
+/** Initialize subsystem */
+void ULobbyFleetAgentSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	// Assigned lobbies are created through the sessions subsystem
+	Collection.InitializeDependency(UMultiplayerSessionsSubsystem::StaticClass());
+
+	FString ManagerAddress;
+	FParse::Value(FCommandLine::Get(), TEXT("FleetManager="), ManagerAddress);
+	FParse::Value(FCommandLine::Get(), TEXT("FleetServerId="), ServerId);
+
+	// Manager starts its servers on the same machine, so its address is always numeric
+	FString Host = ManagerAddress;
+	int32 Port = LobbyFleetProtocol::DefaultPort;
+	FString PortString;
+	if (ManagerAddress.Split(TEXT(":"), &Host, &PortString, ESearchCase::CaseSensitive, ESearchDir::FromEnd))
+	{
+		LexFromString(Port, *PortString);
+	}
+
+	ManagerAddr = ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM)->GetAddressFromString(Host);
+	if (!ManagerAddr.IsValid())
+	{
+		UE_LOG(LogMultiplayerSessions, Error, TEXT("Invalid lobby fleet manager address %s"), *ManagerAddress);
+		return;
+	}
+	ManagerAddr->SetPort(Port);
+
+	Socket = FUdpSocketBuilder(TEXT("LobbyFleetAgent"))
+		.AsNonBlocking()
+		.BoundToAddress(FIPv4Address::Any)
+		.BoundToPort(0)
+		.Build();
+
+	if (!Socket)
+	{
+		UE_LOG(LogMultiplayerSessions, Error, TEXT("Lobby fleet agent couldn't create its socket"));
+		return;
+	}
+
+	FleetAgentTickerHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateUObject(this, &ULobbyFleetAgentSubsystem::TickFleetAgent));
+}
+
+/** Deinitialize subsystem */
+void ULobbyFleetAgentSubsystem::Deinitialize()
+{
+	FTSTicker::GetCoreTicker().RemoveTicker(FleetAgentTickerHandle);
+	FleetAgentTickerHandle.Reset();
+
+	if (Socket)
+	{
+		Socket->Close();
+		ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM)->DestroySocket(Socket);
+		Socket = nullptr;
+	}
+
+	if (UMultiplayerSessionsSubsystem* MultiplayerSessionsSubsystem = GetGameInstance()->GetSubsystem<UMultiplayerSessionsSubsystem>())
+	{
+		MultiplayerSessionsSubsystem->MultiplayerOnCreateSessionCompleteDelegate.RemoveDynamic(this, &ULobbyFleetAgentSubsystem::OnCreateSessionComplete);
+	}
+
+	Super::Deinitialize();
+}
+
+#pragma endregion INITIALIZATION
+
+#pragma region FLEET
+
+/** Ticker callback accumulating frame times, reporting load and receiving host requests */
+bool ULobbyFleetAgentSubsystem::TickFleetAgent(float DeltaTime)
+{
+	++NumReportFrames;
+	ReportFrameTime += DeltaTime;
+
+	const TSharedRef<FInternetAddr> Sender = ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM)->CreateInternetAddr();
+	FString Message;
+	while (SessionDirectoryProtocol::ReceiveMessage(Socket, ReceiveBuffer, Message, *Sender))
+	{
+		const TArray<FString> Fields = SessionDirectoryProtocol::SplitLine(Message);
+		if (!Fields.IsEmpty() && Fields[0] == LobbyFleetProtocol::Host && *Sender == *ManagerAddr)
+		{
+			HandleHostRequest(Fields);
+		}
+	}
+
+	if (ReportFrameTime >= ReportInterval)
+	{
+		SendReport();
+		NumReportFrames = 0;
+		ReportFrameTime = 0.f;
+	}
+
+	return true;
+}
+
+/** Report server's state and load to the manager */
+void ULobbyFleetAgentSubsystem::SendReport()
+{
+	// Servers only report once their map is loaded, so the manager doesn't hand them lobbies too early
+	const UWorld* World = GetGameInstance()->GetWorld();
+	const UNetDriver* NetDriver = World ? World->GetNetDriver() : nullptr;
+	if (!NetDriver)
+	{
+		return;
+	}
+
+	const int32 NumPlayers = NetDriver->ClientConnections.Num();
+	const float AverageFrameTime = NumReportFrames > 0 ? 1000.f * ReportFrameTime / NumReportFrames : 0.f;
+	const int32 MemoryMB = static_cast<int32>(FPlatformMemory::GetStats().UsedPhysical / (1024 * 1024));
+
+	const FString Report = SessionDirectoryProtocol::MakeLine({
+		LobbyFleetProtocol::Report,
+		LexToString(ServerId),
+		bIsHosting ? LobbyFleetProtocol::StateHosting : LobbyFleetProtocol::StateIdle,
+		LexToString(NumPlayers),
+		FString::SanitizeFloat(AverageFrameTime),
+		LexToString(MemoryMB)
+	});
+	SessionDirectoryProtocol::SendMessage(Socket, Report, *ManagerAddr);
+}
+
+/** Create the lobby requested by the manager */
+void ULobbyFleetAgentSubsystem::HandleHostRequest(const TArray<FString>& Fields)
+{
+	// Fields: request id, match type, number of public connections
+	UMultiplayerSessionsSubsystem* MultiplayerSessionsSubsystem = GetGameInstance()->GetSubsystem<UMultiplayerSessionsSubsystem>();
+	if (Fields.Num() < 4 || !MultiplayerSessionsSubsystem)
+	{
+		return;
+	}
+
+	// Manager resends the request until it's accepted, so the lost acceptances are sent again
+	if (bIsHosting)
+	{
+		if (bIsLobbyCreated && Fields[1] == HostRequestId)
+		{
+			SendAccepted();
+		}
+		return;
+	}
+
+	int32 NumPublicConnections = 0;
+	LexFromString(NumPublicConnections, *Fields[3]);
+
+	bIsHosting = true;
+	bIsLobbyCreated = false;
+	HostRequestId = Fields[1];
+	UE_LOG(LogMultiplayerSessions, Log, TEXT("Lobby fleet server %d hosting %s lobby for %d players"), ServerId, *Fields[2], NumPublicConnections);
+
+	MultiplayerSessionsSubsystem->MultiplayerOnCreateSessionCompleteDelegate.AddUniqueDynamic(this, &ULobbyFleetAgentSubsystem::OnCreateSessionComplete);
+	MultiplayerSessionsSubsystem->CreateSession(NumPublicConnections, Fields[2]);
+}
+
+/** Callback called when the requested lobby's session is created */
+void ULobbyFleetAgentSubsystem::OnCreateSessionComplete(bool bWasSuccessful)
+{
+	if (UMultiplayerSessionsSubsystem* MultiplayerSessionsSubsystem = GetGameInstance()->GetSubsystem<UMultiplayerSessionsSubsystem>())
+	{
+		MultiplayerSessionsSubsystem->MultiplayerOnCreateSessionCompleteDelegate.RemoveDynamic(this, &ULobbyFleetAgentSubsystem::OnCreateSessionComplete);
+	}
+
+	// Failed lobbies go back to idle without accepting, so the manager hands the request and the server out again
+	if (!bWasSuccessful)
+	{
+		UE_LOG(LogMultiplayerSessions, Warning, TEXT("Lobby fleet server %d couldn't create its session"), ServerId);
+		bIsHosting = false;
+		HostRequestId.Reset();
+		return;
+	}
+
+	bIsLobbyCreated = true;
+	SendAccepted();
+}
+
+/** Tell the manager the requested lobby is up, so it hands this server's address to the requester */
+void ULobbyFleetAgentSubsystem::SendAccepted()
+{
+	SessionDirectoryProtocol::SendMessage(Socket, SessionDirectoryProtocol::MakeLine({ LobbyFleetProtocol::Accepted, LexToString(ServerId), HostRequestId }), *ManagerAddr);
+}
+
+#pragma endregion FLEET
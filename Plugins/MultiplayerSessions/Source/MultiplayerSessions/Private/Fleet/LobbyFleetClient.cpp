@@ -0,0 +1,180 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Fleet/LobbyFleetClient.h"
+
+// Unreal Engine
+#include "Common/UdpSocketBuilder.h"
+#include "SocketSubsystem.h"
+
+// MultiplayerSessions
+#include "MultiplayerSessions.h"
+#include "Fleet/LobbyFleetProtocol.h"
+
+#pragma region INITIALIZATION
+
+/** Destructor */
+FLobbyFleetClient::~FLobbyFleetClient()
+{
+	Disconnect();
+}
+
+/** Open socket used for talking to the manager at the given address (host[:port]) */
+bool FLobbyFleetClient::Connect(const FString& ManagerAddress)
+{
+	Disconnect();
+
+	ISocketSubsystem* SocketSubsystem = ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM);
+	if (!SocketSubsystem)
+	{
+		return false;
+	}
+
+	// Split host and port
+	FString Host = ManagerAddress;
+	int32 Port = LobbyFleetProtocol::DefaultPort;
+	FString PortString;
+	if (ManagerAddress.Split(TEXT(":"), &Host, &PortString, ESearchCase::CaseSensitive, ESearchDir::FromEnd))
+	{
+		LexFromString(Port, *PortString);
+	}
+
+	// Resolve manager's address
+	ManagerAddr = SocketSubsystem->GetAddressFromString(Host);
+	if (!ManagerAddr.IsValid())
+	{
+		const FAddressInfoResult AddressInfo = SocketSubsystem->GetAddressInfo(*Host, nullptr, EAddressInfoFlags::Default, NAME_None, ESocketType::SOCKTYPE_Datagram);
+		if (AddressInfo.Results.IsEmpty())
+		{
+			UE_LOG(LogMultiplayerSessions, Warning, TEXT("Couldn't resolve lobby fleet manager address %s"), *ManagerAddress);
+			return false;
+		}
+		ManagerAddr = AddressInfo.Results[0].Address;
+	}
+	ManagerAddr->SetPort(Port);
+
+	Socket = FUdpSocketBuilder(TEXT("LobbyFleetClient"))
+		.AsNonBlocking()
+		.BoundToAddress(FIPv4Address::Any)
+		.BoundToPort(0)
+		.Build();
+
+	return Socket != nullptr;
+}
+
+/** Close socket, failing any pending request */
+void FLobbyFleetClient::Disconnect()
+{
+	if (Socket)
+	{
+		Socket->Close();
+		ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM)->DestroySocket(Socket);
+		Socket = nullptr;
+	}
+
+	TMap<FString, FPendingRequest> FailedRequests = MoveTemp(PendingRequests);
+	for (TPair<FString, FPendingRequest>& Pair : FailedRequests)
+	{
+		Pair.Value.OnComplete.ExecuteIfBound(FString(), false);
+	}
+}
+
+#pragma endregion INITIALIZATION
+
+#pragma region FLEET
+
+/** Ask the manager for a server hosting a lobby of the given match type, completing with the address players travel to */
+void FLobbyFleetClient::RequestLobby(const FString& MatchType, int32 NumPublicConnections, const FOnLobbyFleetRequestComplete& OnComplete)
+{
+	if (!Socket)
+	{
+		OnComplete.ExecuteIfBound(FString(), false);
+		return;
+	}
+
+	// Manager tells retries apart from new requests by their id, which has to stay unique across restarts of the client
+	const FString RequestId = FGuid::NewGuid().ToString(EGuidFormats::Digits);
+
+	FPendingRequest& Request = PendingRequests.Add(RequestId);
+	Request.Message = SessionDirectoryProtocol::MakeLine({ LobbyFleetProtocol::Host, RequestId, MatchType, LexToString(NumPublicConnections) });
+	Request.OnComplete = OnComplete;
+	Request.StartTime = Request.LastSendTime = FPlatformTime::Seconds();
+
+	Send(Request.Message);
+}
+
+/** Process replies and retry or time out pending requests */
+void FLobbyFleetClient::Tick()
+{
+	if (!Socket)
+	{
+		return;
+	}
+
+	// Process replies
+	const TSharedRef<FInternetAddr> Sender = ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM)->CreateInternetAddr();
+	FString Message;
+	while (SessionDirectoryProtocol::ReceiveMessage(Socket, ReceiveBuffer, Message, *Sender))
+	{
+		// Fields: message type, request id, then the address for assigned requests
+		const TArray<FString> Fields = SessionDirectoryProtocol::SplitLine(Message);
+		if (Fields.Num() < 2)
+		{
+			continue;
+		}
+
+		const bool bIsAssigned = Fields[0] == LobbyFleetProtocol::Assigned && Fields.Num() >= 3;
+		if (!bIsAssigned && Fields[0] != LobbyFleetProtocol::Busy)
+		{
+			continue;
+		}
+
+		// Replies to retried or timed out requests are ignored
+		FPendingRequest Request;
+		if (!PendingRequests.RemoveAndCopyValue(Fields[1], Request))
+		{
+			continue;
+		}
+
+		if (!bIsAssigned)
+		{
+			UE_LOG(LogMultiplayerSessions, Warning, TEXT("Lobby fleet has no server free for hosting the lobby"));
+		}
+		Request.OnComplete.ExecuteIfBound(bIsAssigned ? Fields[2] : FString(), bIsAssigned);
+	}
+
+	// Retry or time out pending requests
+	const double CurrentTime = FPlatformTime::Seconds();
+	TArray<FString> TimedOutRequestIds;
+	for (TPair<FString, FPendingRequest>& Pair : PendingRequests)
+	{
+		FPendingRequest& Request = Pair.Value;
+		if (CurrentTime - Request.StartTime > RequestTimeout)
+		{
+			TimedOutRequestIds.Add(Pair.Key);
+		}
+		else if (CurrentTime - Request.LastSendTime > RequestRetryInterval)
+		{
+			Request.LastSendTime = CurrentTime;
+			Send(Request.Message);
+		}
+	}
+
+	for (const FString& RequestId : TimedOutRequestIds)
+	{
+		FPendingRequest Request;
+		PendingRequests.RemoveAndCopyValue(RequestId, Request);
+		UE_LOG(LogMultiplayerSessions, Warning, TEXT("Lobby fleet manager didn't answer the lobby request"));
+		Request.OnComplete.ExecuteIfBound(FString(), false);
+	}
+}
+
+/** Send message to the manager */
+void FLobbyFleetClient::Send(const FString& Message) const
+{
+	if (Socket && ManagerAddr.IsValid())
+	{
+		SessionDirectoryProtocol::SendMessage(Socket, Message, *ManagerAddr);
+	}
+}
+
+#pragma endregion FLEET
@@ -0,0 +1,491 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Fleet/LobbyFleetManager.h"
+
+// Unreal Engine
+#include "Common/UdpSocketBuilder.h"
+#include "SocketSubsystem.h"
+#include "Misc/Paths.h"
+
+// MultiplayerSessions
+#include "MultiplayerSessions.h"
+#include "Fleet/LobbyFleetProtocol.h"
+
+#pragma region INITIALIZATION
+
+/** Destructor */
+FLobbyFleetManager::~FLobbyFleetManager()
+{
+	Stop();
+}
+
+/** Start listening for reports and host requests on the given port */
+bool FLobbyFleetManager::Start(int32 Port)
+{
+	Stop();
+
+	Socket = FUdpSocketBuilder(TEXT("LobbyFleetManager"))
+		.AsNonBlocking()
+		.AsReusable()
+		.BoundToAddress(FIPv4Address::Any)
+		.BoundToPort(Port)
+		.WithReceiveBufferSize(256 * 1024)
+		.Build();
+
+	if (!Socket)
+	{
+		UE_LOG(LogMultiplayerSessions, Error, TEXT("Lobby fleet manager couldn't bind port %d"), Port);
+		return false;
+	}
+
+	ManagerPort = Port;
+	UE_LOG(LogMultiplayerSessions, Log, TEXT("Lobby fleet manager listening on port %d, running up to %d servers"), Port, MaxServers);
+	return true;
+}
+
+/** Stop listening and shut down every server */
+void FLobbyFleetManager::Stop()
+{
+	for (FLobbyFleetServer& Server : Servers)
+	{
+		StopServer(Server, TEXT("fleet stopped"));
+	}
+	Servers.Reset();
+	PendingHostRequests.Reset();
+	RecentAssignments.Reset();
+
+	if (Socket)
+	{
+		Socket->Close();
+		ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM)->DestroySocket(Socket);
+		Socket = nullptr;
+	}
+}
+
+#pragma endregion INITIALIZATION
+
+#pragma region FLEET
+
+/** Wait up to WaitTime seconds for messages, process all pending ones and update the fleet */
+void FLobbyFleetManager::Tick(float WaitTime)
+{
+	if (Socket && Socket->Wait(ESocketWaitConditions::WaitForRead, FTimespan::FromSeconds(WaitTime)))
+	{
+		const TSharedRef<FInternetAddr> Sender = ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM)->CreateInternetAddr();
+		FString Message;
+		while (SessionDirectoryProtocol::ReceiveMessage(Socket, ReceiveBuffer, Message, *Sender))
+		{
+			HandleMessage(Message, *Sender);
+		}
+	}
+
+	RecycleServers();
+	AssignHostRequests();
+	PrewarmServers();
+}
+
+/** Handle a single message */
+void FLobbyFleetManager::HandleMessage(const FString& Message, const FInternetAddr& Sender)
+{
+	const TArray<FString> Fields = SessionDirectoryProtocol::SplitLine(Message);
+	if (Fields.IsEmpty())
+	{
+		return;
+	}
+
+	if (Fields[0] == LobbyFleetProtocol::Report)
+	{
+		HandleReport(Fields, Sender);
+	}
+	else if (Fields[0] == LobbyFleetProtocol::Host)
+	{
+		HandleHostRequest(Fields, Sender);
+	}
+	else if (Fields[0] == LobbyFleetProtocol::Accepted)
+	{
+		HandleAccepted(Fields);
+	}
+}
+
+/** Update server's load from its report */
+void FLobbyFleetManager::HandleReport(const TArray<FString>& Fields, const FInternetAddr& Sender)
+{
+	// Fields: server id, state, number of players, average frame time, memory
+	if (Fields.Num() < 6)
+	{
+		return;
+	}
+
+	int32 ServerId = 0;
+	LexFromString(ServerId, *Fields[1]);
+	FLobbyFleetServer* Server = Servers.FindByPredicate([ServerId](const FLobbyFleetServer& Candidate)
+	{
+		return Candidate.ServerId == ServerId;
+	});
+	if (!Server)
+	{
+		return;
+	}
+
+	const double Now = FPlatformTime::Seconds();
+	if (Server->State == ELobbyFleetServerState::Starting)
+	{
+		UE_LOG(LogMultiplayerSessions, Log, TEXT("Lobby server %d is ready on port %d after %.1fs"), ServerId, Server->GamePort, Now - Server->StartTime);
+		Server->State = ELobbyFleetServerState::Idle;
+		Server->LastOccupiedTime = Now;
+	}
+
+	Server->ReportAddress = Sender.Clone();
+	Server->LastReportTime = Now;
+	LexFromString(Server->NumPlayers, *Fields[3]);
+	LexFromString(Server->AverageFrameTime, *Fields[4]);
+	LexFromString(Server->MemoryMB, *Fields[5]);
+
+	// Servers being assigned only leave that state by accepting or timing out.
+	// Reports sent before an assignment arrived still say idle, so only trust them once the assignment had time to land
+	const bool bIsHosting = Fields[2] == LobbyFleetProtocol::StateHosting;
+	if (bIsHosting && Server->State != ELobbyFleetServerState::Assigning)
+	{
+		Server->State = ELobbyFleetServerState::Hosting;
+	}
+	else if (Server->State == ELobbyFleetServerState::Hosting && Now - Server->LastOccupiedTime > ReportTimeout)
+	{
+		Server->State = ELobbyFleetServerState::Idle;
+	}
+
+	if (Server->NumPlayers > 0)
+	{
+		Server->LastOccupiedTime = Now;
+	}
+}
+
+/** Queue host request, or answer it again if it was already assigned */
+void FLobbyFleetManager::HandleHostRequest(const TArray<FString>& Fields, const FInternetAddr& Sender)
+{
+	// Fields: request id, match type, number of public connections
+	if (Fields.Num() < 4 || Fields[1].IsEmpty())
+	{
+		return;
+	}
+
+	// Requests are retried over UDP, so a retry gets the reply the original did
+	const FString RequestKey = Sender.ToString(true) + TEXT("/") + Fields[1];
+	if (const TPair<FString, double>* Assignment = RecentAssignments.Find(RequestKey))
+	{
+		SessionDirectoryProtocol::SendMessage(Socket, Assignment->Key, Sender);
+		return;
+	}
+
+	const auto IsSameRequest = [&Sender, &Fields](const FLobbyFleetHostRequest& Request)
+	{
+		return Request.RequestId == Fields[1] && Request.RequesterAddress.IsValid() && *Request.RequesterAddress == Sender;
+	};
+	const bool bIsPending = PendingHostRequests.ContainsByPredicate(IsSameRequest) || Servers.ContainsByPredicate([&IsSameRequest](const FLobbyFleetServer& Server)
+	{
+		return Server.State == ELobbyFleetServerState::Assigning && IsSameRequest(Server.AssignedRequest);
+	});
+	if (bIsPending)
+	{
+		return;
+	}
+
+	FLobbyFleetHostRequest& Request = PendingHostRequests.AddDefaulted_GetRef();
+	Request.RequesterAddress = Sender.Clone();
+	Request.RequestId = Fields[1];
+	Request.MatchType = Fields[2];
+	LexFromString(Request.NumPublicConnections, *Fields[3]);
+	Request.RequestTime = FPlatformTime::Seconds();
+}
+
+/** Answer the requester once the server it was assigned accepted its lobby */
+void FLobbyFleetManager::HandleAccepted(const TArray<FString>& Fields)
+{
+	// Fields: server id, request id
+	if (Fields.Num() < 3)
+	{
+		return;
+	}
+
+	int32 ServerId = 0;
+	LexFromString(ServerId, *Fields[1]);
+	FLobbyFleetServer* Server = Servers.FindByPredicate([ServerId](const FLobbyFleetServer& Candidate)
+	{
+		return Candidate.ServerId == ServerId;
+	});
+
+	// Acceptances resent after the first one got through, or arriving after the assignment timed out, are ignored
+	if (!Server || Server->State != ELobbyFleetServerState::Assigning || Server->AssignedRequest.RequestId != Fields[2])
+	{
+		return;
+	}
+
+	const double Now = FPlatformTime::Seconds();
+	Server->State = ELobbyFleetServerState::Hosting;
+	Server->LastOccupiedTime = Now;
+	UE_LOG(LogMultiplayerSessions, Log, TEXT("Lobby server %d accepted %s lobby after %.2fs"), Server->ServerId, *Server->AssignedRequest.MatchType, Now - Server->AssignTime);
+
+	ReplyToHostRequest(Server->AssignedRequest, SessionDirectoryProtocol::MakeLine({ LobbyFleetProtocol::Assigned, Server->AssignedRequest.RequestId, GetServerAddress(*Server) }));
+	Server->AssignedRequest = FLobbyFleetHostRequest();
+}
+
+/** Hand queued requests to idle servers, failing the ones that waited too long */
+void FLobbyFleetManager::AssignHostRequests()
+{
+	const double Now = FPlatformTime::Seconds();
+
+	UpdateAssigningServers();
+
+	// Requesters are only answered once the server accepts, so a server that never got the request isn't handed out
+	for (int32 Index = 0; Index < PendingHostRequests.Num(); )
+	{
+		const FLobbyFleetHostRequest& Request = PendingHostRequests[Index];
+		if (FLobbyFleetServer* Server = FindLeastLoadedIdleServer())
+		{
+			const FString HostMessage = SessionDirectoryProtocol::MakeLine({ LobbyFleetProtocol::Host, Request.RequestId, Request.MatchType, LexToString(Request.NumPublicConnections) });
+			SessionDirectoryProtocol::SendMessage(Socket, HostMessage, *Server->ReportAddress);
+
+			Server->State = ELobbyFleetServerState::Assigning;
+			Server->AssignedRequest = Request;
+			Server->AssignTime = Server->LastAssignSendTime = Now;
+			Server->LastOccupiedTime = Now;
+			UE_LOG(LogMultiplayerSessions, Log, TEXT("Lobby server %d assigned %s lobby for %d players"), Server->ServerId, *Request.MatchType, Request.NumPublicConnections);
+		}
+		else if (Now - Request.RequestTime > HostRequestTimeout)
+		{
+			UE_LOG(LogMultiplayerSessions, Warning, TEXT("Lobby fleet has no capacity for %s lobby request"), *Request.MatchType);
+			ReplyToHostRequest(Request, SessionDirectoryProtocol::MakeLine({ LobbyFleetProtocol::Busy, Request.RequestId }));
+		}
+		else
+		{
+			++Index;
+			continue;
+		}
+
+		PendingHostRequests.RemoveAt(Index, 1, false);
+	}
+
+	// Retries stop well before twice the request timeout
+	for (auto It = RecentAssignments.CreateIterator(); It; ++It)
+	{
+		if (Now - It->Value.Value > 2.0 * HostRequestTimeout)
+		{
+			It.RemoveCurrent();
+		}
+	}
+}
+
+/** Resend host requests servers haven't accepted yet, returning the servers that didn't accept in time to idle */
+void FLobbyFleetManager::UpdateAssigningServers()
+{
+	const double Now = FPlatformTime::Seconds();
+	for (FLobbyFleetServer& Server : Servers)
+	{
+		if (Server.State != ELobbyFleetServerState::Assigning)
+		{
+			continue;
+		}
+
+		const FLobbyFleetHostRequest& Request = Server.AssignedRequest;
+		if (Now - Server.AssignTime > AssignTimeout)
+		{
+			// Request goes back to the front of the queue, keeping its original time so it still times out for the requester
+			UE_LOG(LogMultiplayerSessions, Warning, TEXT("Lobby server %d didn't accept %s lobby in time, going back to idle"), Server.ServerId, *Request.MatchType);
+			PendingHostRequests.Insert(Request, 0);
+			Server.AssignedRequest = FLobbyFleetHostRequest();
+			Server.State = ELobbyFleetServerState::Idle;
+		}
+		else if (Now - Server.LastAssignSendTime > AssignRetryInterval)
+		{
+			Server.LastAssignSendTime = Now;
+			const FString HostMessage = SessionDirectoryProtocol::MakeLine({ LobbyFleetProtocol::Host, Request.RequestId, Request.MatchType, LexToString(Request.NumPublicConnections) });
+			SessionDirectoryProtocol::SendMessage(Socket, HostMessage, *Server.ReportAddress);
+		}
+	}
+}
+
+/** Answer the request and remember the reply, so retries get the same one */
+void FLobbyFleetManager::ReplyToHostRequest(const FLobbyFleetHostRequest& Request, const FString& Reply)
+{
+	SessionDirectoryProtocol::SendMessage(Socket, Reply, *Request.RequesterAddress);
+
+	const FString RequestKey = Request.RequesterAddress->ToString(true) + TEXT("/") + Request.RequestId;
+	RecentAssignments.Add(RequestKey, TPair<FString, double>(Reply, FPlatformTime::Seconds()));
+}
+
+/** Shut down servers that exited, stopped reporting, or should be recycled */
+void FLobbyFleetManager::RecycleServers()
+{
+	const double Now = FPlatformTime::Seconds();
+	int32 NumIdleServers = Servers.FilterByPredicate([](const FLobbyFleetServer& Server)
+	{
+		return Server.State == ELobbyFleetServerState::Idle;
+	}).Num();
+
+	for (int32 Index = Servers.Num() - 1; Index >= 0; --Index)
+	{
+		FLobbyFleetServer& Server = Servers[Index];
+		const bool bIsStarting = Server.State == ELobbyFleetServerState::Starting;
+		const bool bIsEmpty = Server.NumPlayers == 0;
+
+		const TCHAR* Reason = nullptr;
+		if (!FPlatformProcess::IsProcRunning(Server.ProcessHandle))
+		{
+			Reason = TEXT("process exited");
+		}
+		else if (bIsStarting ? Now - Server.StartTime > StartupTimeout : Now - Server.LastReportTime > ReportTimeout)
+		{
+			Reason = TEXT("stopped reporting");
+		}
+		else if (!bIsStarting && bIsEmpty && RecycleMemoryMB > 0 && Server.MemoryMB > RecycleMemoryMB)
+		{
+			Reason = TEXT("using too much memory");
+		}
+		else if (Server.State == ELobbyFleetServerState::Hosting && bIsEmpty && Now - Server.LastOccupiedTime > RecycleEmptyTime)
+		{
+			Reason = TEXT("lobby is empty");
+		}
+		else if (Server.State == ELobbyFleetServerState::Idle && NumIdleServers > MinIdleServers + PendingHostRequests.Num() && Now - Server.LastOccupiedTime > RecycleEmptyTime)
+		{
+			Reason = TEXT("more idle servers than needed");
+		}
+
+		if (Reason)
+		{
+			// Request the server was being assigned goes to another one
+			if (Server.State == ELobbyFleetServerState::Assigning)
+			{
+				PendingHostRequests.Insert(Server.AssignedRequest, 0);
+			}
+
+			NumIdleServers -= Server.State == ELobbyFleetServerState::Idle ? 1 : 0;
+			StopServer(Server, Reason);
+			Servers.RemoveAt(Index, 1, false);
+		}
+	}
+}
+
+/** Start servers until enough idle ones are ready, within the machine's limits */
+void FLobbyFleetManager::PrewarmServers()
+{
+	int32 NumAvailableServers = 0;
+	int32 TotalMemoryMB = 0;
+	for (const FLobbyFleetServer& Server : Servers)
+	{
+		NumAvailableServers += Server.State == ELobbyFleetServerState::Starting || Server.State == ELobbyFleetServerState::Idle ? 1 : 0;
+		TotalMemoryMB += Server.MemoryMB;
+	}
+
+	// Leave room for one more server of the average size, as far as the memory budget goes
+	const int32 AverageMemoryMB = Servers.IsEmpty() ? 0 : TotalMemoryMB / Servers.Num();
+	const int32 NumNeededServers = MinIdleServers + PendingHostRequests.Num();
+	while (NumAvailableServers < NumNeededServers && Servers.Num() < MaxServers)
+	{
+		if (MaxTotalMemoryMB > 0 && TotalMemoryMB + AverageMemoryMB > MaxTotalMemoryMB)
+		{
+			break;
+		}
+
+		if (!StartServer())
+		{
+			break;
+		}
+
+		++NumAvailableServers;
+		TotalMemoryMB += AverageMemoryMB;
+	}
+}
+
+/** Start a lobby server process */
+bool FLobbyFleetManager::StartServer()
+{
+	// Take the lowest game and beacon ports no running server uses, as every server on this machine binds its own
+	int32 GamePort = FirstGamePort;
+	while (Servers.ContainsByPredicate([GamePort](const FLobbyFleetServer& Server) { return Server.GamePort == GamePort; }))
+	{
+		++GamePort;
+	}
+
+	int32 BeaconPort = FirstBeaconPort;
+	while (Servers.ContainsByPredicate([BeaconPort](const FLobbyFleetServer& Server) { return Server.BeaconPort == BeaconPort; }))
+	{
+		++BeaconPort;
+	}
+
+	const int32 ServerId = NextServerId++;
+	const FString Executable = ServerExecutable.IsEmpty() ? FString(FPlatformProcess::ExecutablePath()) : ServerExecutable;
+	FString Arguments = FString::Printf(TEXT("%s -server -log -unattended -nullrhi -port=%d -BeaconPort=%d -FleetManager=127.0.0.1:%d -FleetServerId=%d %s"),
+		*ServerMap, GamePort, BeaconPort, ManagerPort, ServerId, *ServerArguments);
+
+#if WITH_EDITOR
+	// Editor executables need to be told which project to run
+	Arguments = FString::Printf(TEXT("\"%s\" %s"), *FPaths::ConvertRelativePathToFull(FPaths::GetProjectFilePath()), *Arguments);
+#endif
+
+	FProcHandle ProcessHandle = FPlatformProcess::CreateProc(*Executable, *Arguments, true, true, true, nullptr, 0, nullptr, nullptr);
+	if (!ProcessHandle.IsValid())
+	{
+		UE_LOG(LogMultiplayerSessions, Error, TEXT("Lobby fleet couldn't start %s %s"), *Executable, *Arguments);
+		return false;
+	}
+
+	FLobbyFleetServer& Server = Servers.AddDefaulted_GetRef();
+	Server.ServerId = ServerId;
+	Server.GamePort = GamePort;
+	Server.BeaconPort = BeaconPort;
+	Server.ProcessHandle = ProcessHandle;
+	Server.StartTime = FPlatformTime::Seconds();
+
+	UE_LOG(LogMultiplayerSessions, Log, TEXT("Lobby server %d starting on port %d, beacon port %d"), ServerId, GamePort, BeaconPort);
+	return true;
+}
+
+/** Shut down server's process */
+void FLobbyFleetManager::StopServer(FLobbyFleetServer& Server, const TCHAR* Reason)
+{
+	UE_LOG(LogMultiplayerSessions, Log, TEXT("Lobby server %d on port %d shut down: %s"), Server.ServerId, Server.GamePort, Reason);
+
+	if (Server.ProcessHandle.IsValid())
+	{
+		if (FPlatformProcess::IsProcRunning(Server.ProcessHandle))
+		{
+			FPlatformProcess::TerminateProc(Server.ProcessHandle, true);
+		}
+		FPlatformProcess::CloseProc(Server.ProcessHandle);
+	}
+}
+
+/** Idle server with the lowest load, if any */
+FLobbyFleetServer* FLobbyFleetManager::FindLeastLoadedIdleServer()
+{
+	FLobbyFleetServer* BestServer = nullptr;
+	for (FLobbyFleetServer& Server : Servers)
+	{
+		if (Server.State != ELobbyFleetServerState::Idle || !Server.ReportAddress.IsValid())
+		{
+			continue;
+		}
+
+		// Frame time first, as it's what players feel, memory to break ties between equally fast servers
+		if (!BestServer || Server.AverageFrameTime < BestServer->AverageFrameTime
+			|| (Server.AverageFrameTime == BestServer->AverageFrameTime && Server.MemoryMB < BestServer->MemoryMB))
+		{
+			BestServer = &Server;
+		}
+	}
+	return BestServer;
+}
+
+/** Address players travel to for joining the given server */
+FString FLobbyFleetManager::GetServerAddress(const FLobbyFleetServer& Server) const
+{
+	FString Host = PublicHost;
+	if (Host.IsEmpty())
+	{
+		bool bCanBindAll = false;
+		Host = ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM)->GetLocalHostAddr(*GLog, bCanBindAll)->ToString(false);
+	}
+
+	return FString::Printf(TEXT("%s:%d"), *Host, Server.GamePort);
+}
+
+#pragma endregion FLEET
@@ -0,0 +1,35 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+// Unreal Engine
+#include "CoreMinimal.h"
+
+// MultiplayerSessions
+#include "SessionDirectory/SessionDirectoryProtocol.h"
+
+/**
+ * Wire format shared by the lobby fleet manager, the lobby servers it runs and the ones requesting lobbies.
+ * Messages are single tab separated lines, sent with the session directory's helpers:
+ *   REPORT   <ServerId> <State> <NumPlayers> <AvgFrameMs> <MemoryMB>   server to manager, every report interval
+ *   HOST     <RequestId> <MatchType> <NumPublicConnections>           requester to manager, then manager to the assigned server until accepted
+ *   ACCEPTED <ServerId> <RequestId>                                     server to manager, once the requested lobby's session is created
+ *   ASSIGNED <RequestId> <Address>                                     manager to requester, once the server accepted
+ *   BUSY     <RequestId>                                               manager to requester, when no server freed up in time
+ */
+namespace LobbyFleetProtocol
+{
+	/** Port used by the fleet manager when none is specified */
+	constexpr int32 DefaultPort = 7790;
+
+	/** Message types */
+	constexpr const TCHAR* Report = TEXT("REPORT");
+	constexpr const TCHAR* Host = TEXT("HOST");
+	constexpr const TCHAR* Accepted = TEXT("ACCEPTED");
+	constexpr const TCHAR* Assigned = TEXT("ASSIGNED");
+	constexpr const TCHAR* Busy = TEXT("BUSY");
+
+	/** Server states, as reported */
+	constexpr const TCHAR* StateIdle = TEXT("IDLE");
+	constexpr const TCHAR* StateHosting = TEXT("HOSTING");
+}
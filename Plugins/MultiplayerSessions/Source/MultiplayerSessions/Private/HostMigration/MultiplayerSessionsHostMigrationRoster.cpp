@@ -0,0 +1,137 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "HostMigration/MultiplayerSessionsHostMigrationRoster.h"
+
+// Unreal Engine
+#include "Engine/GameInstance.h"
+#include "Engine/NetConnection.h"
+#include "Engine/NetDriver.h"
+#include "Engine/World.h"
+#include "GameFramework/PlayerController.h"
+#include "GameFramework/PlayerState.h"
+#include "Net/UnrealNetwork.h"
+
+// MultiplayerSessions
+#include "Subsystems/MultiplayerSessionsSubsystem.h"
+
+/** Get the player elected for taking over the session, if any, skipping players the host hadn't heard from for more than MaxHeartbeatAge seconds */
+const FMultiplayerHostMigrationPlayer* FMultiplayerHostMigrationRoster::GetSuccessor(float MaxHeartbeatAge) const
+{
+	const FMultiplayerHostMigrationPlayer* Successor = nullptr;
+	for (const FMultiplayerHostMigrationPlayer& Player : Players)
+	{
+		// Players that were already timing out when the roster was sent may have left with the host
+		if (UpdateTime - Player.LastHeartbeatTime > MaxHeartbeatAge)
+		{
+			continue;
+		}
+
+		if (!Successor || Player.JoinOrder < Successor->JoinOrder)
+		{
+			Successor = &Player;
+		}
+	}
+	return Successor;
+}
+
+#pragma region INITIALIZATION
+
+/** Constructor */
+AMultiplayerSessionsHostMigrationRoster::AMultiplayerSessionsHostMigrationRoster()
+{
+	PrimaryActorTick.bCanEverTick = true;
+	PrimaryActorTick.TickInterval = 1.f;
+
+	bReplicates = true;
+	bAlwaysRelevant = true;
+	NetUpdateFrequency = 1.f;
+}
+
+/** Setup session's settings shared with the successor */
+void AMultiplayerSessionsHostMigrationRoster::SetupRoster(int32 NumPublicConnections, const FString& MatchType)
+{
+	Roster.NumPublicConnections = NumPublicConnections;
+	Roster.MatchType = MatchType;
+	Roster.PathToMap = GetWorld()->GetOutermost()->GetName();
+	RefreshRoster();
+}
+
+#pragma endregion INITIALIZATION
+
+#pragma region OVERRIDES
+
+/** Refresh roster on the server */
+void AMultiplayerSessionsHostMigrationRoster::Tick(float DeltaSeconds)
+{
+	Super::Tick(DeltaSeconds);
+
+	if (HasAuthority())
+	{
+		RefreshRoster();
+	}
+}
+
+/** Setup replicated properties */
+void AMultiplayerSessionsHostMigrationRoster::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+	DOREPLIFETIME(AMultiplayerSessionsHostMigrationRoster, Roster);
+}
+
+#pragma endregion OVERRIDES
+
+#pragma region ROSTER
+
+/** Rebuild roster out of the connected players */
+void AMultiplayerSessionsHostMigrationRoster::RefreshRoster()
+{
+	const float WorldTime = GetWorld()->GetTimeSeconds();
+
+	TArray<FMultiplayerHostMigrationPlayer> Players;
+	for (FConstPlayerControllerIterator It = GetWorld()->GetPlayerControllerIterator(); It; ++It)
+	{
+		const APlayerController* PlayerController = It->Get();
+		const UNetConnection* Connection = PlayerController ? PlayerController->GetNetConnection() : nullptr;
+		const APlayerState* PlayerState = PlayerController ? PlayerController->GetPlayerState<APlayerState>() : nullptr;
+
+		// Local players belong to the host, which can't be its own successor
+		if (!Connection || !PlayerState || !PlayerState->GetUniqueId().IsValid())
+		{
+			continue;
+		}
+
+		FMultiplayerHostMigrationPlayer& Player = Players.AddDefaulted_GetRef();
+		Player.PlayerId = PlayerState->GetUniqueId()->ToString();
+
+		const int32* JoinOrder = JoinOrders.Find(Player.PlayerId);
+		Player.JoinOrder = JoinOrder ? *JoinOrder : JoinOrders.Add(Player.PlayerId, NextJoinOrder++);
+
+		// Connection's receive time is kept on its driver's clock, so only its age is carried over to the world's
+		const double HeartbeatAge = Connection->Driver ? Connection->Driver->GetElapsedTime() - Connection->LastReceiveRealtime : 0.0;
+		Player.LastHeartbeatTime = WorldTime - FMath::Max(static_cast<float>(HeartbeatAge), 0.f);
+	}
+
+	Players.Sort([](const FMultiplayerHostMigrationPlayer& A, const FMultiplayerHostMigrationPlayer& B)
+	{
+		return A.JoinOrder < B.JoinOrder;
+	});
+
+	// Roster is refreshed on every tick, so clients can tell how recent it and its heartbeats are
+	Roster.Players = MoveTemp(Players);
+	Roster.UpdateTime = WorldTime;
+}
+
+/** Hand replicated roster over to the multiplayer sessions subsystem */
+void AMultiplayerSessionsHostMigrationRoster::OnRep_Roster()
+{
+	if (const UGameInstance* GameInstance = GetGameInstance())
+	{
+		if (UMultiplayerSessionsSubsystem* MultiplayerSessionsSubsystem = GameInstance->GetSubsystem<UMultiplayerSessionsSubsystem>())
+		{
+			MultiplayerSessionsSubsystem->CacheHostMigrationRoster(Roster);
+		}
+	}
+}
+
+#pragma endregion ROSTER
@@ -10,6 +10,7 @@
 
 // MultiplayerSessions
 #include "Subsystems/MultiplayerSessionsSubsystem.h"
+#include "Subsystems/MultiplayerSessionsMenuSubsystem.h"
 
 #pragma region OVERRIDES
 
@@ -36,6 +37,11 @@ bool UMenu::Initialize()
 	{
 		QuitButton->OnClicked.AddUniqueDynamic(this, &UMenu::QuitButtonClicked);
 	}
+
+	if (SpectateButton)
+	{
+		SpectateButton->OnClicked.AddUniqueDynamic(this, &UMenu::SpectateButtonClicked);
+	}
 	
 	return true;
 }
@@ -43,7 +49,7 @@ bool UMenu::Initialize()
 /** Destruct widget */
 void UMenu::NativeDestruct()
 {
-	RemoveMenu();
+	HideMenu();
 	Super::NativeDestruct();
 }
 
@@ -51,18 +57,50 @@ void UMenu::NativeDestruct()
 
 #pragma region MENU
 
-/** Setup menu */
+/** Setup menu. Menus created outside of the menu pool hand off to the pooled instance of their class */
 void UMenu::SetupMenu(const FMultiplayerSessionSettings& InMultiplayerSessionSettings)
 {
+	// Menus created by level blueprints are only used for finding the pooled one, which keeps its widget tree across level transitions
+	if (!bIsPooled)
+	{
+		if (const UGameInstance* GameInstance = GetGameInstance())
+		{
+			if (UMultiplayerSessionsMenuSubsystem* MenuSubsystem = GameInstance->GetSubsystem<UMultiplayerSessionsMenuSubsystem>())
+			{
+				MenuSubsystem->ShowMenu(GetClass(), InMultiplayerSessionSettings);
+				return;
+			}
+		}
+	}
+
 	// Set multiplayer session settings
 	MultiplayerSessionSettings = InMultiplayerSessionSettings;
 	MultiplayerSessionSettings.PathToLobby = FString::Printf(TEXT("%s?listen"), *InMultiplayerSessionSettings.PathToLobby);
 
+	BindSessionCallbacks();
+	ShowMenu();
+}
+
+/** Show menu, adding it back to the viewport if a level transition removed it */
+void UMenu::ShowMenu()
+{
 	// Show widget
-	AddToViewport();
+	if (!IsInViewport())
+	{
+		AddToViewport();
+	}
 	SetVisibility(ESlateVisibility::Visible);
 	bIsFocusable = true;
 
+	// Buttons were disabled when last clicked, so enable them again unless the online subsystem is still warming up
+	const bool bIsSubsystemReady = !MultiplayerSessionsSubsystem || MultiplayerSessionsSubsystem->IsOnlineSubsystemReady();
+	HostButton->SetIsEnabled(bIsSubsystemReady);
+	JoinButton->SetIsEnabled(bIsSubsystemReady);
+	if (SpectateButton)
+	{
+		SpectateButton->SetIsEnabled(bIsSubsystemReady);
+	}
+
 	// Setup input
 	if (const UWorld* World = GetWorld())
 	{
@@ -75,28 +113,23 @@ void UMenu::SetupMenu(const FMultiplayerSessionSettings& InMultiplayerSessionSet
 			PlayerController->SetShowMouseCursor(true);
 		}
 	}
+}
 
-	// Initialize multiplayer sessions' subsystem
-	if (const UGameInstance* GameInstance = GetGameInstance())
-	{
-		MultiplayerSessionsSubsystem = GameInstance->GetSubsystem<UMultiplayerSessionsSubsystem>();
-	}
-	
-	// Setup callbacks
-	if (MultiplayerSessionsSubsystem)
-	{
-		MultiplayerSessionsSubsystem->MultiplayerOnCreateSessionCompleteDelegate.AddUniqueDynamic(this, &UMenu::OnCreateSession);
-		MultiplayerSessionsSubsystem->MultiplayerOnFindSessionsCompleteDelegate.AddUObject(this, &UMenu::OnFindSessions);
-		MultiplayerSessionsSubsystem->MultiplayerOnJoinSessionCompleteDelegate.AddUObject(this, &UMenu::OnJoinSession);
-		MultiplayerSessionsSubsystem->MultiplayerOnStartSessionCompleteDelegate.AddUniqueDynamic(this, &UMenu::OnStartSession);
-		MultiplayerSessionsSubsystem->MultiplayerOnDestroySessionCompleteDelegate.AddUniqueDynamic(this, &UMenu::OnDestroySession);
-	}
+/** Whether the menu is shown */
+bool UMenu::IsMenuVisible() const
+{
+	return IsInViewport() && GetVisibility() != ESlateVisibility::Collapsed;
 }
 
-/** Remove menu */
-void UMenu::RemoveMenu()
+/** Hide menu, keeping it in the viewport */
+void UMenu::HideMenu()
 {
-	RemoveFromParent();
+	if (GetVisibility() == ESlateVisibility::Collapsed)
+	{
+		return;
+	}
+
+	SetVisibility(ESlateVisibility::Collapsed);
 	if (const UWorld* World = GetWorld())
 	{
 		if (APlayerController* PlayerController = World->GetFirstPlayerController())
@@ -123,11 +156,22 @@ void UMenu::HostButtonClicked()
 void UMenu::JoinButtonClicked()
 {
 	JoinButton->SetIsEnabled(false);
+	bIsSpectating = false;
 	
-	if (MultiplayerSessionsSubsystem)
+	if (!MultiplayerSessionsSubsystem)
+	{
+		return;
+	}
+
+	// Quick match may end up hosting, so hosting isn't offered meanwhile
+	if (MultiplayerSessionSettings.bUseQuickMatch)
 	{
-		MultiplayerSessionsSubsystem->FindSessions(MultiplayerSessionSettings.MaxSearchResults);
+		HostButton->SetIsEnabled(false);
+		MultiplayerSessionsSubsystem->QuickMatch(MultiplayerSessionSettings.NumPublicConnections, MultiplayerSessionSettings.MatchType, MultiplayerSessionSettings.MaxSearchResults);
+		return;
 	}
+
+	MultiplayerSessionsSubsystem->FindSessions(MultiplayerSessionSettings.MaxSearchResults, MultiplayerSessionSettings.MatchType);
 }
 
 /** Callback for QuitButton's OnClicked event */
@@ -136,13 +180,89 @@ void UMenu::QuitButtonClicked()
 	UKismetSystemLibrary::QuitGame(this, nullptr, EQuitPreference::Quit, false);
 }
 
+/** Callback for SpectateButton's OnClicked event */
+void UMenu::SpectateButtonClicked()
+{
+	SpectateButton->SetIsEnabled(false);
+	bIsSpectating = true;
+
+	// Spectators can watch sessions with no open public connection left
+	if (MultiplayerSessionsSubsystem)
+	{
+		MultiplayerSessionsSubsystem->FindSessions(MultiplayerSessionSettings.MaxSearchResults, MultiplayerSessionSettings.MatchType, true);
+	}
+}
+
+/** Button the running find and join were started with, enabled again if they fail */
+UButton* UMenu::GetJoinRequestButton() const
+{
+	return bIsSpectating && SpectateButton ? SpectateButton.Get() : JoinButton.Get();
+}
+
 #pragma endregion MENU
 
 #pragma region SESSION
 
+/** Bind callbacks to the multiplayer sessions subsystem, if they weren't already */
+void UMenu::BindSessionCallbacks()
+{
+	if (bAreSessionCallbacksBound)
+	{
+		return;
+	}
+
+	// Initialize multiplayer sessions' subsystem
+	if (const UGameInstance* GameInstance = GetGameInstance())
+	{
+		MultiplayerSessionsSubsystem = GameInstance->GetSubsystem<UMultiplayerSessionsSubsystem>();
+	}
+	
+	// Setup callbacks
+	if (MultiplayerSessionsSubsystem)
+	{
+		MultiplayerSessionsSubsystem->MultiplayerOnCreateSessionCompleteDelegate.AddUniqueDynamic(this, &UMenu::OnCreateSession);
+		MultiplayerSessionsSubsystem->MultiplayerOnFindSessionsCompleteDelegate.AddUObject(this, &UMenu::OnFindSessions);
+		MultiplayerSessionsSubsystem->MultiplayerOnSearchSnapshotRefreshedDelegate.AddUObject(this, &UMenu::OnSearchSnapshotRefreshed);
+		MultiplayerSessionsSubsystem->MultiplayerOnJoinSessionCompleteDelegate.AddUObject(this, &UMenu::OnJoinSession);
+		MultiplayerSessionsSubsystem->MultiplayerOnStartSessionCompleteDelegate.AddUniqueDynamic(this, &UMenu::OnStartSession);
+		MultiplayerSessionsSubsystem->MultiplayerOnDestroySessionCompleteDelegate.AddUniqueDynamic(this, &UMenu::OnDestroySession);
+		MultiplayerSessionsSubsystem->MultiplayerOnQuickMatchCompleteDelegate.AddUObject(this, &UMenu::OnQuickMatch);
+
+		// Wait for online subsystem's warm up without blocking, keeping session buttons disabled meanwhile
+		if (!MultiplayerSessionsSubsystem->IsOnlineSubsystemReady())
+		{
+			MultiplayerSessionsSubsystem->MultiplayerOnSubsystemReadyDelegate.AddUniqueDynamic(this, &UMenu::OnSubsystemReady);
+		}
+		bAreSessionCallbacksBound = true;
+	}
+}
+
+/** Callback called when the multiplayer sessions subsystem's online subsystem is ready */
+void UMenu::OnSubsystemReady(bool bWasSuccessful)
+{
+	if (MultiplayerSessionsSubsystem)
+	{
+		MultiplayerSessionsSubsystem->MultiplayerOnSubsystemReadyDelegate.RemoveDynamic(this, &UMenu::OnSubsystemReady);
+	}
+
+	HostButton->SetIsEnabled(bWasSuccessful);
+	JoinButton->SetIsEnabled(bWasSuccessful);
+	if (SpectateButton)
+	{
+		SpectateButton->SetIsEnabled(bWasSuccessful);
+	}
+}
+
 /** Callback called when the multiplayer session creation is complete */
 void UMenu::OnCreateSession(bool bWasSuccessful)
 {
+	// Pooled menus stay bound while hidden, so leave requests made elsewhere alone.
+	// Quick match may still give up its created session for another one, so it's only travelled to once the quick match completes
+	if (!IsMenuVisible() || (MultiplayerSessionsSubsystem && MultiplayerSessionsSubsystem->IsQuickMatchInProgress()))
+	{
+		return;
+	}
+
 	// Debug
 	if (GEngine)
 	{
@@ -156,10 +276,7 @@ void UMenu::OnCreateSession(bool bWasSuccessful)
 	
 	if (bWasSuccessful)
 	{
-		if (UWorld* World = GetWorld())
-		{
-			World->ServerTravel(MultiplayerSessionSettings.PathToLobby);
-		}
+		TravelToCreatedSession();
 	}
 	else
 	{
@@ -167,13 +284,56 @@ void UMenu::OnCreateSession(bool bWasSuccessful)
 	}
 }
 
+/** Travel to the created session's lobby, listening on it unless the lobby fleet hosts it */
+void UMenu::TravelToCreatedSession()
+{
+	FString FleetLobbyAddress;
+	if (MultiplayerSessionsSubsystem && MultiplayerSessionsSubsystem->GetFleetLobbyAddress(FleetLobbyAddress))
+	{
+		if (APlayerController* PlayerController = GetGameInstance()->GetFirstLocalPlayerController())
+		{
+			HideMenu();
+			PlayerController->ClientTravel(FleetLobbyAddress, TRAVEL_Absolute);
+		}
+	}
+	else if (UWorld* World = GetWorld())
+	{
+		HideMenu();
+		World->ServerTravel(MultiplayerSessionSettings.PathToLobby);
+	}
+}
+
 /** Callback called when the multiplayer sessions finding is complete */
 void UMenu::OnFindSessions(const TArray<FOnlineSessionSearchResult>& SessionResults, bool bWasSuccessful)
 {
-	if (!MultiplayerSessionsSubsystem)
+	// Pooled menus stay bound while hidden, so leave requests made elsewhere alone
+	if (!IsMenuVisible())
 	{
 		return;
 	}
+
+	// Quick match joins or hosts on its own, travelling through the join and quick match callbacks
+	if (!MultiplayerSessionsSubsystem || MultiplayerSessionsSubsystem->IsQuickMatchInProgress())
+	{
+		return;
+	}
+
+	// Snapshot sessions may be gone or full by now, so the pick waits for the search confirming them
+	SnapshotPick.Reset();
+	if (MultiplayerSessionsSubsystem->IsRefreshingSearchSnapshot())
+	{
+		const FOnlineSessionSearchResult* PickedResult = SessionResults.FindByPredicate([this](const FOnlineSessionSearchResult& Result)
+		{
+			FString MatchType;
+			Result.Session.SessionSettings.Get(FName("MatchType"), MatchType);
+			return MatchType.Equals(MultiplayerSessionSettings.MatchType);
+		});
+		if (PickedResult)
+		{
+			SnapshotPick = *PickedResult;
+			return;
+		}
+	}
 	
 	for (const FOnlineSessionSearchResult& Result : SessionResults)
 	{
@@ -181,38 +341,71 @@ void UMenu::OnFindSessions(const TArray<FOnlineSessionSearchResult>& SessionResu
 		Result.Session.SessionSettings.Get(FName("MatchType"), MatchType);
 		if (MatchType.Equals(MultiplayerSessionSettings.MatchType))
 		{
-			MultiplayerSessionsSubsystem->JoinSession(Result);
+			MultiplayerSessionsSubsystem->JoinSession(Result, bIsSpectating);
 		}
 	}
 
 	if (!bWasSuccessful || SessionResults.IsEmpty())
 	{
-		JoinButton->SetIsEnabled(true);
+		GetJoinRequestButton()->SetIsEnabled(true);
+	}
+}
+
+/** Callback called when the search confirming the served snapshot is complete, joining the session picked from the snapshot once confirmed, or its replacement */
+void UMenu::OnSearchSnapshotRefreshed(const TArray<FOnlineSessionSearchResult>& SessionResults, bool bWasSuccessful)
+{
+	if (!SnapshotPick.IsSet())
+	{
+		return;
+	}
+
+	const FOnlineSessionSearchResult PickedResult = SnapshotPick.GetValue();
+	SnapshotPick.Reset();
+
+	// Pooled menus stay bound while hidden, so leave requests made elsewhere alone
+	if (!IsMenuVisible() || !MultiplayerSessionsSubsystem)
+	{
+		return;
+	}
+
+	const FOnlineSessionSearchResult* RefreshedResult = bWasSuccessful ? MultiplayerSessionsSubsystem->FindRefreshedSearchResult(SessionResults, PickedResult) : nullptr;
+	if (RefreshedResult)
+	{
+		MultiplayerSessionsSubsystem->JoinSession(*RefreshedResult, bIsSpectating);
+	}
+	else
+	{
+		GetJoinRequestButton()->SetIsEnabled(true);
 	}
 }
 
 /** Callback called when the multiplayer session join is complete */
 void UMenu::OnJoinSession(EOnJoinSessionCompleteResult::Type Result)
 {
-	/** Initialize online subsystem */
-	if (const IOnlineSubsystem* Subsystem = IOnlineSubsystem::Get())
+	// Pooled menus stay bound while hidden, so leave requests made elsewhere alone
+	if (!IsMenuVisible())
 	{
-		IOnlineSessionPtr SessionInterface = Subsystem->GetSessionInterface();
-		if (SessionInterface.IsValid())
-		{
-			FString Address;
-			SessionInterface->GetResolvedConnectString(NAME_GameSession, Address);
+		return;
+	}
 
+	// Failed joins have no session to travel to
+	if (MultiplayerSessionsSubsystem && Result == EOnJoinSessionCompleteResult::Success)
+	{
+		FString Address;
+		if (MultiplayerSessionsSubsystem->GetResolvedConnectString(Address))
+		{
 			if (APlayerController* PlayerController = GetGameInstance()->GetFirstLocalPlayerController())
 			{
+				HideMenu();
 				PlayerController->ClientTravel(Address, TRAVEL_Absolute);
 			}
 		}
 	}
 
-	if (Result != EOnJoinSessionCompleteResult::Success)
+	// Quick match keeps looking after a failed join
+	if (Result != EOnJoinSessionCompleteResult::Success && !(MultiplayerSessionsSubsystem && MultiplayerSessionsSubsystem->IsQuickMatchInProgress()))
 	{
-		JoinButton->SetIsEnabled(true);
+		GetJoinRequestButton()->SetIsEnabled(true);
 	}
 }
 
@@ -228,4 +421,24 @@ void UMenu::OnDestroySession(bool bWasSuccessful)
 	
 }
 
+/** Callback called when the quick match is complete */
+void UMenu::OnQuickMatch(EMultiplayerQuickMatchResult Result)
+{
+	// Joined sessions were already travelled to by the join callback
+	if (!IsMenuVisible() || Result == EMultiplayerQuickMatchResult::Joined)
+	{
+		return;
+	}
+
+	// Created session is only travelled to now, as the quick match's tie-break may have given it up for another one
+	if (Result == EMultiplayerQuickMatchResult::Created)
+	{
+		TravelToCreatedSession();
+		return;
+	}
+
+	HostButton->SetIsEnabled(true);
+	JoinButton->SetIsEnabled(true);
+}
+
 #pragma endregion SESSION
@@ -2,6 +2,8 @@
 
 #include "MultiplayerSessions.h"
 
+DEFINE_LOG_CATEGORY(LogMultiplayerSessions);
+
 #define LOCTEXT_NAMESPACE "FMultiplayerSessionsModule"
 
 void FMultiplayerSessionsModule::StartupModule()
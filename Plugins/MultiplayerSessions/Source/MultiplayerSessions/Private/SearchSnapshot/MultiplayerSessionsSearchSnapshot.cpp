@@ -0,0 +1,170 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "SearchSnapshot/MultiplayerSessionsSearchSnapshot.h"
+
+// Unreal Engine
+#include "Async/MappedFileHandle.h"
+#include "HAL/PlatformFileManager.h"
+#include "Misc/FileHelper.h"
+#include "OnlineSessionSettings.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+
+// MultiplayerSessions
+#include "MultiplayerSessions.h"
+#include "Subsystems/MultiplayerSessionsSubsystem.h"
+#include "Subsystems/MultiplayerSessionsBuildFingerprint.h"
+
+namespace
+{
+	/** Identifies multiplayer sessions search snapshot files */
+	constexpr uint32 SearchSnapshotMagic = 0x5353534D;
+
+	/** Current search snapshot file version */
+	constexpr uint32 SearchSnapshotVersion = 3;
+}
+
+/** Serialize entry */
+FArchive& operator<<(FArchive& Ar, FMultiplayerSessionsSearchSnapshotEntry& Entry)
+{
+	Ar << Entry.Address;
+	Ar << Entry.MatchType;
+	Ar << Entry.MapName;
+	Ar << Entry.NumOpenPublicConnections;
+	Ar << Entry.NumPublicConnections;
+	Ar << Entry.PingInMs;
+	Ar << Entry.BuildFingerprint;
+	Ar << Entry.BeaconPort;
+	Ar << Entry.FoundTime;
+	return Ar;
+}
+
+#pragma region SEARCH_SNAPSHOT
+
+/** Save snapshot to the given file */
+bool FMultiplayerSessionsSearchSnapshot::SaveToFile(const FString& Filename) const
+{
+	TArray<uint8> Data;
+	FMemoryWriter Writer(Data);
+
+	uint32 Magic = SearchSnapshotMagic;
+	uint32 Version = SearchSnapshotVersion;
+	Writer << Magic;
+	Writer << Version;
+	Writer << const_cast<TArray<FMultiplayerSessionsSearchSnapshotEntry>&>(Entries);
+
+	if (!FFileHelper::SaveArrayToFile(Data, *Filename))
+	{
+		UE_LOG(LogMultiplayerSessions, Warning, TEXT("Couldn't save search snapshot to %s"), *Filename);
+		return false;
+	}
+
+	return true;
+}
+
+/** Load snapshot from the given file, mapping it into memory when the platform allows it, replacing current entries */
+bool FMultiplayerSessionsSearchSnapshot::LoadFromFile(const FString& Filename)
+{
+	Entries.Reset();
+
+	// No snapshot is expected on the very first run
+	IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+	if (!PlatformFile.FileExists(*Filename))
+	{
+		return false;
+	}
+
+	// Region has to be released before the file handle, hence the declaration order
+	TUniquePtr<IMappedFileHandle> MappedFile(PlatformFile.OpenMapped(*Filename));
+	TUniquePtr<IMappedFileRegion> MappedRegion(MappedFile.IsValid() ? MappedFile->MapRegion() : nullptr);
+
+	TArray<uint8> Data;
+	TArrayView<const uint8> View;
+	if (MappedRegion.IsValid())
+	{
+		View = MakeArrayView(MappedRegion->GetMappedPtr(), static_cast<int32>(MappedRegion->GetMappedSize()));
+	}
+	else if (FFileHelper::LoadFileToArray(Data, *Filename))
+	{
+		View = Data;
+	}
+	else
+	{
+		UE_LOG(LogMultiplayerSessions, Warning, TEXT("Couldn't load search snapshot from %s"), *Filename);
+		return false;
+	}
+
+	FMemoryReaderView Reader(View);
+	uint32 Magic = 0;
+	uint32 Version = 0;
+	Reader << Magic;
+	Reader << Version;
+	if (Magic != SearchSnapshotMagic || Version != SearchSnapshotVersion)
+	{
+		UE_LOG(LogMultiplayerSessions, Warning, TEXT("%s isn't a supported search snapshot"), *Filename);
+		return false;
+	}
+
+	Reader << Entries;
+	if (Reader.IsError())
+	{
+		Entries.Reset();
+		UE_LOG(LogMultiplayerSessions, Warning, TEXT("Search snapshot %s is corrupted"), *Filename);
+		return false;
+	}
+
+	return true;
+}
+
+/** Remove entries found longer ago than the given age */
+void FMultiplayerSessionsSearchSnapshot::RemoveExpiredEntries(const FTimespan& MaxAge)
+{
+	const FDateTime ExpiryTime = FDateTime::UtcNow() - MaxAge;
+	Entries.RemoveAll([&ExpiryTime](const FMultiplayerSessionsSearchSnapshotEntry& Entry)
+	{
+		return Entry.FoundTime < ExpiryTime;
+	});
+}
+
+/** Convert search result, joined through the given address, into its snapshot entry */
+FMultiplayerSessionsSearchSnapshotEntry FMultiplayerSessionsSearchSnapshot::MakeEntry(const FOnlineSessionSearchResult& SearchResult, const FString& Address)
+{
+	FMultiplayerSessionsSearchSnapshotEntry Entry;
+	Entry.Address = Address;
+	SearchResult.Session.SessionSettings.Get(FName("MatchType"), Entry.MatchType);
+	SearchResult.Session.SessionSettings.Get(SETTING_MAPNAME, Entry.MapName);
+	Entry.NumOpenPublicConnections = SearchResult.Session.NumOpenPublicConnections;
+	Entry.NumPublicConnections = SearchResult.Session.SessionSettings.NumPublicConnections;
+	Entry.PingInMs = SearchResult.PingInMs;
+	if (!SearchResult.Session.SessionSettings.Get(SETTING_BUILDFINGERPRINT, Entry.BuildFingerprint))
+	{
+		Entry.BuildFingerprint = SearchResult.Session.SessionSettings.BuildUniqueId;
+	}
+	SearchResult.Session.SessionSettings.Get(SETTING_BEACONPORT, Entry.BeaconPort);
+	Entry.FoundTime = FDateTime::UtcNow();
+	return Entry;
+}
+
+/** Convert snapshot entry back into a search result, joined by travelling straight to its address */
+FOnlineSessionSearchResult FMultiplayerSessionsSearchSnapshot::MakeSearchResult(const FMultiplayerSessionsSearchSnapshotEntry& Entry)
+{
+	FOnlineSessionSearchResult SearchResult;
+	SearchResult.Session.NumOpenPublicConnections = Entry.NumOpenPublicConnections;
+	SearchResult.Session.SessionSettings.NumPublicConnections = Entry.NumPublicConnections;
+	SearchResult.Session.SessionSettings.Set(FName("MatchType"), Entry.MatchType, EOnlineDataAdvertisementType::DontAdvertise);
+	SearchResult.Session.SessionSettings.Set(SETTING_SESSIONDIRECTORYADDRESS, Entry.Address, EOnlineDataAdvertisementType::DontAdvertise);
+	if (!Entry.MapName.IsEmpty())
+	{
+		SearchResult.Session.SessionSettings.Set(SETTING_MAPNAME, Entry.MapName, EOnlineDataAdvertisementType::DontAdvertise);
+	}
+	SearchResult.Session.SessionSettings.BuildUniqueId = Entry.BuildFingerprint;
+	SearchResult.Session.SessionSettings.Set(SETTING_BUILDFINGERPRINT, Entry.BuildFingerprint, EOnlineDataAdvertisementType::DontAdvertise);
+	if (Entry.BeaconPort > 0)
+	{
+		SearchResult.Session.SessionSettings.Set(SETTING_BEACONPORT, Entry.BeaconPort, EOnlineDataAdvertisementType::DontAdvertise);
+	}
+	SearchResult.PingInMs = Entry.PingInMs;
+	return SearchResult;
+}
+
+#pragma endregion SEARCH_SNAPSHOT
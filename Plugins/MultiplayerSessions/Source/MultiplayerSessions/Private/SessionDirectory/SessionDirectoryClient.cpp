@@ -0,0 +1,207 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "SessionDirectory/SessionDirectoryClient.h"
+
+// Unreal Engine
+#include "Common/UdpSocketBuilder.h"
+#include "SocketSubsystem.h"
+
+// MultiplayerSessions
+#include "MultiplayerSessions.h"
+#include "SessionDirectory/SessionDirectoryProtocol.h"
+
+#pragma region INITIALIZATION
+
+/** Destructor */
+FSessionDirectoryClient::~FSessionDirectoryClient()
+{
+	Disconnect();
+}
+
+/** Open socket used for talking to the directory at the given address (host[:port]) */
+bool FSessionDirectoryClient::Connect(const FString& DirectoryAddress)
+{
+	Disconnect();
+
+	ISocketSubsystem* SocketSubsystem = ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM);
+	if (!SocketSubsystem)
+	{
+		return false;
+	}
+
+	// Split host and port
+	FString Host = DirectoryAddress;
+	int32 Port = SessionDirectoryProtocol::DefaultPort;
+	FString PortString;
+	if (DirectoryAddress.Split(TEXT(":"), &Host, &PortString, ESearchCase::CaseSensitive, ESearchDir::FromEnd))
+	{
+		LexFromString(Port, *PortString);
+	}
+
+	// Resolve directory's address
+	DirectoryAddr = SocketSubsystem->GetAddressFromString(Host);
+	if (!DirectoryAddr.IsValid())
+	{
+		const FAddressInfoResult AddressInfo = SocketSubsystem->GetAddressInfo(*Host, nullptr, EAddressInfoFlags::Default, NAME_None, ESocketType::SOCKTYPE_Datagram);
+		if (AddressInfo.Results.IsEmpty())
+		{
+			UE_LOG(LogMultiplayerSessions, Warning, TEXT("Couldn't resolve session directory address %s"), *DirectoryAddress);
+			return false;
+		}
+		DirectoryAddr = AddressInfo.Results[0].Address;
+	}
+	DirectoryAddr->SetPort(Port);
+
+	Socket = FUdpSocketBuilder(TEXT("SessionDirectoryClient"))
+		.AsNonBlocking()
+		.BoundToAddress(FIPv4Address::Any)
+		.BoundToPort(0)
+		.WithReceiveBufferSize(256 * 1024)
+		.Build();
+
+	return Socket != nullptr;
+}
+
+/** Close socket, failing any pending query */
+void FSessionDirectoryClient::Disconnect()
+{
+	if (Socket)
+	{
+		Socket->Close();
+		ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM)->DestroySocket(Socket);
+		Socket = nullptr;
+	}
+
+	TMap<int32, FPendingQuery> FailedQueries = MoveTemp(PendingQueries);
+	for (TPair<int32, FPendingQuery>& Pair : FailedQueries)
+	{
+		Pair.Value.OnComplete.ExecuteIfBound(TArray<FSessionDirectoryEntry>(), false);
+	}
+}
+
+#pragma endregion INITIALIZATION
+
+#pragma region DIRECTORY
+
+/** Register session in the directory, or update it if already registered */
+void FSessionDirectoryClient::RegisterSession(const FSessionDirectoryEntry& Entry)
+{
+	Send(FString::Printf(TEXT("%s\t%s"), SessionDirectoryProtocol::Register, *SessionDirectoryProtocol::EncodeEntry(Entry)));
+}
+
+/** Refresh session's heartbeat and number of open connections */
+void FSessionDirectoryClient::HeartbeatSession(const FString& SessionId, int32 NumOpenPublicConnections)
+{
+	Send(SessionDirectoryProtocol::MakeLine({ SessionDirectoryProtocol::Heartbeat, SessionId, LexToString(NumOpenPublicConnections) }));
+}
+
+/** Remove session from the directory */
+void FSessionDirectoryClient::UnregisterSession(const FString& SessionId)
+{
+	Send(SessionDirectoryProtocol::MakeLine({ SessionDirectoryProtocol::Unregister, SessionId }));
+}
+
+/** Find sessions with the given match type (any, if empty) and at least MinOpenPublicConnections open connections */
+void FSessionDirectoryClient::QuerySessions(const FString& MatchType, int32 MinOpenPublicConnections, int32 MaxResults, const FOnSessionDirectoryQueryComplete& OnComplete)
+{
+	if (!Socket)
+	{
+		OnComplete.ExecuteIfBound(TArray<FSessionDirectoryEntry>(), false);
+		return;
+	}
+
+	const int32 RequestId = NextRequestId++;
+
+	FPendingQuery& Query = PendingQueries.Add(RequestId);
+	Query.Message = SessionDirectoryProtocol::MakeLine({ SessionDirectoryProtocol::Query, LexToString(RequestId), MatchType, LexToString(MinOpenPublicConnections), LexToString(MaxResults) });
+	Query.OnComplete = OnComplete;
+	Query.StartTime = Query.LastSendTime = FPlatformTime::Seconds();
+
+	Send(Query.Message);
+}
+
+/** Process replies and retry or time out pending queries */
+void FSessionDirectoryClient::Tick()
+{
+	if (!Socket)
+	{
+		return;
+	}
+
+	// Process replies
+	const TSharedRef<FInternetAddr> Sender = ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM)->CreateInternetAddr();
+	FString Message;
+	while (SessionDirectoryProtocol::ReceiveMessage(Socket, ReceiveBuffer, Message, *Sender))
+	{
+		TArray<FString> Lines;
+		Message.ParseIntoArray(Lines, TEXT("\n"), true);
+		if (Lines.IsEmpty())
+		{
+			continue;
+		}
+
+		const TArray<FString> Header = SessionDirectoryProtocol::SplitLine(Lines[0]);
+		if (Header.Num() < 2 || Header[0] != SessionDirectoryProtocol::Results)
+		{
+			continue;
+		}
+
+		int32 RequestId = 0;
+		LexFromString(RequestId, *Header[1]);
+
+		// Replies to retried or timed out queries are ignored
+		FPendingQuery Query;
+		if (!PendingQueries.RemoveAndCopyValue(RequestId, Query))
+		{
+			continue;
+		}
+
+		TArray<FSessionDirectoryEntry> Entries;
+		Entries.Reserve(Lines.Num() - 1);
+		for (int32 LineIndex = 1; LineIndex < Lines.Num(); ++LineIndex)
+		{
+			FSessionDirectoryEntry Entry;
+			if (SessionDirectoryProtocol::DecodeEntry(SessionDirectoryProtocol::SplitLine(Lines[LineIndex]), 0, Entry))
+			{
+				Entries.Add(MoveTemp(Entry));
+			}
+		}
+
+		Query.OnComplete.ExecuteIfBound(Entries, true);
+	}
+
+	// Retry or time out pending queries
+	const double CurrentTime = FPlatformTime::Seconds();
+	TArray<int32> TimedOutRequestIds;
+	for (TPair<int32, FPendingQuery>& Pair : PendingQueries)
+	{
+		FPendingQuery& Query = Pair.Value;
+		if (CurrentTime - Query.StartTime > QueryTimeout)
+		{
+			TimedOutRequestIds.Add(Pair.Key);
+		}
+		else if (CurrentTime - Query.LastSendTime > QueryRetryInterval)
+		{
+			Query.LastSendTime = CurrentTime;
+			Send(Query.Message);
+		}
+	}
+
+	for (const int32 RequestId : TimedOutRequestIds)
+	{
+		FPendingQuery Query;
+		PendingQueries.RemoveAndCopyValue(RequestId, Query);
+		Query.OnComplete.ExecuteIfBound(TArray<FSessionDirectoryEntry>(), false);
+	}
+}
+
+/** Send message to the directory */
+void FSessionDirectoryClient::Send(const FString& Message) const
+{
+	if (Socket && DirectoryAddr.IsValid())
+	{
+		SessionDirectoryProtocol::SendMessage(Socket, Message, *DirectoryAddr);
+	}
+}
+
+#pragma endregion DIRECTORY
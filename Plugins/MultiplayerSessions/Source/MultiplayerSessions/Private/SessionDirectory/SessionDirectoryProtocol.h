@@ -0,0 +1,118 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+// Unreal Engine
+#include "CoreMinimal.h"
+#include "IPAddress.h"
+#include "Sockets.h"
+
+// MultiplayerSessions
+#include "SessionDirectory/SessionDirectoryEntry.h"
+
+/**
+ * Wire format shared by the session directory server and client.
+ * Every datagram is a single UTF-8 message: one header line followed by zero or more entry lines, with tab separated fields.
+ */
+namespace SessionDirectoryProtocol
+{
+	/** Port used by the session directory when none is specified */
+	constexpr int32 DefaultPort = 7788;
+
+	/** Maximum size of a datagram sent by either side */
+	constexpr int32 MaxDatagramSize = 60000;
+
+	/** Message types */
+	constexpr const TCHAR* Register = TEXT("REG");
+	constexpr const TCHAR* Heartbeat = TEXT("HB");
+	constexpr const TCHAR* Unregister = TEXT("UNREG");
+	constexpr const TCHAR* Query = TEXT("QUERY");
+	constexpr const TCHAR* Results = TEXT("RESULTS");
+
+	/** Replace separators in a field, so it can't break the message's layout */
+	inline FString SanitizeField(const FString& Field)
+	{
+		return Field.Replace(TEXT("\t"), TEXT(" ")).Replace(TEXT("\n"), TEXT(" "));
+	}
+
+	/** Build a message line out of its fields */
+	inline FString MakeLine(std::initializer_list<FString> Fields)
+	{
+		FString Line;
+		for (const FString& Field : Fields)
+		{
+			if (!Line.IsEmpty())
+			{
+				Line.AppendChar(TEXT('\t'));
+			}
+			Line.Append(SanitizeField(Field));
+		}
+		return Line;
+	}
+
+	/** Encode entry as a message line */
+	inline FString EncodeEntry(const FSessionDirectoryEntry& Entry)
+	{
+		return MakeLine({ Entry.SessionId, Entry.MatchType, Entry.Address, LexToString(Entry.NumOpenPublicConnections), LexToString(Entry.NumPublicConnections), LexToString(Entry.BuildFingerprint), LexToString(Entry.BeaconPort) });
+	}
+
+	/** Decode entry from the fields of a message line, starting at FirstField */
+	inline bool DecodeEntry(const TArray<FString>& Fields, int32 FirstField, FSessionDirectoryEntry& OutEntry)
+	{
+		if (Fields.Num() < FirstField + 7)
+		{
+			return false;
+		}
+
+		OutEntry.SessionId = Fields[FirstField];
+		OutEntry.MatchType = Fields[FirstField + 1];
+		OutEntry.Address = Fields[FirstField + 2];
+		LexFromString(OutEntry.NumOpenPublicConnections, *Fields[FirstField + 3]);
+		LexFromString(OutEntry.NumPublicConnections, *Fields[FirstField + 4]);
+		LexFromString(OutEntry.BuildFingerprint, *Fields[FirstField + 5]);
+		LexFromString(OutEntry.BeaconPort, *Fields[FirstField + 6]);
+		return !OutEntry.SessionId.IsEmpty();
+	}
+
+	/** Split a message line into its fields */
+	inline TArray<FString> SplitLine(const FString& Line)
+	{
+		TArray<FString> Fields;
+		Line.ParseIntoArray(Fields, TEXT("\t"), false);
+		return Fields;
+	}
+
+	/** Send message to the given address */
+	inline bool SendMessage(FSocket* Socket, const FString& Message, const FInternetAddr& Destination)
+	{
+		if (!Socket)
+		{
+			return false;
+		}
+
+		const FTCHARToUTF8 Converter(*Message);
+		int32 BytesSent = 0;
+		return Socket->SendTo(reinterpret_cast<const uint8*>(Converter.Get()), Converter.Length(), BytesSent, Destination) && BytesSent == Converter.Length();
+	}
+
+	/** Receive next pending message, if any, storing its sender */
+	inline bool ReceiveMessage(FSocket* Socket, TArray<uint8>& Buffer, FString& OutMessage, FInternetAddr& OutSender)
+	{
+		uint32 PendingDataSize = 0;
+		if (!Socket || !Socket->HasPendingData(PendingDataSize))
+		{
+			return false;
+		}
+
+		Buffer.SetNumUninitialized(FMath::Max<int32>(MaxDatagramSize, PendingDataSize), false);
+		int32 BytesRead = 0;
+		if (!Socket->RecvFrom(Buffer.GetData(), Buffer.Num(), BytesRead, OutSender) || BytesRead <= 0)
+		{
+			return false;
+		}
+
+		const FUTF8ToTCHAR Converter(reinterpret_cast<const ANSICHAR*>(Buffer.GetData()), BytesRead);
+		OutMessage = FString(Converter.Length(), Converter.Get());
+		return true;
+	}
+}
@@ -0,0 +1,256 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "SessionDirectory/SessionDirectoryServer.h"
+
+// Unreal Engine
+#include "Common/UdpSocketBuilder.h"
+#include "SocketSubsystem.h"
+
+// MultiplayerSessions
+#include "MultiplayerSessions.h"
+#include "SessionDirectory/SessionDirectoryProtocol.h"
+
+#pragma region INITIALIZATION
+
+/** Destructor */
+FSessionDirectoryServer::~FSessionDirectoryServer()
+{
+	Stop();
+}
+
+/** Start listening for directory requests on the given port */
+bool FSessionDirectoryServer::Start(int32 Port)
+{
+	Stop();
+
+	Socket = FUdpSocketBuilder(TEXT("SessionDirectoryServer"))
+		.AsNonBlocking()
+		.AsReusable()
+		.BoundToAddress(FIPv4Address::Any)
+		.BoundToPort(Port)
+		.WithReceiveBufferSize(2 * 1024 * 1024)
+		.WithSendBufferSize(2 * 1024 * 1024)
+		.Build();
+
+	if (!Socket)
+	{
+		UE_LOG(LogMultiplayerSessions, Error, TEXT("Session directory couldn't bind port %d"), Port);
+		return false;
+	}
+
+	UE_LOG(LogMultiplayerSessions, Log, TEXT("Session directory listening on port %d"), Port);
+	return true;
+}
+
+/** Stop listening for directory requests */
+void FSessionDirectoryServer::Stop()
+{
+	if (Socket)
+	{
+		Socket->Close();
+		ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM)->DestroySocket(Socket);
+		Socket = nullptr;
+	}
+}
+
+#pragma endregion INITIALIZATION
+
+#pragma region DIRECTORY
+
+/** Wait up to WaitTime seconds for requests, process all pending ones and expire stale sessions */
+void FSessionDirectoryServer::Tick(float WaitTime)
+{
+	if (Socket && Socket->Wait(ESocketWaitConditions::WaitForRead, FTimespan::FromSeconds(WaitTime)))
+	{
+		const TSharedRef<FInternetAddr> Sender = ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM)->CreateInternetAddr();
+		FString Message;
+		while (SessionDirectoryProtocol::ReceiveMessage(Socket, ReceiveBuffer, Message, *Sender))
+		{
+			HandleMessage(Message, *Sender);
+		}
+	}
+
+	ExpireSessions();
+}
+
+/** Register session, or update it if already registered */
+void FSessionDirectoryServer::RegisterSession(const FSessionDirectoryEntry& Entry)
+{
+	// Match type may have changed, so remove the old index entry
+	if (const FSessionDirectoryEntry* ExistingEntry = Entries.Find(Entry.SessionId))
+	{
+		if (TSet<FString>* SessionIds = SessionIdsByMatchType.Find(ExistingEntry->MatchType))
+		{
+			SessionIds->Remove(Entry.SessionId);
+			if (SessionIds->IsEmpty())
+			{
+				SessionIdsByMatchType.Remove(ExistingEntry->MatchType);
+			}
+		}
+	}
+
+	FSessionDirectoryEntry& NewEntry = Entries.Add(Entry.SessionId, Entry);
+	NewEntry.LastHeartbeatTime = FPlatformTime::Seconds();
+	SessionIdsByMatchType.FindOrAdd(Entry.MatchType).Add(Entry.SessionId);
+}
+
+/** Refresh session's heartbeat and number of open connections */
+bool FSessionDirectoryServer::HeartbeatSession(const FString& SessionId, int32 NumOpenPublicConnections)
+{
+	FSessionDirectoryEntry* Entry = Entries.Find(SessionId);
+	if (!Entry)
+	{
+		return false;
+	}
+
+	Entry->NumOpenPublicConnections = NumOpenPublicConnections;
+	Entry->LastHeartbeatTime = FPlatformTime::Seconds();
+	return true;
+}
+
+/** Remove session from directory */
+void FSessionDirectoryServer::UnregisterSession(const FString& SessionId)
+{
+	FSessionDirectoryEntry RemovedEntry;
+	if (!Entries.RemoveAndCopyValue(SessionId, RemovedEntry))
+	{
+		return;
+	}
+
+	if (TSet<FString>* SessionIds = SessionIdsByMatchType.Find(RemovedEntry.MatchType))
+	{
+		SessionIds->Remove(SessionId);
+		if (SessionIds->IsEmpty())
+		{
+			SessionIdsByMatchType.Remove(RemovedEntry.MatchType);
+		}
+	}
+}
+
+/** Find sessions with the given match type (any, if empty) and at least MinOpenPublicConnections open connections */
+void FSessionDirectoryServer::QuerySessions(const FString& MatchType, int32 MinOpenPublicConnections, int32 MaxResults, TArray<FSessionDirectoryEntry>& OutEntries) const
+{
+	OutEntries.Reset();
+	if (MaxResults <= 0)
+	{
+		return;
+	}
+
+	// Returns false once the result limit has been reached
+	auto AddIfMatching = [&](const FSessionDirectoryEntry& Entry)
+	{
+		if (OutEntries.Num() >= MaxResults)
+		{
+			return false;
+		}
+
+		if (Entry.NumOpenPublicConnections >= MinOpenPublicConnections)
+		{
+			OutEntries.Add(Entry);
+		}
+		return OutEntries.Num() < MaxResults;
+	};
+
+	if (MatchType.IsEmpty())
+	{
+		for (const TPair<FString, FSessionDirectoryEntry>& Pair : Entries)
+		{
+			if (!AddIfMatching(Pair.Value))
+			{
+				break;
+			}
+		}
+		return;
+	}
+
+	if (const TSet<FString>* SessionIds = SessionIdsByMatchType.Find(MatchType))
+	{
+		for (const FString& SessionId : *SessionIds)
+		{
+			if (!AddIfMatching(Entries.FindChecked(SessionId)))
+			{
+				break;
+			}
+		}
+	}
+}
+
+/** Remove sessions whose last heartbeat is older than the timeout */
+void FSessionDirectoryServer::ExpireSessions()
+{
+	const double ExpirationTime = FPlatformTime::Seconds() - HeartbeatTimeout;
+
+	TArray<FString> ExpiredSessionIds;
+	for (const TPair<FString, FSessionDirectoryEntry>& Pair : Entries)
+	{
+		if (Pair.Value.LastHeartbeatTime < ExpirationTime)
+		{
+			ExpiredSessionIds.Add(Pair.Key);
+		}
+	}
+
+	for (const FString& SessionId : ExpiredSessionIds)
+	{
+		UE_LOG(LogMultiplayerSessions, Verbose, TEXT("Session directory expired session %s"), *SessionId);
+		UnregisterSession(SessionId);
+	}
+}
+
+/** Handle a single request */
+void FSessionDirectoryServer::HandleMessage(const FString& Message, const FInternetAddr& Sender)
+{
+	const TArray<FString> Fields = SessionDirectoryProtocol::SplitLine(Message);
+	if (Fields.IsEmpty())
+	{
+		return;
+	}
+
+	const FString& MessageType = Fields[0];
+	if (MessageType == SessionDirectoryProtocol::Register)
+	{
+		FSessionDirectoryEntry Entry;
+		if (SessionDirectoryProtocol::DecodeEntry(Fields, 1, Entry))
+		{
+			RegisterSession(Entry);
+		}
+	}
+	else if (MessageType == SessionDirectoryProtocol::Heartbeat && Fields.Num() >= 3)
+	{
+		int32 NumOpenPublicConnections = 0;
+		LexFromString(NumOpenPublicConnections, *Fields[2]);
+		HeartbeatSession(Fields[1], NumOpenPublicConnections);
+	}
+	else if (MessageType == SessionDirectoryProtocol::Unregister && Fields.Num() >= 2)
+	{
+		UnregisterSession(Fields[1]);
+	}
+	else if (MessageType == SessionDirectoryProtocol::Query && Fields.Num() >= 5)
+	{
+		// Fields: request id, match type, minimum open connections, maximum results
+		int32 MinOpenPublicConnections = 0;
+		int32 MaxResults = 0;
+		LexFromString(MinOpenPublicConnections, *Fields[3]);
+		LexFromString(MaxResults, *Fields[4]);
+
+		TArray<FSessionDirectoryEntry> Results;
+		QuerySessions(Fields[2], MinOpenPublicConnections, MaxResults, Results);
+
+		// Reply with as many results as fit in a single datagram (UTF-8 takes at most 3 bytes per TCHAR)
+		FString Reply = SessionDirectoryProtocol::MakeLine({ SessionDirectoryProtocol::Results, Fields[1] });
+		for (const FSessionDirectoryEntry& Entry : Results)
+		{
+			const FString EntryLine = SessionDirectoryProtocol::EncodeEntry(Entry);
+			if (Reply.Len() + EntryLine.Len() + 1 > SessionDirectoryProtocol::MaxDatagramSize / 3)
+			{
+				break;
+			}
+
+			Reply.AppendChar(TEXT('\n'));
+			Reply.Append(EntryLine);
+		}
+
+		SessionDirectoryProtocol::SendMessage(Socket, Reply, Sender);
+	}
+}
+
+#pragma endregion DIRECTORY
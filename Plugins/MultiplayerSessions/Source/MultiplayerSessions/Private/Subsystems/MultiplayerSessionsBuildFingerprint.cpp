@@ -0,0 +1,125 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Subsystems/MultiplayerSessionsBuildFingerprint.h"
+
+// Unreal Engine
+#include "Misc/App.h"
+#include "Misc/NetworkVersion.h"
+#include "OnlineSessionSettings.h"
+
+#ifndef MULTIPLAYERSESSIONS_BUILD_FINGERPRINT
+#define MULTIPLAYERSESSIONS_BUILD_FINGERPRINT 0
+#endif
+
+namespace MultiplayerSessionsBuildFingerprint
+{
+	/** Checksum of what the engine's own net version check requires to match exactly: project, engine net protocol and compatible changelist */
+	static uint16 GetEngineNetworkChecksum()
+	{
+		uint32 Checksum = FCrc::StrCrc32(FApp::GetProjectName());
+		const uint32 EngineNetworkProtocolVersion = FNetworkVersion::GetEngineNetworkProtocolVersion();
+		const uint32 NetworkCompatibleChangelist = FNetworkVersion::GetNetworkCompatibleChangelist();
+		Checksum = FCrc::MemCrc32(&EngineNetworkProtocolVersion, sizeof(EngineNetworkProtocolVersion), Checksum);
+		Checksum = FCrc::MemCrc32(&NetworkCompatibleChangelist, sizeof(NetworkCompatibleChangelist), Checksum);
+		return static_cast<uint16>(Checksum ^ (Checksum >> 16));
+	}
+
+	/** Fingerprint of this build, generated at compile time from the net protocol, content and engine versions */
+	int32 GetLocalFingerprint()
+	{
+		return MULTIPLAYERSESSIONS_BUILD_FINGERPRINT;
+	}
+
+	/** Net protocol version the given fingerprint was generated from */
+	int32 GetNetProtocolVersion(int32 Fingerprint)
+	{
+		return Fingerprint >> 16;
+	}
+
+	/** Whether builds with the given fingerprints can play together: same build, or net protocol versions within the compatibility range */
+	bool AreCompatible(int32 Fingerprint, int32 OtherFingerprint, int32 CompatibilityRange)
+	{
+		if (Fingerprint == OtherFingerprint)
+		{
+			return true;
+		}
+
+		return CompatibilityRange > 0 && FMath::Abs(GetNetProtocolVersion(Fingerprint) - GetNetProtocolVersion(OtherFingerprint)) <= CompatibilityRange;
+	}
+
+	/** Advertise this build's fingerprint on the session, as its build unique id and as filterable settings */
+	void AdvertiseFingerprint(FOnlineSessionSettings& SessionSettings)
+	{
+		const int32 Fingerprint = GetLocalFingerprint();
+		SessionSettings.BuildUniqueId = Fingerprint;
+		SessionSettings.Set(SETTING_BUILDFINGERPRINT, Fingerprint, EOnlineDataAdvertisementType::ViaOnlineServiceAndPing);
+		SessionSettings.Set(SETTING_NETPROTOCOLVERSION, GetNetProtocolVersion(Fingerprint), EOnlineDataAdvertisementType::ViaOnlineServiceAndPing);
+	}
+
+	/** Have the backend only return sessions compatible with this build, as far as its query filters allow */
+	void AddQueryFilter(FOnlineSessionSearch& SessionSearch, int32 CompatibilityRange)
+	{
+		const int32 Fingerprint = GetLocalFingerprint();
+		if (CompatibilityRange <= 0)
+		{
+			SessionSearch.QuerySettings.Set(SETTING_BUILDFINGERPRINT, Fingerprint, EOnlineComparisonOp::Equals);
+			return;
+		}
+
+		// Only one comparison fits per setting, so the upper bound is checked when ranking results
+		SessionSearch.QuerySettings.Set(SETTING_NETPROTOCOLVERSION, GetNetProtocolVersion(Fingerprint) - CompatibilityRange, EOnlineComparisonOp::GreaterThanEquals);
+	}
+
+	/** Whether the search result is compatible with this build. Results that don't advertise a fingerprint are left to the reservation check */
+	bool IsSearchResultCompatible(const FOnlineSessionSearchResult& SearchResult, int32 CompatibilityRange)
+	{
+		int32 Fingerprint = 0;
+		if (!SearchResult.Session.SessionSettings.Get(SETTING_BUILDFINGERPRINT, Fingerprint))
+		{
+			return true;
+		}
+
+		return AreCompatible(GetLocalFingerprint(), Fingerprint, CompatibilityRange);
+	}
+
+	/** Make the engine's net version check agree with the compatibility range, so builds found compatible can also connect */
+	void ApplyNetworkCompatibility(int32 CompatibilityRange)
+	{
+		// Exact matches are left to the engine's own check, which also covers engine changes
+		if (CompatibilityRange <= 0)
+		{
+			return;
+		}
+
+		// Net version carries the net protocol version in its high bits, as the fingerprint does, and the engine's checksum in its low bits,
+		// so the range only relaxes the game's protocol check while engine net protocol and changelist mismatches are still refused
+		const uint32 NetworkVersion = (static_cast<uint32>(GetNetProtocolVersion(GetLocalFingerprint())) << 16) | GetEngineNetworkChecksum();
+		FNetworkVersion::GetLocalNetworkVersionOverride.BindLambda([NetworkVersion]()
+		{
+			return NetworkVersion;
+		});
+		FNetworkVersion::IsNetworkCompatibleOverride.BindLambda([CompatibilityRange](uint32 LocalNetworkVersion, uint32 RemoteNetworkVersion)
+		{
+			if ((LocalNetworkVersion & 0xFFFF) != (RemoteNetworkVersion & 0xFFFF))
+			{
+				return false;
+			}
+
+			return FMath::Abs(static_cast<int32>(LocalNetworkVersion >> 16) - static_cast<int32>(RemoteNetworkVersion >> 16)) <= CompatibilityRange;
+		});
+		FNetworkVersion::InvalidateNetworkChecksum();
+	}
+
+	/** Restore the engine's own net version check */
+	void ResetNetworkCompatibility()
+	{
+		if (!FNetworkVersion::GetLocalNetworkVersionOverride.IsBound() && !FNetworkVersion::IsNetworkCompatibleOverride.IsBound())
+		{
+			return;
+		}
+
+		FNetworkVersion::GetLocalNetworkVersionOverride.Unbind();
+		FNetworkVersion::IsNetworkCompatibleOverride.Unbind();
+		FNetworkVersion::InvalidateNetworkChecksum();
+	}
+}
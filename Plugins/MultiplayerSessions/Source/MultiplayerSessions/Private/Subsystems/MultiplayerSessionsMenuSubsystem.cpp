@@ -0,0 +1,77 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Subsystems/MultiplayerSessionsMenuSubsystem.h"
+
+// Unreal Engine
+#include "Blueprint/UserWidget.h"
+#include "Engine/GameInstance.h"
+
+// MultiplayerSessions
+#include "Menu/Menu.h"
+
+#pragma region INITIALIZATION
+
+/** Deinitialize subsystem */
+void UMultiplayerSessionsMenuSubsystem::Deinitialize()
+{
+	for (const TPair<TSubclassOf<UMenu>, TObjectPtr<UMenu>>& PooledMenu : PooledMenus)
+	{
+		if (PooledMenu.Value)
+		{
+			PooledMenu.Value->RemoveFromParent();
+		}
+	}
+	PooledMenus.Reset();
+
+	Super::Deinitialize();
+}
+
+#pragma endregion INITIALIZATION
+
+#pragma region MENU_POOL
+
+/** Show pooled menu of the given class, creating it on first use */
+UMenu* UMultiplayerSessionsMenuSubsystem::ShowMenu(TSubclassOf<UMenu> MenuClass, const FMultiplayerSessionSettings& MultiplayerSessionSettings)
+{
+	if (!MenuClass)
+	{
+		return nullptr;
+	}
+
+	TObjectPtr<UMenu>& Menu = PooledMenus.FindOrAdd(MenuClass);
+	if (!Menu)
+	{
+		Menu = CreateWidget<UMenu>(GetGameInstance(), MenuClass);
+		if (!Menu)
+		{
+			PooledMenus.Remove(MenuClass);
+			return nullptr;
+		}
+		Menu->MarkAsPooled();
+	}
+
+	for (const TPair<TSubclassOf<UMenu>, TObjectPtr<UMenu>>& PooledMenu : PooledMenus)
+	{
+		if (PooledMenu.Value && PooledMenu.Value != Menu)
+		{
+			PooledMenu.Value->HideMenu();
+		}
+	}
+
+	Menu->SetupMenu(MultiplayerSessionSettings);
+	return Menu;
+}
+
+/** Hide every pooled menu */
+void UMultiplayerSessionsMenuSubsystem::HideMenus()
+{
+	for (const TPair<TSubclassOf<UMenu>, TObjectPtr<UMenu>>& PooledMenu : PooledMenus)
+	{
+		if (PooledMenu.Value)
+		{
+			PooledMenu.Value->HideMenu();
+		}
+	}
+}
+
+#pragma endregion MENU_POOL
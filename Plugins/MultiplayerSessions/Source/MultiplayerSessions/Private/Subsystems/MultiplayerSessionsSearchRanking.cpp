@@ -0,0 +1,137 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Subsystems/MultiplayerSessionsSearchRanking.h"
+
+// Unreal Engine
+#include "Async/ParallelFor.h"
+#include "OnlineSessionSettings.h"
+
+// MultiplayerSessions
+#include "Subsystems/MultiplayerSessionsBuildFingerprint.h"
+
+namespace
+{
+	/** Minimum number of results a parallel chunk processes, so small searches don't pay for scheduling */
+	constexpr int32 MinResultsPerChunk = 256;
+
+	/** Width, in milliseconds, of the ping buckets sessions are ranked by */
+	constexpr int32 PingBucketSize = 25;
+
+	/** Search result decoded into the fields it's ranked by */
+	struct FRankedCandidate
+	{
+		/** Index of the result in the search results */
+		int32 Index = INDEX_NONE;
+
+		/** Ping bucket of the session's host */
+		int32 PingBucket = 0;
+
+		/** Number of public connections still available */
+		int32 NumOpenPublicConnections = 0;
+	};
+
+	/** Whether candidate A ranks before candidate B: closer hosts first, then fuller lobbies so they fill up before new ones */
+	bool IsBetterCandidate(const FRankedCandidate& A, const FRankedCandidate& B)
+	{
+		if (A.PingBucket != B.PingBucket)
+		{
+			return A.PingBucket < B.PingBucket;
+		}
+
+		if (A.NumOpenPublicConnections != B.NumOpenPublicConnections)
+		{
+			return A.NumOpenPublicConnections < B.NumOpenPublicConnections;
+		}
+
+		return A.Index < B.Index;
+	}
+}
+
+namespace MultiplayerSessionsSearchRanking
+{
+	/** Filter, score and sort search results in parallel, returning the best ones first. Safe to call off the game thread */
+	TArray<FOnlineSessionSearchResult> RankSearchResults(const TArray<FOnlineSessionSearchResult>& SearchResults, const FMultiplayerSessionsSearchFilter& Filter)
+	{
+		const int32 NumResults = SearchResults.Num();
+		const int32 MaxResults = FMath::Max(1, Filter.MaxResults);
+		if (NumResults == 0)
+		{
+			return TArray<FOnlineSessionSearchResult>();
+		}
+
+		const int32 NumChunks = FMath::Clamp(FMath::DivideAndRoundUp(NumResults, MinResultsPerChunk), 1, FMath::Max(1, FTaskGraphInterface::Get().GetNumWorkerThreads()));
+		const int32 ChunkSize = FMath::DivideAndRoundUp(NumResults, NumChunks);
+		const FName MatchTypeKey(TEXT("MatchType"));
+
+		// Heap ordering keeping the worst candidate on top, so it's the one dropped once a chunk holds more than MaxResults
+		const auto IsWorseCandidate = [](const FRankedCandidate& A, const FRankedCandidate& B)
+		{
+			return IsBetterCandidate(B, A);
+		};
+
+		// Each chunk keeps its own best candidates, so no locking is needed
+		TArray<TArray<FRankedCandidate>> ChunkCandidates;
+		ChunkCandidates.SetNum(NumChunks);
+		ParallelFor(NumChunks, [&](int32 ChunkIndex)
+		{
+			TArray<FRankedCandidate>& Candidates = ChunkCandidates[ChunkIndex];
+			Candidates.Reserve(MaxResults + 1);
+
+			const int32 FirstIndex = ChunkIndex * ChunkSize;
+			const int32 LastIndex = FMath::Min(FirstIndex + ChunkSize, NumResults);
+			FString MatchType;
+			for (int32 Index = FirstIndex; Index < LastIndex; ++Index)
+			{
+				const FOnlineSessionSearchResult& SearchResult = SearchResults[Index];
+				if (!Filter.bIncludeFullSessions && SearchResult.Session.NumOpenPublicConnections <= 0)
+				{
+					continue;
+				}
+
+				// Backends that can't filter on the build fingerprint still return incompatible sessions
+				if (!MultiplayerSessionsBuildFingerprint::IsSearchResultCompatible(SearchResult, Filter.BuildCompatibilityRange))
+				{
+					continue;
+				}
+
+				if (!Filter.MatchType.IsEmpty())
+				{
+					MatchType.Reset();
+					if (!SearchResult.Session.SessionSettings.Get(MatchTypeKey, MatchType) || !MatchType.Equals(Filter.MatchType))
+					{
+						continue;
+					}
+				}
+
+				FRankedCandidate Candidate;
+				Candidate.Index = Index;
+				Candidate.PingBucket = SearchResult.PingInMs / PingBucketSize;
+				Candidate.NumOpenPublicConnections = SearchResult.Session.NumOpenPublicConnections;
+
+				Candidates.HeapPush(Candidate, IsWorseCandidate);
+				if (Candidates.Num() > MaxResults)
+				{
+					Candidates.HeapPopDiscard(IsWorseCandidate, false);
+				}
+			}
+		});
+
+		// Merge chunks' best candidates, which are at most MaxResults per chunk
+		TArray<FRankedCandidate> Candidates;
+		Candidates.Reserve(NumChunks * MaxResults);
+		for (const TArray<FRankedCandidate>& Chunk : ChunkCandidates)
+		{
+			Candidates.Append(Chunk);
+		}
+		Candidates.Sort(&IsBetterCandidate);
+
+		TArray<FOnlineSessionSearchResult> RankedResults;
+		RankedResults.Reserve(FMath::Min(MaxResults, Candidates.Num()));
+		for (int32 Index = 0; Index < Candidates.Num() && Index < MaxResults; ++Index)
+		{
+			RankedResults.Add(SearchResults[Candidates[Index].Index]);
+		}
+
+		return RankedResults;
+	}
+}
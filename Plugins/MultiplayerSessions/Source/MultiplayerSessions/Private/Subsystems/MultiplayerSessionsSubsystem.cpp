@@ -5,28 +5,36 @@
 // Unreal Engine
 #include "OnlineSubsystem.h"
 #include "OnlineSessionSettings.h"
+#include "SocketSubsystem.h"
+#include "IPAddress.h"
+#include "OnlineBeaconHost.h"
+#include "Async/Async.h"
+#include "TimerManager.h"
+#include "Engine/GameInstance.h"
+#include "Engine/World.h"
+#include "Engine/NetDriver.h"
+#include "Engine/NetConnection.h"
+#include "Misc/CommandLine.h"
+#include "Misc/Parse.h"
+#include "Misc/Paths.h"
+
+// MultiplayerSessions
+#include "MultiplayerSessions.h"
+#include "SessionDirectory/SessionDirectoryClient.h"
+#include "Fleet/LobbyFleetClient.h"
+#include "Subsystems/MultiplayerSessionsSearchRanking.h"
+#include "Subsystems/MultiplayerSessionsBuildFingerprint.h"
+#include "Beacons/MultiplayerSessionsBeaconHostObject.h"
+#include "Trace/MultiplayerSessionsTraceRecorder.h"
+#include "Trace/MultiplayerSessionsTracePlayer.h"
+#include "SearchSnapshot/MultiplayerSessionsSearchSnapshot.h"
 
 #pragma region INITIALIZATION
 	
-/** Constructor */
-UMultiplayerSessionsSubsystem::UMultiplayerSessionsSubsystem()
+/** Initialize subsystem */
+void UMultiplayerSessionsSubsystem::Initialize(FSubsystemCollectionBase& Collection)
 {
-	/** Initialize online subsystem */
-	if (const IOnlineSubsystem* Subsystem = IOnlineSubsystem::Get())
-	{
-		SessionInterface = Subsystem->GetSessionInterface();
-
-		// Debug
-		if (GEngine)
-		{
-			GEngine->AddOnScreenDebugMessage(
-				INDEX_NONE,
-				15.f,
-				FColor::Blue,
-				FString::Printf(TEXT("Found subsystem %s"), *Subsystem->GetSubsystemName().ToString())
-			);
-		}
-	}
+	Super::Initialize(Collection);
 
 	// Create delegates
 	CreateSessionCompleteDelegate = FOnCreateSessionCompleteDelegate::CreateUObject(this, &UMultiplayerSessionsSubsystem::OnCreateSessionComplete);
@@ -34,6 +42,166 @@ UMultiplayerSessionsSubsystem::UMultiplayerSessionsSubsystem()
 	JoinSessionCompleteDelegate = FOnJoinSessionCompleteDelegate::CreateUObject(this, &UMultiplayerSessionsSubsystem::OnJoinSessionComplete);
 	StartSessionCompleteDelegate = FOnStartSessionCompleteDelegate::CreateUObject(this, &UMultiplayerSessionsSubsystem::OnStartSessionComplete);
 	DestroySessionCompleteDelegate = FOnDestroySessionCompleteDelegate::CreateUObject(this, &UMultiplayerSessionsSubsystem::OnDestroySessionComplete);
+
+	// Warm up online subsystem on the next tick, so it doesn't delay the game instance's startup
+	WarmUpTickerHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateUObject(this, &UMultiplayerSessionsSubsystem::WarmUpOnlineSubsystem));
+
+	// Start reservation beacon host whenever the hosted session's map is loaded
+	PostLoadMapDelegateHandle = FCoreUObjectDelegates::PostLoadMapWithWorld.AddUObject(this, &UMultiplayerSessionsSubsystem::OnPostLoadMapWithWorld);
+
+	// Detect the host leaving, for migrating the session to a successor
+	if (GEngine)
+	{
+		NetworkFailureDelegateHandle = GEngine->OnNetworkFailure().AddUObject(this, &UMultiplayerSessionsSubsystem::OnNetworkFailure);
+	}
+
+	// Connect to session directory, if configured
+	if (!SessionDirectoryAddress.IsEmpty())
+	{
+		SessionDirectoryClient = MakeShared<FSessionDirectoryClient>();
+		if (SessionDirectoryClient->Connect(SessionDirectoryAddress))
+		{
+			SessionDirectoryTickerHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateUObject(this, &UMultiplayerSessionsSubsystem::TickSessionDirectory));
+		}
+		else
+		{
+			SessionDirectoryClient.Reset();
+		}
+	}
+
+	// Connect to lobby fleet, if configured. Its own servers create their lobbies themselves
+	if (!LobbyFleetAddress.IsEmpty() && !IsRunningDedicatedServer())
+	{
+		LobbyFleetClient = MakeShared<FLobbyFleetClient>();
+		if (LobbyFleetClient->Connect(LobbyFleetAddress))
+		{
+			LobbyFleetTickerHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateUObject(this, &UMultiplayerSessionsSubsystem::TickLobbyFleet));
+		}
+		else
+		{
+			LobbyFleetClient.Reset();
+		}
+	}
+
+	StartSessionTrace();
+	LoadSearchSnapshot();
+
+	// Builds within the compatibility range must also pass the engine's net version check once they travel
+	MultiplayerSessionsBuildFingerprint::ApplyNetworkCompatibility(BuildCompatibilityRange);
+}
+
+/** Deinitialize subsystem */
+void UMultiplayerSessionsSubsystem::Deinitialize()
+{
+	FTSTicker::GetCoreTicker().RemoveTicker(WarmUpTickerHandle);
+	WarmUpTickerHandle.Reset();
+
+	FCoreUObjectDelegates::PostLoadMapWithWorld.Remove(PostLoadMapDelegateHandle);
+	if (GEngine)
+	{
+		GEngine->OnNetworkFailure().Remove(NetworkFailureDelegateHandle);
+	}
+	ResetHostMigration();
+	StopHostMigrationRoster();
+
+	if (bIsQuickMatchInProgress)
+	{
+		GetGameInstance()->GetTimerManager().ClearTimer(QuickMatchTimerHandle);
+		bIsQuickMatchInProgress = false;
+	}
+
+	// Fail requests still waiting, so their futures aren't left unfulfilled
+	CreateSessionRequests.Reset(false);
+	FindSessionsRequests.Reset(FMultiplayerFindSessionsResult());
+	JoinSessionRequests.Reset(EOnJoinSessionCompleteResult::UnknownError);
+	StartSessionRequests.Reset(false);
+	DestroySessionRequests.Reset(false);
+	StopReservationBeaconHost();
+	DestroyReservationBeaconClient();
+	ReservationCandidates.Reset();
+
+	UnregisterDirectorySession();
+	FTSTicker::GetCoreTicker().RemoveTicker(SessionDirectoryTickerHandle);
+	SessionDirectoryTickerHandle.Reset();
+	SessionDirectoryClient.Reset();
+
+	FTSTicker::GetCoreTicker().RemoveTicker(LobbyFleetTickerHandle);
+	LobbyFleetTickerHandle.Reset();
+	LobbyFleetClient.Reset();
+
+	StopSessionTrace();
+
+	CancelBackendSearches();
+	SessionSearchPool.Empty();
+	ReleaseJoinTargets();
+	JoinedSessionInterface.Reset();
+	DestroyingSessionInterface.Reset();
+
+	SessionInterface.Reset();
+	bIsOnlineSubsystemReady = false;
+
+	if (BuildCompatibilityRange > 0)
+	{
+		MultiplayerSessionsBuildFingerprint::ResetNetworkCompatibility();
+	}
+
+	Super::Deinitialize();
+}
+
+/** Ticker callback used for warming up the online subsystem outside of the subsystem's initialization */
+bool UMultiplayerSessionsSubsystem::WarmUpOnlineSubsystem(float DeltaTime)
+{
+	WarmUpTickerHandle.Reset();
+	InitializeOnlineSubsystem();
+
+	// Don't tick again
+	return false;
+}
+
+/** Get online subsystem and session interface, if they weren't already */
+bool UMultiplayerSessionsSubsystem::InitializeOnlineSubsystem()
+{
+	if (bIsOnlineSubsystemReady)
+	{
+		return SessionInterface.IsValid();
+	}
+
+	// Subsystem was requested on demand before the warm up tick, so it's not needed anymore
+	if (WarmUpTickerHandle.IsValid())
+	{
+		FTSTicker::GetCoreTicker().RemoveTicker(WarmUpTickerHandle);
+		WarmUpTickerHandle.Reset();
+	}
+
+	/** Initialize online subsystem */
+	const IOnlineSubsystem* Subsystem = IOnlineSubsystem::Get();
+	SessionInterface = Subsystem ? Subsystem->GetSessionInterface() : nullptr;
+	if (!SessionInterface.IsValid())
+	{
+		// Online subsystem may still be starting up (e.g. the Steam client isn't running yet), so it's tried again before reporting the failure
+		if (NumOnlineSubsystemRetries < MaxOnlineSubsystemRetries)
+		{
+			++NumOnlineSubsystemRetries;
+			UE_LOG(LogMultiplayerSessions, Warning, TEXT("Online subsystem isn't available, retrying in %.1fs (%d/%d)"), OnlineSubsystemRetryDelay, NumOnlineSubsystemRetries, MaxOnlineSubsystemRetries);
+			WarmUpTickerHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateUObject(this, &UMultiplayerSessionsSubsystem::WarmUpOnlineSubsystem), OnlineSubsystemRetryDelay);
+		}
+		else
+		{
+			// Requests made from now on try again on demand
+			UE_LOG(LogMultiplayerSessions, Error, TEXT("Online subsystem isn't available after %d retries"), MaxOnlineSubsystemRetries);
+			NumOnlineSubsystemRetries = 0;
+			MultiplayerOnSubsystemReadyDelegate.Broadcast(false);
+		}
+		return false;
+	}
+
+	OnlineSubsystemName = Subsystem->GetSubsystemName();
+	UE_LOG(LogMultiplayerSessions, Log, TEXT("Found online subsystem %s"), *OnlineSubsystemName.ToString());
+
+	bIsOnlineSubsystemReady = true;
+	NumOnlineSubsystemRetries = 0;
+	MultiplayerOnSubsystemReadyDelegate.Broadcast(true);
+	return true;
 }
 
 #pragma endregion INITIALIZATION
@@ -41,108 +209,325 @@ UMultiplayerSessionsSubsystem::UMultiplayerSessionsSubsystem()
 #pragma region SESSION
 
 /** Create session */
-void UMultiplayerSessionsSubsystem::CreateSession(int32 NumPublicConnections, FString MatchType)
+void UMultiplayerSessionsSubsystem::CreateSession(int32 NumPublicConnections, const FString& MatchType)
 {
-	if (!SessionInterface.IsValid())
+	// Direct calls go through the same queue as future based ones, so their completion is never reported to another request in flight
+	CreateSessionAsync(NumPublicConnections, MatchType);
+}
+
+/** Create session on behalf of the future based request with the given token, 0 for requests made on behalf of another one */
+void UMultiplayerSessionsSubsystem::IssueCreateSession(int32 NumPublicConnections, const FString& MatchType, uint32 RequestToken)
+{
+	BeginOperationTiming(EMultiplayerSessionsTraceOperation::CreateSession);
+
+	// Completions reported by the session interface belong to the future based request in flight, if any
+	if (RequestToken != 0)
+	{
+		CreateSessionRequestToken = RequestToken;
+	}
+
+	if (IsReplayingSessionTrace())
+	{
+		ReplaySessionRequest(EMultiplayerSessionsTraceOperation::CreateSession);
+		return;
+	}
+
+	// Have one of the lobby fleet's servers host the session, which players then travel to
+	FleetLobbyAddress.Reset();
+	if (IsUsingLobbyFleet())
+	{
+		TMap<FString, FString> Parameters;
+		Parameters.Add(TEXT("NumPublicConnections"), LexToString(NumPublicConnections));
+		Parameters.Add(TEXT("MatchType"), MatchType);
+		Parameters.Add(TEXT("LobbyFleetAddress"), LobbyFleetAddress);
+		RecordSessionRequest(EMultiplayerSessionsTraceOperation::CreateSession, MoveTemp(Parameters));
+		LobbyFleetClient->RequestLobby(MatchType, NumPublicConnections, FOnLobbyFleetRequestComplete::CreateUObject(this, &UMultiplayerSessionsSubsystem::OnLobbyFleetRequestComplete));
+		return;
+	}
+
+	if (!InitializeOnlineSubsystem())
 	{
+		CompleteCreateSession(false, RequestToken);
 		return;
 	}
 
 	// Destroy existing session, if any
-	if (SessionInterface->GetNamedSession(NAME_GameSession))
+	if (GetActiveSessionInterface()->GetNamedSession(NAME_GameSession))
 	{
 		bCreateSessionOnDestroy = true;
 		LastMultiplayerSessionSettings.NumPublicConnections = NumPublicConnections;
 		LastMultiplayerSessionSettings.MatchType = MatchType;
-		DestroySession();
+		// Destroying is part of this create request, so it's issued right away rather than queued behind other destroy requests
+		IssueDestroySession(0);
+		return;
 	}
 
 	// Add delegate to list of delegates to call on create session complete, and store its handle
 	CreateSessionCompleteDelegateHandle = SessionInterface->AddOnCreateSessionCompleteDelegate_Handle(CreateSessionCompleteDelegate);
 
 	// Setup session's settings
-	LastSessionSettings = MakeShareable(new FOnlineSessionSettings());
+	ResetSessionSettings();
 	LastSessionSettings->NumPublicConnections = NumPublicConnections;
-	LastSessionSettings->BuildUniqueId = 1;
-	LastSessionSettings->bIsLANMatch = IOnlineSubsystem::Get()->GetSubsystemName() == "NULL" ? true : false;
+	LastSessionSettings->NumPrivateConnections = NumSpectatorSlots;
+	MultiplayerSessionsBuildFingerprint::AdvertiseFingerprint(*LastSessionSettings);
+	LastSessionSettings->bIsLANMatch = OnlineSubsystemName == "NULL";
+	LastSessionSettings->bIsDedicated = IsRunningDedicatedServer();
 	LastSessionSettings->bAllowJoinInProgress = true;
-	LastSessionSettings->bAllowJoinViaPresence = true;
+	LastSessionSettings->bAllowJoinViaPresence = !LastSessionSettings->bIsDedicated;
 	LastSessionSettings->bShouldAdvertise = true;
-	LastSessionSettings->bUsesPresence = true;
-	LastSessionSettings->bUseLobbiesIfAvailable = true;
+	LastSessionSettings->bUsesPresence = !LastSessionSettings->bIsDedicated;
+	LastSessionSettings->bUseLobbiesIfAvailable = !LastSessionSettings->bIsDedicated;
 	LastSessionSettings->Set(FName("MatchType"), MatchType, EOnlineDataAdvertisementType::ViaOnlineServiceAndPing);
+	if (IsUsingMultiBackendSearch())
+	{
+		LastSessionSettings->Set(SETTING_SESSIONKEY, FGuid::NewGuid().ToString(EGuidFormats::Digits), EOnlineDataAdvertisementType::ViaOnlineServiceAndPing);
+	}
+	if (bUseReservationBeacon)
+	{
+		LastSessionSettings->Set(SETTING_BEACONPORT, GetBeaconListenPort(), EOnlineDataAdvertisementType::ViaOnlineService);
+	}
 
 	// Create session
-	if (const ULocalPlayer* LocalPlayer = GetWorld()->GetFirstLocalPlayerFromController())
+	// Dedicated servers have no local player, so they create the session as the first local user
+	RecordSessionRequest(EMultiplayerSessionsTraceOperation::CreateSession, FMultiplayerSessionsTrace::MakeSettingsParameters(*LastSessionSettings));
+	const ULocalPlayer* LocalPlayer = GetWorld()->GetFirstLocalPlayerFromController();
+	const bool bIsCreating = LastSessionSettings->bIsDedicated
+		? SessionInterface->CreateSession(0, NAME_GameSession, *LastSessionSettings)
+		: LocalPlayer && SessionInterface->CreateSession(*LocalPlayer->GetPreferredUniqueNetId(), NAME_GameSession, *LastSessionSettings);
+	if (!bIsCreating)
 	{
-		if (!SessionInterface->CreateSession(*LocalPlayer->GetPreferredUniqueNetId(), NAME_GameSession, *LastSessionSettings))
-		{
-			// Clear delegate handle if creating session failed
-			SessionInterface->ClearOnCreateSessionCompleteDelegate_Handle(CreateSessionCompleteDelegateHandle);
-			MultiplayerOnCreateSessionCompleteDelegate.Broadcast(false);
-		}
+		// Clear delegate handle if creating session failed
+		SessionInterface->ClearOnCreateSessionCompleteDelegate_Handle(CreateSessionCompleteDelegateHandle);
+		RecordSessionResult(EMultiplayerSessionsTraceOperation::CreateSession, false);
+		CompleteCreateSession(false, RequestToken);
 	}
 }
 	
-/** Find sessions */
-void UMultiplayerSessionsSubsystem::FindSessions(int32 MaxSearchResults)
+/** Find sessions, keeping the best ranked ones of the given match type (any match type if empty). Searches for spectators keep full sessions too */
+void UMultiplayerSessionsSubsystem::FindSessions(int32 MaxSearchResults, const FString& MatchType, bool bForSpectators)
 {
-	if (!SessionInterface.IsValid())
+	// Direct calls go through the same queue as future based ones, so their completion is never reported to another request in flight
+	FindSessionsAsync(MaxSearchResults, MatchType, bForSpectators);
+}
+
+/** Find sessions on behalf of the future based request with the given token, 0 for requests made on behalf of another one */
+void UMultiplayerSessionsSubsystem::IssueFindSessions(int32 MaxSearchResults, const FString& MatchType, bool bForSpectators, uint32 RequestToken)
+{
+	BeginOperationTiming(EMultiplayerSessionsTraceOperation::FindSessions);
+
+	// Completions reported by the session interface belong to the future based request in flight, if any
+	if (RequestToken != 0)
+	{
+		FindSessionsRequestToken = RequestToken;
+	}
+
+	LastSearchMatchType = MatchType;
+	LastSearchMaxResults = MaxSearchResults;
+	bLastSearchForSpectators = bForSpectators;
+
+	if (IsReplayingSessionTrace())
+	{
+		ReplaySessionRequest(EMultiplayerSessionsTraceOperation::FindSessions);
+		return;
+	}
+
+	if (!InitializeOnlineSubsystem())
+	{
+		CompleteFindSessions(TArray<FOnlineSessionSearchResult>(), false, RequestToken);
+		return;
+	}
+
+	// Answer the first search straight away with the last run's sessions, confirming or replacing them in the background
+	bIsRefreshingSearchSnapshot = false;
+	if (ServeSearchSnapshot(MaxSearchResults, MatchType))
+	{
+		bIsRefreshingSearchSnapshot = true;
+		SearchSnapshotServeTime = FPlatformTime::Seconds();
+	}
+
+	// Search session settings' setup. Last search is released first, so it can be reused for this one
+	LastSessionSearch.Reset();
+	LastSessionSearch = AcquireSessionSearch(MaxSearchResults);
+
+	// Find sessions through the session directory, skipping the online subsystem's search
+	if (IsUsingSessionDirectory())
+	{
+		TMap<FString, FString> Parameters;
+		Parameters.Add(TEXT("MaxSearchResults"), LexToString(MaxSearchResults));
+		Parameters.Add(TEXT("MatchType"), MatchType);
+		Parameters.Add(TEXT("ForSpectators"), LexToString(bForSpectators));
+		Parameters.Add(TEXT("SessionDirectoryAddress"), SessionDirectoryAddress);
+		RecordSessionRequest(EMultiplayerSessionsTraceOperation::FindSessions, MoveTemp(Parameters));
+
+		// Spectators watch from private slots, so sessions with no open public connection left are still theirs to join
+		SessionDirectoryClient->QuerySessions(MatchType, bForSpectators ? 0 : 1, MaxSearchResults, FOnSessionDirectoryQueryComplete::CreateUObject(this, &UMultiplayerSessionsSubsystem::OnDirectoryQueryComplete));
+		return;
+	}
+
+	// Find sessions on every configured backend at once
+	if (IsUsingMultiBackendSearch())
 	{
+		FindSessionsOnBackends(MaxSearchResults);
 		return;
 	}
 
 	// Add delegate to list of delegates to call on find sessions complete, and store its handle
 	FindSessionsCompleteDelegateHandle = SessionInterface->AddOnFindSessionsCompleteDelegate_Handle(FindSessionsCompleteDelegate);
 
-	// Search session settings' setup
-	LastSessionSearch = MakeShareable(new FOnlineSessionSearch());
-	LastSessionSearch->MaxSearchResults = MaxSearchResults;
-	LastSessionSearch->bIsLanQuery = IOnlineSubsystem::Get()->GetSubsystemName() == "NULL" ? true : false;
+	LastSessionSearch->bIsLanQuery = OnlineSubsystemName == "NULL";
 	LastSessionSearch->QuerySettings.Set(SEARCH_PRESENCE, true, EOnlineComparisonOp::Equals);
+	MultiplayerSessionsBuildFingerprint::AddQueryFilter(*LastSessionSearch, BuildCompatibilityRange);
 
 	// Find sessions
-	if (const ULocalPlayer* LocalPlayer = GetWorld()->GetFirstLocalPlayerFromController())
+	RecordSessionRequest(EMultiplayerSessionsTraceOperation::FindSessions, FMultiplayerSessionsTrace::MakeSearchParameters(*LastSessionSearch));
+	const ULocalPlayer* LocalPlayer = GetWorld()->GetFirstLocalPlayerFromController();
+	if (!LocalPlayer || !SessionInterface->FindSessions(*LocalPlayer->GetPreferredUniqueNetId(), LastSessionSearch.ToSharedRef()))
+	{
+		// Clear delegate handle if finding sessions failed
+		SessionInterface->ClearOnFindSessionsCompleteDelegate_Handle(FindSessionsCompleteDelegateHandle);
+		RecordSessionResult(EMultiplayerSessionsTraceOperation::FindSessions, false);
+		CompleteFindSessions(TArray<FOnlineSessionSearchResult>(), false, RequestToken);
+	}
+}
+
+/** Join session, as a spectator watching from one of its private slots if asked to */
+void UMultiplayerSessionsSubsystem::JoinSession(const FOnlineSessionSearchResult& SessionResult, bool bAsSpectator)
+{
+	// Direct calls go through the same queue as future based ones, so their completion is never reported to another request in flight
+	JoinSessionAsync(SessionResult, bAsSpectator);
+}
+
+/** Join session on behalf of the future based request with the given token, 0 for requests made on behalf of another one */
+void UMultiplayerSessionsSubsystem::IssueJoinSession(const FOnlineSessionSearchResult& SessionResult, bool bAsSpectator, uint32 RequestToken)
+{
+	BeginOperationTiming(EMultiplayerSessionsTraceOperation::JoinSession);
+
+	// Completions reported by the session interface belong to the future based request in flight, if any
+	if (RequestToken != 0)
+	{
+		JoinSessionRequestToken = RequestToken;
+	}
+
+	bJoinAsSpectator = bAsSpectator;
+
+	if (IsReplayingSessionTrace())
+	{
+		ReplaySessionRequest(EMultiplayerSessionsTraceOperation::JoinSession);
+		return;
+	}
+
+	if (!InitializeOnlineSubsystem())
+	{
+		CompleteJoinSession(EOnJoinSessionCompleteResult::UnknownError, RequestToken);
+		return;
+	}
+
+	// Reserve a slot before joining, trying candidates in order while a reservation is already in progress
+	// Reservations only cover public slots, spectators being admitted by the host against its spectator capacity instead
+	if (bUseReservationBeacon && !bAsSpectator)
 	{
-		if (!SessionInterface->FindSessions(*LocalPlayer->GetPreferredUniqueNetId(), LastSessionSearch.ToSharedRef()))
+		ReservationCandidates.Add(SessionResult);
+		if (!ReservationBeaconClient.IsValid())
 		{
-			// Clear delegate handle if finding sessions failed
-			SessionInterface->ClearOnFindSessionsCompleteDelegate_Handle(FindSessionsCompleteDelegateHandle);
-			MultiplayerOnFindSessionsCompleteDelegate.Broadcast(TArray<FOnlineSessionSearchResult>(), false);
+			LastReservationResult = EMultiplayerReservationResult::Success;
+			TryNextReservationCandidate();
 		}
+		return;
 	}
+
+	PrepareJoinTarget(SessionResult);
+	JoinReservedSession(SessionResult);
 }
 
-/** Join session */
-void UMultiplayerSessionsSubsystem::JoinSession(const FOnlineSessionSearchResult& SessionResult)
+/** Join session, once a slot was reserved for it or when reservations aren't used */
+void UMultiplayerSessionsSubsystem::JoinReservedSession(const FOnlineSessionSearchResult& SessionResult)
 {
-	if (!SessionInterface.IsValid())
+	JoiningTargetId = GetJoinTargetId(SessionResult);
+
+	// Sessions found through the session directory aren't known to any backend, and are joined by travelling straight to their address
+	DirectoryConnectString.Reset();
+	FString DirectoryAddress;
+	if (SessionResult.Session.SessionSettings.Get(SETTING_SESSIONDIRECTORYADDRESS, DirectoryAddress))
+	{
+		RecordSessionRequest(EMultiplayerSessionsTraceOperation::JoinSession, FMultiplayerSessionsTrace::MakeJoinParameters(SessionResult));
+
+		// Only report success for an address the client can actually travel to, with room left for players
+		const TSharedPtr<FInternetAddr> HostAddress = ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM)->GetAddressFromString(DirectoryAddress);
+		EOnJoinSessionCompleteResult::Type Result = EOnJoinSessionCompleteResult::Success;
+		if (!HostAddress.IsValid() || !HostAddress->IsValid() || HostAddress->GetPort() == 0)
+		{
+			Result = EOnJoinSessionCompleteResult::CouldNotRetrieveAddress;
+		}
+		else if (!bJoinAsSpectator && SessionResult.Session.NumOpenPublicConnections <= 0)
+		{
+			Result = EOnJoinSessionCompleteResult::SessionIsFull;
+		}
+		else
+		{
+			DirectoryConnectString = DirectoryAddress;
+		}
+
+		RecordSessionResult(EMultiplayerSessionsTraceOperation::JoinSession, Result == EOnJoinSessionCompleteResult::Success, Result);
+		CompleteJoinSession(Result, JoinSessionRequestToken);
+		return;
+	}
+
+	// Sessions are joined through the backend they were found on
+	const IOnlineSessionPtr ResultSessionInterface = GetSearchResultSessionInterface(SessionResult);
+	if (!ResultSessionInterface.IsValid())
 	{
-		MultiplayerOnJoinSessionCompleteDelegate.Broadcast(EOnJoinSessionCompleteResult::UnknownError);
+		CompleteJoinSession(EOnJoinSessionCompleteResult::UnknownError, JoinSessionRequestToken);
 		return;
 	}
+	const bool bIsDefaultBackend = ResultSessionInterface == SessionInterface;
+	JoinedSessionInterface = bIsDefaultBackend ? nullptr : ResultSessionInterface;
 
 	// Add delegate to list of delegates to call on join session complete, and store its handle
-	JoinSessionCompleteDelegateHandle = SessionInterface->AddOnJoinSessionCompleteDelegate_Handle(JoinSessionCompleteDelegate);
+	JoinSessionCompleteDelegateHandle = ResultSessionInterface->AddOnJoinSessionCompleteDelegate_Handle(JoinSessionCompleteDelegate);
 
-	// Join session
-	if (const ULocalPlayer* LocalPlayer = GetWorld()->GetFirstLocalPlayerFromController())
+	// Join session, identifying the player by controller on other backends, as the preferred net id belongs to the default one
+	RecordSessionRequest(EMultiplayerSessionsTraceOperation::JoinSession, FMultiplayerSessionsTrace::MakeJoinParameters(SessionResult));
+	const ULocalPlayer* LocalPlayer = GetWorld()->GetFirstLocalPlayerFromController();
+	const bool bIsJoining = LocalPlayer && (bIsDefaultBackend
+		? ResultSessionInterface->JoinSession(*LocalPlayer->GetPreferredUniqueNetId(), NAME_GameSession, SessionResult)
+		: ResultSessionInterface->JoinSession(LocalPlayer->GetControllerId(), NAME_GameSession, SessionResult));
+	if (!bIsJoining)
 	{
-		if (!SessionInterface->JoinSession(*LocalPlayer->GetPreferredUniqueNetId(), NAME_GameSession, SessionResult))
-		{
-			// Clear delegate handle if finding sessions failed
-			SessionInterface->ClearOnJoinSessionCompleteDelegate_Handle(JoinSessionCompleteDelegateHandle);
-			MultiplayerOnJoinSessionCompleteDelegate.Broadcast(EOnJoinSessionCompleteResult::UnknownError);
-		}
+		// Clear delegate handle if joining session failed
+		ResultSessionInterface->ClearOnJoinSessionCompleteDelegate_Handle(JoinSessionCompleteDelegateHandle);
+		JoinedSessionInterface.Reset();
+		RecordSessionResult(EMultiplayerSessionsTraceOperation::JoinSession, false, EOnJoinSessionCompleteResult::UnknownError);
+		CompleteJoinSession(EOnJoinSessionCompleteResult::UnknownError, JoinSessionRequestToken);
 	}
 }
 	
 /** Start session */
 void UMultiplayerSessionsSubsystem::StartSession()
 {
-	if (!SessionInterface.IsValid())
+	// Direct calls go through the same queue as future based ones, so their completion is never reported to another request in flight
+	StartSessionAsync();
+}
+
+/** Start session on behalf of the future based request with the given token, 0 for requests made on behalf of another one */
+void UMultiplayerSessionsSubsystem::IssueStartSession(uint32 RequestToken)
+{
+	BeginOperationTiming(EMultiplayerSessionsTraceOperation::StartSession);
+
+	// Completions reported by the session interface belong to the future based request in flight, if any
+	if (RequestToken != 0)
+	{
+		StartSessionRequestToken = RequestToken;
+	}
+
+	if (IsReplayingSessionTrace())
 	{
-		MultiplayerOnStartSessionCompleteDelegate.Broadcast(false);
+		ReplaySessionRequest(EMultiplayerSessionsTraceOperation::StartSession);
+		return;
+	}
+
+	if (!InitializeOnlineSubsystem())
+	{
+		CompleteStartSession(false, RequestToken);
 		return;
 	}
 
@@ -150,107 +535,1995 @@ void UMultiplayerSessionsSubsystem::StartSession()
 	StartSessionCompleteDelegateHandle = SessionInterface->AddOnStartSessionCompleteDelegate_Handle(StartSessionCompleteDelegate);
 
 	// Start session
+	RecordSessionRequest(EMultiplayerSessionsTraceOperation::StartSession);
 	if (!SessionInterface->StartSession(NAME_GameSession))
 	{
 		// Clear delegate handle if starting session failed
 		SessionInterface->ClearOnStartSessionCompleteDelegate_Handle(StartSessionCompleteDelegateHandle);
-		MultiplayerOnStartSessionCompleteDelegate.Broadcast(false);
+		RecordSessionResult(EMultiplayerSessionsTraceOperation::StartSession, false);
+		CompleteStartSession(false, RequestToken);
 	}
 }
 
 /** Destroy session */
 void UMultiplayerSessionsSubsystem::DestroySession()
 {
-	if (!SessionInterface.IsValid())
+	// Direct calls go through the same queue as future based ones, so their completion is never reported to another request in flight
+	DestroySessionAsync();
+}
+
+/** Destroy session on behalf of the future based request with the given token, 0 for requests made on behalf of another one */
+void UMultiplayerSessionsSubsystem::IssueDestroySession(uint32 RequestToken)
+{
+	BeginOperationTiming(EMultiplayerSessionsTraceOperation::DestroySession);
+
+	// Completions reported by the session interface belong to the future based request in flight, if any
+	if (RequestToken != 0)
+	{
+		DestroySessionRequestToken = RequestToken;
+	}
+
+	if (IsReplayingSessionTrace())
 	{
-		MultiplayerOnDestroySessionCompleteDelegate.Broadcast(false);
+		ReplaySessionRequest(EMultiplayerSessionsTraceOperation::DestroySession);
 		return;
 	}
 
-	// Add delegate to list of delegates to call on start session complete, and store its handle
-	DestroySessionCompleteDelegateHandle = SessionInterface->AddOnDestroySessionCompleteDelegate_Handle(DestroySessionCompleteDelegate);
+	if (!InitializeOnlineSubsystem())
+	{
+		CompleteDestroySession(false, RequestToken);
+		return;
+	}
+
+	UnregisterDirectorySession();
+	DirectoryConnectString.Reset();
+	bJoinAsSpectator = false;
+
+	bIsHostingSession = false;
+	StopReservationBeaconHost();
+	StopHostMigrationRoster();
+
+	// Leaving the session forgets its roster, unless it's being re-created as part of becoming its new host
+	if (!bCreateSessionOnDestroy || HostMigrationState != EMultiplayerHostMigrationState::BecomingHost)
+	{
+		ResetHostMigration();
+	}
+
+	DestroyMirroredSessions();
+
+	// Add delegate to list of delegates to call on destroy session complete, and store its handle
+	DestroyingSessionInterface = GetActiveSessionInterface();
+	DestroySessionCompleteDelegateHandle = DestroyingSessionInterface->AddOnDestroySessionCompleteDelegate_Handle(DestroySessionCompleteDelegate);
 
 	// Destroy session
-	if (!SessionInterface->DestroySession(NAME_GameSession))
+	RecordSessionRequest(EMultiplayerSessionsTraceOperation::DestroySession);
+	if (!DestroyingSessionInterface->DestroySession(NAME_GameSession))
 	{
 		// Clear delegate handle if destroying session failed
-		SessionInterface->ClearOnDestroySessionCompleteDelegate_Handle(DestroySessionCompleteDelegateHandle);
-		MultiplayerOnDestroySessionCompleteDelegate.Broadcast(false);
+		DestroyingSessionInterface->ClearOnDestroySessionCompleteDelegate_Handle(DestroySessionCompleteDelegateHandle);
+		DestroyingSessionInterface.Reset();
+		RecordSessionResult(EMultiplayerSessionsTraceOperation::DestroySession, false);
+		CompleteDestroySession(false, RequestToken);
 	}
 }
 
-/** Callback bound to the delegate used for creating the session is completed */
-void UMultiplayerSessionsSubsystem::OnCreateSessionComplete(FName SessionName, bool bWasSuccessful)
+/** Get address used for travelling to the joined session */
+bool UMultiplayerSessionsSubsystem::GetResolvedConnectString(FString& OutAddress) const
 {
-	// Clear delegate handle
-	if (SessionInterface)
+	// Replayed sessions have no host to travel to
+	if (IsReplayingSessionTrace())
 	{
-		SessionInterface->ClearOnCreateSessionCompleteDelegate_Handle(CreateSessionCompleteDelegateHandle);
+		return false;
 	}
-	
-	MultiplayerOnCreateSessionCompleteDelegate.Broadcast(bWasSuccessful);
-}
 
-/** Callback bound to the delegate used for finding sessions is completed */
-void UMultiplayerSessionsSubsystem::OnFindSessionsComplete(bool bWasSuccessful)
-{
-	// Clear delegate handle
-	if (SessionInterface)
+	bool bIsResolved = false;
+	if (!DirectoryConnectString.IsEmpty())
 	{
-		SessionInterface->ClearOnFindSessionsCompleteDelegate_Handle(FindSessionsCompleteDelegateHandle);
+		OutAddress = DirectoryConnectString;
+		bIsResolved = true;
+	}
+	else if (const FMultiplayerJoinTarget* JoinTarget = PreparedJoinTargets.Find(JoiningTargetId); JoinTarget && !JoinTarget->ConnectString.IsEmpty())
+	{
+		OutAddress = JoinTarget->ConnectString;
+		bIsResolved = true;
+	}
+	else
+	{
+		const IOnlineSessionPtr ActiveSessionInterface = GetActiveSessionInterface();
+		bIsResolved = ActiveSessionInterface.IsValid() && ActiveSessionInterface->GetResolvedConnectString(NAME_GameSession, OutAddress);
 	}
 
-	// Broadcast an empty array and failure if there are no search results
-	if (LastSessionSearch->SearchResults.IsEmpty())
+	// Spectators ask the host to log them in as spectators, which keeps them out of the player slots
+	if (bIsResolved && bJoinAsSpectator)
 	{
-		MultiplayerOnFindSessionsCompleteDelegate.Broadcast(TArray<FOnlineSessionSearchResult>(), false);
-		return;
+		OutAddress += TEXT("?SpectatorOnly=1");
 	}
-	
-	MultiplayerOnFindSessionsCompleteDelegate.Broadcast(LastSessionSearch->SearchResults, bWasSuccessful);
+
+	return bIsResolved;
 }
 
-/** Callback bound to the delegate used for joining the session is completed */
-void UMultiplayerSessionsSubsystem::OnJoinSessionComplete(FName SessionName, EOnJoinSessionCompleteResult::Type Result)
+/** Create session, returning a future holding this request's result */
+TFuture<bool> UMultiplayerSessionsSubsystem::CreateSessionAsync(int32 NumPublicConnections, const FString& MatchType)
 {
-	// Clear delegate handle
-	if (SessionInterface)
+	return CreateSessionRequests.Enqueue([WeakThis = TWeakObjectPtr<UMultiplayerSessionsSubsystem>(this), NumPublicConnections, MatchType](uint32 RequestToken)
 	{
-		SessionInterface->ClearOnJoinSessionCompleteDelegate_Handle(JoinSessionCompleteDelegateHandle);
-	}
-	
-	MultiplayerOnJoinSessionCompleteDelegate.Broadcast(Result);
+		if (UMultiplayerSessionsSubsystem* This = WeakThis.Get())
+		{
+			This->IssueCreateSession(NumPublicConnections, MatchType, RequestToken);
+		}
+	});
 }
 
-/** Callback bound to the delegate used for starting the session is completed */
-void UMultiplayerSessionsSubsystem::OnStartSessionComplete(FName SessionName, bool bWasSuccessful)
+/** Find sessions, returning a future holding this request's results */
+TFuture<FMultiplayerFindSessionsResult> UMultiplayerSessionsSubsystem::FindSessionsAsync(int32 MaxSearchResults, const FString& MatchType, bool bForSpectators)
 {
-	// Clear delegate handle
-	if (SessionInterface)
+	return FindSessionsRequests.Enqueue([WeakThis = TWeakObjectPtr<UMultiplayerSessionsSubsystem>(this), MaxSearchResults, MatchType, bForSpectators](uint32 RequestToken)
 	{
-		SessionInterface->ClearOnStartSessionCompleteDelegate_Handle(StartSessionCompleteDelegateHandle);
-	}
-	
-	MultiplayerOnStartSessionCompleteDelegate.Broadcast(bWasSuccessful);
+		if (UMultiplayerSessionsSubsystem* This = WeakThis.Get())
+		{
+			This->IssueFindSessions(MaxSearchResults, MatchType, bForSpectators, RequestToken);
+		}
+	});
 }
 
-/** Callback bound to the delegate used for destroying the session is completed */
-void UMultiplayerSessionsSubsystem::OnDestroySessionComplete(FName SessionName, bool bWasSuccessful)
+/** Join session, returning a future holding this request's result */
+TFuture<EOnJoinSessionCompleteResult::Type> UMultiplayerSessionsSubsystem::JoinSessionAsync(const FOnlineSessionSearchResult& SessionResult, bool bAsSpectator)
 {
-	// Clear delegate handle
-	if (SessionInterface)
+	return JoinSessionRequests.Enqueue([WeakThis = TWeakObjectPtr<UMultiplayerSessionsSubsystem>(this), SessionResult, bAsSpectator](uint32 RequestToken)
 	{
-		SessionInterface->ClearOnDestroySessionCompleteDelegate_Handle(DestroySessionCompleteDelegateHandle);
-	}
+		if (UMultiplayerSessionsSubsystem* This = WeakThis.Get())
+		{
+			This->IssueJoinSession(SessionResult, bAsSpectator, RequestToken);
+		}
+	});
+}
 
-	// Create session after it was successfully destroyed, with appropriate settings
-	if (bWasSuccessful && bCreateSessionOnDestroy)
+/** Start session, returning a future holding this request's result */
+TFuture<bool> UMultiplayerSessionsSubsystem::StartSessionAsync()
+{
+	return StartSessionRequests.Enqueue([WeakThis = TWeakObjectPtr<UMultiplayerSessionsSubsystem>(this)](uint32 RequestToken)
 	{
-		bCreateSessionOnDestroy = false;
-		CreateSession(LastMultiplayerSessionSettings.NumPublicConnections, LastMultiplayerSessionSettings.MatchType);
-	}
+		if (UMultiplayerSessionsSubsystem* This = WeakThis.Get())
+		{
+			This->IssueStartSession(RequestToken);
+		}
+	});
+}
 
-	MultiplayerOnDestroySessionCompleteDelegate.Broadcast(bWasSuccessful);
+/** Destroy session, returning a future holding this request's result */
+TFuture<bool> UMultiplayerSessionsSubsystem::DestroySessionAsync()
+{
+	return DestroySessionRequests.Enqueue([WeakThis = TWeakObjectPtr<UMultiplayerSessionsSubsystem>(this)](uint32 RequestToken)
+	{
+		if (UMultiplayerSessionsSubsystem* This = WeakThis.Get())
+		{
+			This->IssueDestroySession(RequestToken);
+		}
+	});
+}
+
+/** Complete create session request, notifying the future of the request with the given token, if any, and the multicast delegate */
+void UMultiplayerSessionsSubsystem::CompleteCreateSession(bool bWasSuccessful, uint32 RequestToken)
+{
+	EndOperationTiming(EMultiplayerSessionsTraceOperation::CreateSession, bWasSuccessful);
+
+	if (RequestToken == CreateSessionRequestToken)
+	{
+		CreateSessionRequestToken = 0;
+	}
+
+	CreateSessionRequests.Complete(RequestToken, bWasSuccessful);
+	MultiplayerOnCreateSessionCompleteDelegate.Broadcast(bWasSuccessful);
+}
+
+/** Complete find sessions request, notifying the multicast delegate and moving the results into the future of the request with the given token, if any */
+void UMultiplayerSessionsSubsystem::CompleteFindSessions(TArray<FOnlineSessionSearchResult> SessionResults, bool bWasSuccessful, uint32 RequestToken)
+{
+	// Search confirming the served snapshot only reports back, as its request was already completed with the snapshot
+	if (bIsRefreshingSearchSnapshot)
+	{
+		bIsRefreshingSearchSnapshot = false;
+
+		const double RefreshTime = FPlatformTime::Seconds() - SearchSnapshotServeTime;
+		AddOperationLatency(SearchSnapshotRefreshStats, RefreshTime, bWasSuccessful);
+		UE_LOG(LogMultiplayerSessions, Log, TEXT("Search snapshot refreshed in %.3fs - bWasSuccessful: %s, %d sessions"), RefreshTime, bWasSuccessful ? TEXT("true") : TEXT("false"), SessionResults.Num());
+
+		MultiplayerOnSearchSnapshotRefreshedDelegate.Broadcast(SessionResults, bWasSuccessful);
+		return;
+	}
+
+	EndOperationTiming(EMultiplayerSessionsTraceOperation::FindSessions, bWasSuccessful);
+
+	// Delegates only borrow the results, so they're notified first and the results then moved into the future rather than copied
+	MultiplayerOnFindSessionsCompleteDelegate.Broadcast(SessionResults, bWasSuccessful);
+
+	if (RequestToken == FindSessionsRequestToken)
+	{
+		FindSessionsRequestToken = 0;
+	}
+
+	if (RequestToken != 0)
+	{
+		FMultiplayerFindSessionsResult Result;
+		Result.SessionResults = MoveTemp(SessionResults);
+		Result.bWasSuccessful = bWasSuccessful;
+		FindSessionsRequests.Complete(RequestToken, MoveTemp(Result));
+	}
+}
+
+/** Complete join session request, notifying the future of the request with the given token, if any, and the multicast delegate */
+void UMultiplayerSessionsSubsystem::CompleteJoinSession(EOnJoinSessionCompleteResult::Type Result, uint32 RequestToken)
+{
+	EndOperationTiming(EMultiplayerSessionsTraceOperation::JoinSession, Result == EOnJoinSessionCompleteResult::Success);
+
+	if (Result != EOnJoinSessionCompleteResult::Success)
+	{
+		ReleaseJoinTarget(JoiningTargetId);
+		JoiningTargetId.Reset();
+	}
+
+	if (RequestToken == JoinSessionRequestToken)
+	{
+		JoinSessionRequestToken = 0;
+	}
+
+	JoinSessionRequests.Complete(RequestToken, Result);
+	MultiplayerOnJoinSessionCompleteDelegate.Broadcast(Result);
+}
+
+/** Complete start session request, notifying the future of the request with the given token, if any, and the multicast delegate */
+void UMultiplayerSessionsSubsystem::CompleteStartSession(bool bWasSuccessful, uint32 RequestToken)
+{
+	EndOperationTiming(EMultiplayerSessionsTraceOperation::StartSession, bWasSuccessful);
+
+	if (RequestToken == StartSessionRequestToken)
+	{
+		StartSessionRequestToken = 0;
+	}
+
+	StartSessionRequests.Complete(RequestToken, bWasSuccessful);
+	MultiplayerOnStartSessionCompleteDelegate.Broadcast(bWasSuccessful);
+}
+
+/** Complete destroy session request, notifying the future of the request with the given token, if any, and the multicast delegate */
+void UMultiplayerSessionsSubsystem::CompleteDestroySession(bool bWasSuccessful, uint32 RequestToken)
+{
+	EndOperationTiming(EMultiplayerSessionsTraceOperation::DestroySession, bWasSuccessful);
+
+	if (RequestToken == DestroySessionRequestToken)
+	{
+		DestroySessionRequestToken = 0;
+	}
+
+	DestroySessionRequests.Complete(RequestToken, bWasSuccessful);
+	MultiplayerOnDestroySessionCompleteDelegate.Broadcast(bWasSuccessful);
+}
+
+/** Callback bound to the delegate used for creating the session is completed */
+void UMultiplayerSessionsSubsystem::OnCreateSessionComplete(FName SessionName, bool bWasSuccessful)
+{
+	// Clear delegate handle
+	if (SessionInterface)
+	{
+		SessionInterface->ClearOnCreateSessionCompleteDelegate_Handle(CreateSessionCompleteDelegateHandle);
+	}
+
+	RecordSessionResult(EMultiplayerSessionsTraceOperation::CreateSession, bWasSuccessful);
+
+	bIsHostingSession = bWasSuccessful;
+	if (bWasSuccessful && IsUsingMultiBackendSearch())
+	{
+		MirrorSessionToBackends();
+	}
+
+	// Successor re-created the session, so bring the lobby back up without going through the menu
+	if (HostMigrationState == EMultiplayerHostMigrationState::BecomingHost)
+	{
+		// No request waits on the re-created session, but its timing still ends here rather than skewing the next create's latency
+		EndOperationTiming(EMultiplayerSessionsTraceOperation::CreateSession, bWasSuccessful);
+
+		const FString PathToMap = CachedHostMigrationRoster.PathToMap;
+		ResetHostMigration();
+
+		UWorld* World = GetWorld();
+		if (bWasSuccessful && World)
+		{
+			World->ServerTravel(FString::Printf(TEXT("%s?listen"), *PathToMap));
+		}
+		return;
+	}
+
+	if (bWasSuccessful && IsUsingSessionDirectory())
+	{
+		RegisterDirectorySession();
+	}
+
+	// Dedicated servers already run the session's map, so its services start right away
+	UWorld* World = GetWorld();
+	if (bWasSuccessful && World && World->GetNetMode() == NM_DedicatedServer)
+	{
+		StartHostingServices(World);
+	}
+	
+	CompleteCreateSession(bWasSuccessful, CreateSessionRequestToken);
+}
+
+/** Callback bound to the delegate used for finding sessions is completed */
+void UMultiplayerSessionsSubsystem::OnFindSessionsComplete(bool bWasSuccessful)
+{
+	// Clear delegate handle
+	if (SessionInterface)
+	{
+		SessionInterface->ClearOnFindSessionsCompleteDelegate_Handle(FindSessionsCompleteDelegateHandle);
+	}
+
+	RecordSessionResult(EMultiplayerSessionsTraceOperation::FindSessions, bWasSuccessful, 0, &LastSessionSearch->SearchResults);
+
+	// Broadcast an empty array and failure if there are no search results
+	if (LastSessionSearch->SearchResults.IsEmpty())
+	{
+		CompleteFindSessions(TArray<FOnlineSessionSearchResult>(), false, FindSessionsRequestToken);
+		return;
+	}
+	
+	RankSearchResults(LastSessionSearch.ToSharedRef(), bWasSuccessful);
+}
+
+/** Filter, score and sort search results on worker threads, completing the find sessions request with the best ones */
+void UMultiplayerSessionsSubsystem::RankSearchResults(const TSharedRef<FOnlineSessionSearch>& SessionSearch, bool bWasSuccessful)
+{
+	FMultiplayerSessionsSearchFilter Filter;
+	Filter.MatchType = LastSearchMatchType;
+	Filter.MaxResults = LastSearchMaxResults > 0 ? FMath::Min(LastSearchMaxResults, SearchResultsTopK) : SearchResultsTopK;
+	Filter.BuildCompatibilityRange = BuildCompatibilityRange;
+	Filter.bIncludeFullSessions = bLastSearchForSpectators;
+
+	// The search isn't written to once complete, and keeping a reference to it keeps its results alive if a new search starts meanwhile
+	// Ranking completes the request the search was made for, even if another one is in flight by then
+	Async(EAsyncExecution::TaskGraph, [WeakThis = TWeakObjectPtr<UMultiplayerSessionsSubsystem>(this), SessionSearch, Filter, bWasSuccessful, RequestToken = FindSessionsRequestToken]()
+	{
+		TArray<FOnlineSessionSearchResult> RankedResults = MultiplayerSessionsSearchRanking::RankSearchResults(SessionSearch->SearchResults, Filter);
+
+		// Only the best results are handed back to the game thread
+		AsyncTask(ENamedThreads::GameThread, [WeakThis, RankedResults = MoveTemp(RankedResults), bWasSuccessful, RequestToken]() mutable
+		{
+			if (UMultiplayerSessionsSubsystem* This = WeakThis.Get())
+			{
+				This->SaveSearchSnapshot(RankedResults);
+				const bool bHasResults = !RankedResults.IsEmpty();
+				This->CompleteFindSessions(MoveTemp(RankedResults), bWasSuccessful && bHasResults, RequestToken);
+			}
+		});
+	});
+}
+
+/** Callback bound to the delegate used for joining the session is completed */
+void UMultiplayerSessionsSubsystem::OnJoinSessionComplete(FName SessionName, EOnJoinSessionCompleteResult::Type Result)
+{
+	// Clear delegate handle
+	if (const IOnlineSessionPtr ActiveSessionInterface = GetActiveSessionInterface())
+	{
+		ActiveSessionInterface->ClearOnJoinSessionCompleteDelegate_Handle(JoinSessionCompleteDelegateHandle);
+	}
+
+	// No session was joined on the other backend
+	if (Result != EOnJoinSessionCompleteResult::Success && Result != EOnJoinSessionCompleteResult::AlreadyInSession)
+	{
+		JoinedSessionInterface.Reset();
+	}
+
+	RecordSessionResult(EMultiplayerSessionsTraceOperation::JoinSession, Result == EOnJoinSessionCompleteResult::Success, Result);
+	
+	CompleteJoinSession(Result, JoinSessionRequestToken);
+}
+
+/** Callback bound to the delegate used for starting the session is completed */
+void UMultiplayerSessionsSubsystem::OnStartSessionComplete(FName SessionName, bool bWasSuccessful)
+{
+	// Clear delegate handle
+	if (SessionInterface)
+	{
+		SessionInterface->ClearOnStartSessionCompleteDelegate_Handle(StartSessionCompleteDelegateHandle);
+	}
+
+	RecordSessionResult(EMultiplayerSessionsTraceOperation::StartSession, bWasSuccessful);
+	
+	CompleteStartSession(bWasSuccessful, StartSessionRequestToken);
+}
+
+/** Callback bound to the delegate used for destroying the session is completed */
+void UMultiplayerSessionsSubsystem::OnDestroySessionComplete(FName SessionName, bool bWasSuccessful)
+{
+	// Clear delegate handle
+	if (DestroyingSessionInterface)
+	{
+		DestroyingSessionInterface->ClearOnDestroySessionCompleteDelegate_Handle(DestroySessionCompleteDelegateHandle);
+	}
+	DestroyingSessionInterface.Reset();
+	JoinedSessionInterface.Reset();
+
+	RecordSessionResult(EMultiplayerSessionsTraceOperation::DestroySession, bWasSuccessful);
+
+	// Destroying on behalf of a create request leaves the destroy request in flight, if any, waiting for its own completion
+	const uint32 RequestToken = bCreateSessionOnDestroy ? 0 : DestroySessionRequestToken;
+
+	// Create session after it was successfully destroyed, with appropriate settings
+	if (bCreateSessionOnDestroy)
+	{
+		bCreateSessionOnDestroy = false;
+		// Re-creation completes the create session request that destroyed the previous session
+		if (bWasSuccessful)
+		{
+			IssueCreateSession(LastMultiplayerSessionSettings.NumPublicConnections, LastMultiplayerSessionSettings.MatchType, CreateSessionRequestToken);
+		}
+		else
+		{
+			CompleteCreateSession(false, CreateSessionRequestToken);
+		}
+	}
+
+	CompleteDestroySession(bWasSuccessful, RequestToken);
+}
+
+#pragma endregion SESSION
+
+#pragma region SESSION_DIRECTORY
+
+/** Whether sessions are advertised and found through the session directory, instead of the online subsystem's search */
+bool UMultiplayerSessionsSubsystem::IsUsingSessionDirectory() const
+{
+	return SessionDirectoryClient.IsValid() && SessionDirectoryClient->IsConnected();
+}
+
+/** Ticker callback used for processing session directory replies and heartbeats */
+bool UMultiplayerSessionsSubsystem::TickSessionDirectory(float DeltaTime)
+{
+	if (!SessionDirectoryClient.IsValid())
+	{
+		return false;
+	}
+
+	SessionDirectoryClient->Tick();
+
+	// Keep registered session alive, refreshing its open connections
+	const double CurrentTime = FPlatformTime::Seconds();
+	if (!DirectorySessionId.IsEmpty() && CurrentTime - LastDirectoryHeartbeatTime >= SessionDirectoryHeartbeatInterval)
+	{
+		LastDirectoryHeartbeatTime = CurrentTime;
+
+		const FNamedOnlineSession* NamedSession = SessionInterface.IsValid() ? SessionInterface->GetNamedSession(NAME_GameSession) : nullptr;
+		if (NamedSession)
+		{
+			SessionDirectoryClient->HeartbeatSession(DirectorySessionId, NamedSession->NumOpenPublicConnections);
+		}
+	}
+
+	return true;
+}
+
+/** Register the created session in the session directory */
+void UMultiplayerSessionsSubsystem::RegisterDirectorySession()
+{
+	const FNamedOnlineSession* NamedSession = SessionInterface->GetNamedSession(NAME_GameSession);
+	ISocketSubsystem* SocketSubsystem = ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM);
+	if (!NamedSession || !SocketSubsystem)
+	{
+		return;
+	}
+
+	// Clients travel to the port the server already listens on, or to the listen server's default game port
+	const UNetDriver* NetDriver = GetWorld() ? GetWorld()->GetNetDriver() : nullptr;
+	bool bCanBindAll = false;
+	const TSharedRef<FInternetAddr> LocalAddr = SocketSubsystem->GetLocalHostAddr(*GLog, bCanBindAll);
+	LocalAddr->SetPort(NetDriver && NetDriver->GetLocalAddr().IsValid() ? NetDriver->GetLocalAddr()->GetPort() : FURL::UrlConfig.DefaultPort);
+
+	FSessionDirectoryEntry Entry;
+	Entry.SessionId = FGuid::NewGuid().ToString(EGuidFormats::Digits);
+	NamedSession->SessionSettings.Get(FName("MatchType"), Entry.MatchType);
+	Entry.Address = LocalAddr->ToString(true);
+	Entry.NumPublicConnections = NamedSession->SessionSettings.NumPublicConnections;
+	Entry.NumOpenPublicConnections = NamedSession->NumOpenPublicConnections;
+	Entry.BuildFingerprint = MultiplayerSessionsBuildFingerprint::GetLocalFingerprint();
+	Entry.BeaconPort = bUseReservationBeacon ? GetBeaconListenPort() : 0;
+
+	DirectorySessionId = Entry.SessionId;
+	LastDirectoryHeartbeatTime = FPlatformTime::Seconds();
+	SessionDirectoryClient->RegisterSession(Entry);
+}
+
+/** Remove the created session from the session directory */
+void UMultiplayerSessionsSubsystem::UnregisterDirectorySession()
+{
+	if (!DirectorySessionId.IsEmpty() && IsUsingSessionDirectory())
+	{
+		SessionDirectoryClient->UnregisterSession(DirectorySessionId);
+	}
+
+	DirectorySessionId.Reset();
+}
+
+/** Callback called when the session directory query is complete */
+void UMultiplayerSessionsSubsystem::OnDirectoryQueryComplete(const TArray<FSessionDirectoryEntry>& Entries, bool bWasSuccessful)
+{
+	if (!LastSessionSearch.IsValid())
+	{
+		return;
+	}
+
+	// Convert directory entries into search results, so they flow through the regular find and join path
+	LastSessionSearch->SearchResults.Reset(Entries.Num());
+	for (const FSessionDirectoryEntry& Entry : Entries)
+	{
+		FOnlineSessionSearchResult& Result = LastSessionSearch->SearchResults.AddDefaulted_GetRef();
+		Result.Session.NumOpenPublicConnections = Entry.NumOpenPublicConnections;
+		Result.Session.SessionSettings.NumPublicConnections = Entry.NumPublicConnections;
+		Result.Session.SessionSettings.bIsLANMatch = true;
+		Result.Session.SessionSettings.Set(FName("MatchType"), Entry.MatchType, EOnlineDataAdvertisementType::DontAdvertise);
+		Result.Session.SessionSettings.Set(SETTING_SESSIONDIRECTORYADDRESS, Entry.Address, EOnlineDataAdvertisementType::DontAdvertise);
+		Result.Session.SessionSettings.Set(SETTING_SESSIONDIRECTORYID, Entry.SessionId, EOnlineDataAdvertisementType::DontAdvertise);
+		if (Entry.BeaconPort > 0)
+		{
+			Result.Session.SessionSettings.Set(SETTING_BEACONPORT, Entry.BeaconPort, EOnlineDataAdvertisementType::DontAdvertise);
+		}
+
+		// Ranking drops entries hosted by incompatible builds
+		Result.Session.SessionSettings.BuildUniqueId = Entry.BuildFingerprint;
+		Result.Session.SessionSettings.Set(SETTING_BUILDFINGERPRINT, Entry.BuildFingerprint, EOnlineDataAdvertisementType::DontAdvertise);
+	}
+
+	LastSessionSearch->SearchState = bWasSuccessful ? EOnlineAsyncTaskState::Done : EOnlineAsyncTaskState::Failed;
+	OnFindSessionsComplete(bWasSuccessful);
+}
+
+#pragma endregion SESSION_DIRECTORY
+
+#pragma region LOBBY_FLEET
+
+/** Whether created sessions are hosted by one of the lobby fleet's servers, instead of by this player as a listen server */
+bool UMultiplayerSessionsSubsystem::IsUsingLobbyFleet() const
+{
+	return LobbyFleetClient.IsValid() && LobbyFleetClient->IsConnected();
+}
+
+/** Address of the lobby the fleet hosted for the last created session, which players travel to instead of listening themselves */
+bool UMultiplayerSessionsSubsystem::GetFleetLobbyAddress(FString& OutAddress) const
+{
+	OutAddress = FleetLobbyAddress;
+	return !FleetLobbyAddress.IsEmpty();
+}
+
+/** Ticker callback used for processing lobby fleet replies */
+bool UMultiplayerSessionsSubsystem::TickLobbyFleet(float DeltaTime)
+{
+	if (!LobbyFleetClient.IsValid())
+	{
+		return false;
+	}
+
+	LobbyFleetClient->Tick();
+	return true;
+}
+
+/** Callback called when the lobby fleet request is complete */
+void UMultiplayerSessionsSubsystem::OnLobbyFleetRequestComplete(const FString& Address, bool bWasSuccessful)
+{
+	FleetLobbyAddress = bWasSuccessful ? Address : FString();
+	RecordSessionResult(EMultiplayerSessionsTraceOperation::CreateSession, bWasSuccessful);
+	CompleteCreateSession(bWasSuccessful, CreateSessionRequestToken);
+}
+
+#pragma endregion LOBBY_FLEET
+
+#pragma region SESSION_RESERVATION
+
+/** Request a slot to the next candidate session's beacon, joining it once reserved */
+void UMultiplayerSessionsSubsystem::TryNextReservationCandidate()
+{
+	UWorld* World = GetWorld();
+	const ULocalPlayer* LocalPlayer = World ? World->GetFirstLocalPlayerFromController() : nullptr;
+
+	while (!ReservationCandidates.IsEmpty())
+	{
+		ReservationCandidate = MoveTemp(ReservationCandidates[0]);
+		ReservationCandidates.RemoveAt(0, 1, false);
+		PrepareJoinTarget(ReservationCandidate);
+
+		// Hosts without a reachable beacon are joined straight away
+		FString ConnectInfo;
+		if (!LocalPlayer || !GetBeaconConnectString(ReservationCandidate, ConnectInfo))
+		{
+			ReservationCandidates.Reset();
+			JoinReservedSession(ReservationCandidate);
+			return;
+		}
+
+		FString MatchType;
+		ReservationCandidate.Session.SessionSettings.Get(FName("MatchType"), MatchType);
+		const FString PlayerId = LocalPlayer->GetPreferredUniqueNetId().IsValid() ? LocalPlayer->GetPreferredUniqueNetId()->ToString() : FString();
+
+		AMultiplayerSessionsBeaconClient* BeaconClient = World->SpawnActor<AMultiplayerSessionsBeaconClient>();
+		if (BeaconClient)
+		{
+			BeaconClient->OnReservationCompleteDelegate.BindUObject(this, &UMultiplayerSessionsSubsystem::OnReservationComplete);
+			ReservationBeaconClient = BeaconClient;
+			if (BeaconClient->RequestReservation(ConnectInfo, PlayerId, MultiplayerSessionsBuildFingerprint::GetLocalFingerprint(), MatchType))
+			{
+				return;
+			}
+
+			BeaconClient->OnReservationCompleteDelegate.Unbind();
+			DestroyReservationBeaconClient();
+		}
+
+		// Beacon couldn't be started, which only holds the join back unless unreachable beacons are allowed
+		if (bJoinWhenReservationBeaconUnreachable)
+		{
+			ReservationCandidates.Reset();
+			JoinReservedSession(ReservationCandidate);
+			return;
+		}
+
+		LastReservationResult = EMultiplayerReservationResult::ConnectionFailed;
+	}
+
+	// Every candidate rejected the reservation
+	CompleteJoinSession(
+		LastReservationResult == EMultiplayerReservationResult::SessionFull ? EOnJoinSessionCompleteResult::SessionIsFull : EOnJoinSessionCompleteResult::UnknownError,
+		JoinSessionRequestToken
+	);
+}
+
+/** Callback called when the slot reservation request is complete */
+void UMultiplayerSessionsSubsystem::OnReservationComplete(EMultiplayerReservationResult Result)
+{
+	DestroyReservationBeaconClient();
+
+	// Hosts whose beacon can't be reached might still accept the connection, but are only joined if configured to
+	if (Result == EMultiplayerReservationResult::Success || (Result == EMultiplayerReservationResult::ConnectionFailed && bJoinWhenReservationBeaconUnreachable))
+	{
+		ReservationCandidates.Reset();
+		JoinReservedSession(ReservationCandidate);
+		return;
+	}
+
+	// Rejected candidate won't be joined, so its preparation isn't needed anymore
+	ReleaseJoinTarget(GetJoinTargetId(ReservationCandidate));
+
+	LastReservationResult = Result;
+	TryNextReservationCandidate();
+}
+
+/** Get address of the candidate session's reservation beacon */
+bool UMultiplayerSessionsSubsystem::GetBeaconConnectString(const FOnlineSessionSearchResult& SessionResult, FString& OutConnectInfo) const
+{
+	// Session directory entries share their host with the game address, and publish the port their own beacon listens on
+	FString DirectoryAddress;
+	if (SessionResult.Session.SessionSettings.Get(SETTING_SESSIONDIRECTORYADDRESS, DirectoryAddress))
+	{
+		int32 BeaconPort = 0;
+		if (!SessionResult.Session.SessionSettings.Get(SETTING_BEACONPORT, BeaconPort) || BeaconPort <= 0)
+		{
+			return false;
+		}
+
+		FString Host = DirectoryAddress;
+		DirectoryAddress.Split(TEXT(":"), &Host, nullptr, ESearchCase::CaseSensitive, ESearchDir::FromEnd);
+		OutConnectInfo = FString::Printf(TEXT("%s:%d"), *Host, BeaconPort);
+		return true;
+	}
+
+	// Sessions advertised before reservations were supported don't run a beacon
+	if (!SessionResult.Session.SessionSettings.Settings.Contains(SETTING_BEACONPORT))
+	{
+		return false;
+	}
+
+	const IOnlineSessionPtr ResultSessionInterface = GetSearchResultSessionInterface(SessionResult);
+	return ResultSessionInterface.IsValid() && ResultSessionInterface->GetResolvedConnectString(SessionResult, NAME_BeaconPort, OutConnectInfo);
+}
+
+/** Port this instance's reservation beacon listens on. Overridden by -BeaconPort=, which lobby fleet servers sharing a machine are started with */
+int32 UMultiplayerSessionsSubsystem::GetBeaconListenPort()
+{
+	int32 BeaconPort = GetDefault<AOnlineBeaconHost>()->ListenPort;
+	FParse::Value(FCommandLine::Get(), TEXT("BeaconPort="), BeaconPort);
+	return BeaconPort;
+}
+
+/** Destroy reservation beacon client, once it's done with its current callback */
+void UMultiplayerSessionsSubsystem::DestroyReservationBeaconClient()
+{
+	AMultiplayerSessionsBeaconClient* BeaconClient = ReservationBeaconClient.Get();
+	ReservationBeaconClient.Reset();
+	if (!BeaconClient)
+	{
+		return;
+	}
+
+	BeaconClient->OnReservationCompleteDelegate.Unbind();
+	if (UWorld* World = BeaconClient->GetWorld())
+	{
+		World->GetTimerManager().SetTimerForNextTick(FTimerDelegate::CreateWeakLambda(BeaconClient, [BeaconClient]()
+		{
+			BeaconClient->DestroyBeacon();
+		}));
+	}
+}
+
+/** Callback called when a map is loaded, used for starting the reservation beacon host on the hosted session's map */
+void UMultiplayerSessionsSubsystem::OnPostLoadMapWithWorld(UWorld* LoadedWorld)
+{
+	if (!LoadedWorld || LoadedWorld != GetWorld())
+	{
+		return;
+	}
+
+	// Travels made outside of a migration leave the session the roster belongs to, and the next host replicates its own
+	if (IsMigratingHost())
+	{
+		ContinueHostMigration();
+	}
+	else
+	{
+		ResetHostMigration();
+	}
+
+	// Joined session's map is loaded now, so the preloaded maps aren't needed anymore
+	ReleaseJoinTargets();
+
+	if (!bIsHostingSession || (LoadedWorld->GetNetMode() != NM_ListenServer && LoadedWorld->GetNetMode() != NM_DedicatedServer))
+	{
+		return;
+	}
+
+	StartHostingServices(LoadedWorld);
+}
+
+/** Start the hosted session's services on the given world: map advertisement, reservation beacon and host migration roster */
+void UMultiplayerSessionsSubsystem::StartHostingServices(UWorld* World)
+{
+	AdvertiseHostedMap(World);
+
+	if (bUseReservationBeacon)
+	{
+		StartReservationBeaconHost(World);
+	}
+
+	if (bEnableHostMigration)
+	{
+		StartHostMigrationRoster(World);
+	}
+}
+
+/** Start listening for reservation requests for the hosted session */
+void UMultiplayerSessionsSubsystem::StartReservationBeaconHost(UWorld* World)
+{
+	StopReservationBeaconHost();
+
+	const FNamedOnlineSession* NamedSession = SessionInterface.IsValid() ? SessionInterface->GetNamedSession(NAME_GameSession) : nullptr;
+	if (!NamedSession)
+	{
+		return;
+	}
+
+	AOnlineBeaconHost* BeaconHost = World->SpawnActor<AOnlineBeaconHost>();
+	if (!BeaconHost)
+	{
+		return;
+	}
+
+	// Servers sharing a machine each bind the beacon port they advertise
+	BeaconHost->ListenPort = GetBeaconListenPort();
+	if (!BeaconHost->InitHost())
+	{
+		BeaconHost->DestroyBeacon();
+		return;
+	}
+
+	AMultiplayerSessionsBeaconHostObject* BeaconHostObject = World->SpawnActor<AMultiplayerSessionsBeaconHostObject>();
+	if (!BeaconHostObject)
+	{
+		BeaconHost->DestroyBeacon();
+		return;
+	}
+
+	FString MatchType;
+	NamedSession->SessionSettings.Get(FName("MatchType"), MatchType);
+	BeaconHostObject->SetupReservations(NamedSession->SessionSettings.NumPublicConnections, MultiplayerSessionsBuildFingerprint::GetLocalFingerprint(), BuildCompatibilityRange, MatchType);
+
+	BeaconHost->RegisterHost(BeaconHostObject);
+	BeaconHost->PauseBeaconRequests(false);
+
+	ReservationBeaconHost = BeaconHost;
+	ReservationBeaconHostObject = BeaconHostObject;
+}
+
+/** Stop listening for reservation requests */
+void UMultiplayerSessionsSubsystem::StopReservationBeaconHost()
+{
+	if (AMultiplayerSessionsBeaconHostObject* BeaconHostObject = ReservationBeaconHostObject.Get())
+	{
+		if (AOnlineBeaconHost* BeaconHost = ReservationBeaconHost.Get())
+		{
+			BeaconHost->UnregisterHost(BeaconHostObject->GetBeaconType());
+		}
+		BeaconHostObject->Destroy();
+	}
+
+	if (AOnlineBeaconHost* BeaconHost = ReservationBeaconHost.Get())
+	{
+		BeaconHost->DestroyBeacon();
+	}
+
+	ReservationBeaconHost.Reset();
+	ReservationBeaconHostObject.Reset();
+}
+
+#pragma endregion SESSION_RESERVATION
+
+#pragma region HOST_MIGRATION
+
+/** Cache roster replicated by the host, used for electing a successor if the host leaves */
+void UMultiplayerSessionsSubsystem::CacheHostMigrationRoster(const FMultiplayerHostMigrationRoster& Roster)
+{
+	CachedHostMigrationRoster = Roster;
+	CachedHostMigrationRosterTime = FPlatformTime::Seconds();
+
+	// Receiving the new host's roster means the migration succeeded
+	if (HostMigrationState == EMultiplayerHostMigrationState::JoiningNewHost)
+	{
+		HostMigrationState = EMultiplayerHostMigrationState::None;
+		HostMigrationTravelAttempts = 0;
+	}
+}
+
+/** Callback called when a net driver fails, used for detecting the host leaving */
+void UMultiplayerSessionsSubsystem::OnNetworkFailure(UWorld* World, UNetDriver* NetDriver, ENetworkFailure::Type FailureType, const FString& ErrorString)
+{
+	if (!bEnableHostMigration || World != GetWorld() || !NetDriver)
+	{
+		return;
+	}
+
+	// Successor wasn't reachable yet, so try again after the delay
+	if (HostMigrationState == EMultiplayerHostMigrationState::JoiningNewHost)
+	{
+		RetryHostMigrationTravel(ErrorString);
+		return;
+	}
+
+	if (NetDriver->NetDriverName != NAME_GameNetDriver)
+	{
+		return;
+	}
+
+	const bool bHostLeft = FailureType == ENetworkFailure::ConnectionLost || FailureType == ENetworkFailure::ConnectionTimeout;
+	if (bHostLeft && World->GetNetMode() == NM_Client && !CachedHostMigrationRoster.Players.IsEmpty())
+	{
+		// Timeouts are only noticed long after the host went silent, so the roster's age is measured up to its last packet
+		const UNetConnection* ServerConnection = NetDriver->ServerConnection;
+		const double HostSilence = ServerConnection ? NetDriver->GetElapsedTime() - ServerConnection->LastReceiveRealtime : 0.0;
+		BeginHostMigration(FPlatformTime::Seconds() - FMath::Max(HostSilence, 0.0));
+	}
+}
+
+/** Elect successor out of the cached roster, if it was still fresh when the host was last heard from, and start migrating to it */
+void UMultiplayerSessionsSubsystem::BeginHostMigration(double HostLastHeardTime)
+{
+	if (HostLastHeardTime - CachedHostMigrationRosterTime > HostMigrationMaxHeartbeatAge)
+	{
+		UE_LOG(LogMultiplayerSessions, Warning, TEXT("Host left, but its last roster is too old for electing a successor"));
+		ResetHostMigration();
+		return;
+	}
+
+	const FMultiplayerHostMigrationPlayer* Successor = CachedHostMigrationRoster.GetSuccessor(HostMigrationMaxHeartbeatAge);
+	const ULocalPlayer* LocalPlayer = GetGameInstance() ? GetGameInstance()->GetFirstGamePlayer() : nullptr;
+	if (!Successor || !LocalPlayer || !LocalPlayer->GetPreferredUniqueNetId().IsValid())
+	{
+		return;
+	}
+
+	// Every client elects the same successor, as they all share the same roster
+	const bool bIsNewHost = Successor->PlayerId == LocalPlayer->GetPreferredUniqueNetId()->ToString();
+	HostMigrationState = bIsNewHost ? EMultiplayerHostMigrationState::BecomingHost : EMultiplayerHostMigrationState::JoiningNewHost;
+	HostMigrationSuccessorId = Successor->PlayerId;
+	HostMigrationConnectString.Reset();
+	HostMigrationTravelAttempts = 0;
+
+	UE_LOG(LogMultiplayerSessions, Log, TEXT("Host left, migrating session to %s"), bIsNewHost ? TEXT("this player") : *HostMigrationSuccessorId);
+	MultiplayerOnHostMigrationStartedDelegate.Broadcast(bIsNewHost);
+}
+
+/** Continue host migration once the map loaded after the host left */
+void UMultiplayerSessionsSubsystem::ContinueHostMigration()
+{
+	switch (HostMigrationState)
+	{
+	case EMultiplayerHostMigrationState::BecomingHost:
+		// Session is re-created and advertised with the same settings; travelling to the lobby follows its completion
+		CreateSession(CachedHostMigrationRoster.NumPublicConnections, CachedHostMigrationRoster.MatchType);
+		break;
+
+	case EMultiplayerHostMigrationState::JoiningNewHost:
+		// Give the successor time for re-creating the session before travelling to it
+		// Only the first map load arms the travel, later ones following travels whose retries are armed on failure
+		if (const UGameInstance* GameInstance = GetGameInstance())
+		{
+			if (HostMigrationTravelAttempts == 0 && !GameInstance->GetTimerManager().IsTimerActive(HostMigrationTimerHandle))
+			{
+				GameInstance->GetTimerManager().SetTimer(HostMigrationTimerHandle, this, &UMultiplayerSessionsSubsystem::TravelToMigratedHost, HostMigrationTravelDelay, false);
+			}
+		}
+		break;
+
+	default:
+		break;
+	}
+}
+
+/** Search for the session re-created by the elected successor, so its address is resolved by the session interface */
+void UMultiplayerSessionsSubsystem::TravelToMigratedHost()
+{
+	if (HostMigrationState != EMultiplayerHostMigrationState::JoiningNewHost)
+	{
+		return;
+	}
+
+	// Successor's address depends on the net driver (an IP address, or a Steam id under Steam), so it's only known from the session it re-created
+	++HostMigrationTravelAttempts;
+	FindSessionsAsync(HostMigrationMaxSearchResults, CachedHostMigrationRoster.MatchType).Next([WeakThis = TWeakObjectPtr<UMultiplayerSessionsSubsystem>(this)](const FMultiplayerFindSessionsResult& Result)
+	{
+		if (UMultiplayerSessionsSubsystem* This = WeakThis.Get())
+		{
+			This->OnHostMigrationSearchComplete(Result);
+		}
+	});
+}
+
+/** Travel to the session re-created by the elected successor, or try again later if it isn't advertised yet */
+void UMultiplayerSessionsSubsystem::OnHostMigrationSearchComplete(const FMultiplayerFindSessionsResult& Result)
+{
+	if (HostMigrationState != EMultiplayerHostMigrationState::JoiningNewHost || !GEngine)
+	{
+		return;
+	}
+
+	const FOnlineSessionSearchResult* SuccessorResult = Result.SessionResults.FindByPredicate([this](const FOnlineSessionSearchResult& SessionResult)
+	{
+		return SessionResult.Session.OwningUserId.IsValid() && SessionResult.Session.OwningUserId->ToString() == HostMigrationSuccessorId;
+	});
+	if (!SuccessorResult)
+	{
+		RetryHostMigrationTravel(TEXT("Successor's session isn't advertised yet"));
+		return;
+	}
+
+	HostMigrationConnectString.Reset();
+	if (!SuccessorResult->Session.SessionSettings.Get(SETTING_SESSIONDIRECTORYADDRESS, HostMigrationConnectString))
+	{
+		const IOnlineSessionPtr ResultSessionInterface = GetSearchResultSessionInterface(*SuccessorResult);
+		if (!ResultSessionInterface.IsValid() || !ResultSessionInterface->GetResolvedConnectString(*SuccessorResult, NAME_GamePort, HostMigrationConnectString))
+		{
+			RetryHostMigrationTravel(TEXT("Successor's session address couldn't be resolved"));
+			return;
+		}
+	}
+
+	GEngine->SetClientTravel(GetWorld(), *HostMigrationConnectString, TRAVEL_Absolute);
+}
+
+/** Arm the next attempt at reaching the successor, or give up once out of attempts */
+void UMultiplayerSessionsSubsystem::RetryHostMigrationTravel(const FString& Reason)
+{
+	if (HostMigrationTravelAttempts >= HostMigrationMaxTravelAttempts)
+	{
+		UE_LOG(LogMultiplayerSessions, Warning, TEXT("Host migration gave up reaching %s: %s"), *HostMigrationSuccessorId, *Reason);
+		ResetHostMigration();
+	}
+	else if (const UGameInstance* GameInstance = GetGameInstance())
+	{
+		GameInstance->GetTimerManager().SetTimer(HostMigrationTimerHandle, this, &UMultiplayerSessionsSubsystem::TravelToMigratedHost, HostMigrationTravelDelay, false);
+	}
+}
+
+/** Stop host migration, forgetting the cached roster */
+void UMultiplayerSessionsSubsystem::ResetHostMigration()
+{
+	if (const UGameInstance* GameInstance = GetGameInstance())
+	{
+		GameInstance->GetTimerManager().ClearTimer(HostMigrationTimerHandle);
+	}
+
+	HostMigrationState = EMultiplayerHostMigrationState::None;
+	HostMigrationSuccessorId.Reset();
+	HostMigrationConnectString.Reset();
+	HostMigrationTravelAttempts = 0;
+	CachedHostMigrationRoster = FMultiplayerHostMigrationRoster();
+	CachedHostMigrationRosterTime = 0.0;
+}
+
+/** Start replicating the hosted session's roster */
+void UMultiplayerSessionsSubsystem::StartHostMigrationRoster(UWorld* World)
+{
+	StopHostMigrationRoster();
+
+	const FNamedOnlineSession* NamedSession = SessionInterface.IsValid() ? SessionInterface->GetNamedSession(NAME_GameSession) : nullptr;
+	if (!NamedSession)
+	{
+		return;
+	}
+
+	AMultiplayerSessionsHostMigrationRoster* Roster = World->SpawnActor<AMultiplayerSessionsHostMigrationRoster>();
+	if (Roster)
+	{
+		FString MatchType;
+		NamedSession->SessionSettings.Get(FName("MatchType"), MatchType);
+		Roster->SetupRoster(NamedSession->SessionSettings.NumPublicConnections, MatchType);
+		HostMigrationRoster = Roster;
+	}
+}
+
+/** Stop replicating the hosted session's roster */
+void UMultiplayerSessionsSubsystem::StopHostMigrationRoster()
+{
+	if (AMultiplayerSessionsHostMigrationRoster* Roster = HostMigrationRoster.Get())
+	{
+		Roster->Destroy();
+	}
+
+	HostMigrationRoster.Reset();
+}
+
+#pragma endregion HOST_MIGRATION
+
+#pragma region SESSION_TRACE
+
+/** Start recording or replaying session requests, as configured */
+void UMultiplayerSessionsSubsystem::StartSessionTrace()
+{
+	FString RecordFile = SessionTraceRecordFile;
+	FString ReplayFile = SessionTraceReplayFile;
+	float TimeScale = SessionTraceTimeScale;
+	FParse::Value(FCommandLine::Get(), TEXT("SessionTraceRecord="), RecordFile);
+	FParse::Value(FCommandLine::Get(), TEXT("SessionTraceReplay="), ReplayFile);
+	FParse::Value(FCommandLine::Get(), TEXT("SessionTraceTimeScale="), TimeScale);
+
+	// Replaying takes precedence, as there's no session interface traffic to record while replaying
+	if (!ReplayFile.IsEmpty())
+	{
+		const FString Filename = FPaths::Combine(FPaths::ProjectSavedDir(), ReplayFile);
+		const TSharedPtr<FMultiplayerSessionsTracePlayer> Player = MakeShared<FMultiplayerSessionsTracePlayer>();
+		if (Player->Load(Filename))
+		{
+			Player->TimeScale = FMath::Max(0.f, TimeScale);
+			SessionTracePlayer = Player;
+			UE_LOG(LogMultiplayerSessions, Log, TEXT("Replaying session trace %s with time scale %.2f"), *Filename, Player->TimeScale);
+		}
+		return;
+	}
+
+	if (!RecordFile.IsEmpty())
+	{
+		const FString Filename = FPaths::Combine(FPaths::ProjectSavedDir(), RecordFile);
+		SessionTraceRecorder = MakeShared<FMultiplayerSessionsTraceRecorder>(Filename);
+		UE_LOG(LogMultiplayerSessions, Log, TEXT("Recording session trace to %s"), *Filename);
+	}
+}
+
+/** Stop recording or replaying session requests, saving the recorded trace */
+void UMultiplayerSessionsSubsystem::StopSessionTrace()
+{
+	for (const FTSTicker::FDelegateHandle& TickerHandle : SessionTraceTickerHandles)
+	{
+		FTSTicker::GetCoreTicker().RemoveTicker(TickerHandle);
+	}
+	SessionTraceTickerHandles.Reset();
+	SessionTracePlayer.Reset();
+
+	if (SessionTraceRecorder)
+	{
+		SessionTraceRecorder->Save();
+		SessionTraceRecorder.Reset();
+	}
+}
+
+/** Record request made to the session interface, with the parameters it was made with, if recording */
+void UMultiplayerSessionsSubsystem::RecordSessionRequest(EMultiplayerSessionsTraceOperation Operation, TMap<FString, FString> Parameters)
+{
+	if (SessionTraceRecorder)
+	{
+		SessionTraceRecorder->BeginRequest(Operation, MoveTemp(Parameters));
+	}
+}
+
+/** Record result returned by the session interface, if recording, and save the trace so far */
+void UMultiplayerSessionsSubsystem::RecordSessionResult(EMultiplayerSessionsTraceOperation Operation, bool bWasSuccessful, uint8 JoinResult, const TArray<FOnlineSessionSearchResult>* SearchResults)
+{
+	if (SessionTraceRecorder)
+	{
+		SessionTraceRecorder->EndRequest(Operation, bWasSuccessful, JoinResult, SearchResults);
+
+		// Saved after every completion, so sessions that crash or get killed still leave their trace behind
+		SessionTraceRecorder->Save();
+	}
+}
+
+/** Answer request with the next recorded result of its operation, after its recorded latency */
+void UMultiplayerSessionsSubsystem::ReplaySessionRequest(EMultiplayerSessionsTraceOperation Operation)
+{
+	// Requests past the end of the trace fail straight away, as the recorded backend never answered them
+	FMultiplayerSessionsTraceEvent Event;
+	Event.Operation = Operation;
+	Event.JoinResult = EOnJoinSessionCompleteResult::UnknownError;
+	float Delay = 0.f;
+	if (SessionTracePlayer->PopEvent(Operation, Event))
+	{
+		Delay = SessionTracePlayer->GetScaledLatency(Event);
+	}
+	else
+	{
+		UE_LOG(LogMultiplayerSessions, Warning, TEXT("Session trace has no more recorded results for operation %d"), static_cast<int32>(Operation));
+	}
+
+	// Completion is always deferred, so callers observe the same asynchrony as with the session interface
+	const TSharedRef<FTSTicker::FDelegateHandle> TickerHandle = MakeShared<FTSTicker::FDelegateHandle>();
+	*TickerHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateWeakLambda(this, [this, Event, TickerHandle](float DeltaTime)
+	{
+		SessionTraceTickerHandles.Remove(*TickerHandle);
+
+		switch (Event.Operation)
+		{
+		case EMultiplayerSessionsTraceOperation::CreateSession:
+			CompleteCreateSession(Event.bWasSuccessful, CreateSessionRequestToken);
+			break;
+		case EMultiplayerSessionsTraceOperation::FindSessions:
+			{
+				// Replayed results go through the same ranking as live ones
+				const TSharedRef<FOnlineSessionSearch> SessionSearch = AcquireSessionSearch(Event.SessionResults.Num());
+				SessionSearch->SearchResults.Reserve(Event.SessionResults.Num());
+				for (const FMultiplayerSessionsTraceSessionResult& SessionResult : Event.SessionResults)
+				{
+					SessionSearch->SearchResults.Add(FMultiplayerSessionsTrace::MakeSearchResult(SessionResult));
+				}
+
+				if (SessionSearch->SearchResults.IsEmpty())
+				{
+					CompleteFindSessions(TArray<FOnlineSessionSearchResult>(), false, FindSessionsRequestToken);
+				}
+				else
+				{
+					RankSearchResults(SessionSearch, Event.bWasSuccessful);
+				}
+			}
+			break;
+		case EMultiplayerSessionsTraceOperation::JoinSession:
+			CompleteJoinSession(static_cast<EOnJoinSessionCompleteResult::Type>(Event.JoinResult), JoinSessionRequestToken);
+			break;
+		case EMultiplayerSessionsTraceOperation::StartSession:
+			CompleteStartSession(Event.bWasSuccessful, StartSessionRequestToken);
+			break;
+		case EMultiplayerSessionsTraceOperation::DestroySession:
+			CompleteDestroySession(Event.bWasSuccessful, DestroySessionRequestToken);
+			break;
+		}
+
+		// Don't tick again
+		return false;
+	}), Delay);
+	SessionTraceTickerHandles.Add(*TickerHandle);
+}
+
+#pragma endregion SESSION_TRACE
+
+#pragma region MULTI_BACKEND_SEARCH
+
+/** Session interface the current session lives in */
+IOnlineSessionPtr UMultiplayerSessionsSubsystem::GetActiveSessionInterface() const
+{
+	return JoinedSessionInterface.IsValid() ? JoinedSessionInterface : SessionInterface;
+}
+
+/** Session interface of the backend the search result was found through */
+IOnlineSessionPtr UMultiplayerSessionsSubsystem::GetSearchResultSessionInterface(const FOnlineSessionSearchResult& SessionResult) const
+{
+	FString SubsystemName;
+	if (!SessionResult.Session.SessionSettings.Get(SETTING_SEARCHONLINESUBSYSTEM, SubsystemName))
+	{
+		return SessionInterface;
+	}
+
+	const IOnlineSubsystem* Subsystem = IOnlineSubsystem::Get(FName(*SubsystemName));
+	return Subsystem ? Subsystem->GetSessionInterface() : nullptr;
+}
+
+/** Start searching on every configured backend */
+void UMultiplayerSessionsSubsystem::FindSessionsOnBackends(int32 MaxSearchResults)
+{
+	CancelBackendSearches();
+	MergedSessionKeys.Reset();
+
+	const ULocalPlayer* LocalPlayer = GetWorld()->GetFirstLocalPlayerFromController();
+	if (!LocalPlayer)
+	{
+		CompleteFindSessions(TArray<FOnlineSessionSearchResult>(), false, FindSessionsRequestToken);
+		return;
+	}
+
+	TMap<FString, FString> Parameters;
+	Parameters.Add(TEXT("MaxSearchResults"), LexToString(MaxSearchResults));
+	Parameters.Add(TEXT("MatchType"), LastSearchMatchType);
+	Parameters.Add(TEXT("ForSpectators"), LexToString(bLastSearchForSpectators));
+	Parameters.Add(TEXT("SearchOnlineSubsystems"), FString::JoinBy(SearchOnlineSubsystems, TEXT(","), [](const FName& SubsystemName) { return SubsystemName.ToString(); }));
+	RecordSessionRequest(EMultiplayerSessionsTraceOperation::FindSessions, MoveTemp(Parameters));
+
+	for (const FName& SubsystemName : SearchOnlineSubsystems)
+	{
+		const IOnlineSubsystem* Subsystem = IOnlineSubsystem::Get(SubsystemName);
+		const IOnlineSessionPtr BackendSessionInterface = Subsystem ? Subsystem->GetSessionInterface() : nullptr;
+		if (!BackendSessionInterface.IsValid())
+		{
+			UE_LOG(LogMultiplayerSessions, Warning, TEXT("Online subsystem %s isn't available for searching sessions"), *SubsystemName.ToString());
+			continue;
+		}
+
+		FMultiplayerBackendSearch& BackendSearch = BackendSearches.AddDefaulted_GetRef();
+		BackendSearch.SubsystemName = SubsystemName;
+		BackendSearch.SessionInterface = BackendSessionInterface;
+		BackendSearch.SessionSearch = AcquireSessionSearch(MaxSearchResults);
+		BackendSearch.SessionSearch->bIsLanQuery = SubsystemName == "NULL";
+		BackendSearch.SessionSearch->QuerySettings.Set(SEARCH_PRESENCE, true, EOnlineComparisonOp::Equals);
+		MultiplayerSessionsBuildFingerprint::AddQueryFilter(*BackendSearch.SessionSearch, BuildCompatibilityRange);
+		BackendSearch.FindSessionsCompleteDelegateHandle = BackendSessionInterface->AddOnFindSessionsCompleteDelegate_Handle(
+			FOnFindSessionsCompleteDelegate::CreateUObject(this, &UMultiplayerSessionsSubsystem::OnBackendFindSessionsComplete, SubsystemName)
+		);
+
+		// Players are identified by controller, as the preferred net id belongs to the default backend
+		if (!BackendSessionInterface->FindSessions(LocalPlayer->GetControllerId(), BackendSearch.SessionSearch.ToSharedRef()))
+		{
+			BackendSessionInterface->ClearOnFindSessionsCompleteDelegate_Handle(BackendSearch.FindSessionsCompleteDelegateHandle);
+			BackendSearch.bIsComplete = true;
+		}
+	}
+
+	// No backend could start searching
+	if (!BackendSearches.ContainsByPredicate([](const FMultiplayerBackendSearch& BackendSearch) { return !BackendSearch.bIsComplete; }))
+	{
+		FinishBackendSearches();
+		return;
+	}
+
+	// Don't let a slow or unresponsive backend hold the search back, whether or not another one found sessions
+	BackendSearchTimeoutHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateUObject(this, &UMultiplayerSessionsSubsystem::OnBackendSearchTimeout), MultiBackendSearchTimeout);
+}
+
+/** Callback called when a backend's search is complete, merging its results */
+void UMultiplayerSessionsSubsystem::OnBackendFindSessionsComplete(bool bWasSuccessful, FName SubsystemName)
+{
+	FMultiplayerBackendSearch* BackendSearch = BackendSearches.FindByPredicate([SubsystemName](const FMultiplayerBackendSearch& Search)
+	{
+		return Search.SubsystemName == SubsystemName;
+	});
+	if (!BackendSearch || BackendSearch->bIsComplete)
+	{
+		return;
+	}
+
+	BackendSearch->SessionInterface->ClearOnFindSessionsCompleteDelegate_Handle(BackendSearch->FindSessionsCompleteDelegateHandle);
+	BackendSearch->bIsComplete = true;
+	BackendSearch->bWasSuccessful = bWasSuccessful;
+
+	// Sessions advertised on several backends are kept from whichever backend answered first
+	for (const FOnlineSessionSearchResult& SearchResult : BackendSearch->SessionSearch->SearchResults)
+	{
+		FString SessionKey;
+		if (!SearchResult.Session.SessionSettings.Get(SETTING_SESSIONKEY, SessionKey))
+		{
+			SessionKey = FString::Printf(TEXT("%s:%s"), *SubsystemName.ToString(), *SearchResult.GetSessionIdStr());
+		}
+
+		bool bIsAlreadyMerged = false;
+		MergedSessionKeys.Add(SessionKey, &bIsAlreadyMerged);
+		if (bIsAlreadyMerged)
+		{
+			continue;
+		}
+
+		FOnlineSessionSearchResult& MergedResult = LastSessionSearch->SearchResults.Add_GetRef(SearchResult);
+		MergedResult.Session.SessionSettings.Set(SETTING_SEARCHONLINESUBSYSTEM, SubsystemName.ToString(), EOnlineDataAdvertisementType::DontAdvertise);
+	}
+
+	if (!BackendSearches.ContainsByPredicate([](const FMultiplayerBackendSearch& Search) { return !Search.bIsComplete; }))
+	{
+		FinishBackendSearches();
+	}
+}
+
+/** Ticker callback completing the search with the results merged so far, once slower backends took too long */
+bool UMultiplayerSessionsSubsystem::OnBackendSearchTimeout(float DeltaTime)
+{
+	BackendSearchTimeoutHandle.Reset();
+	FinishBackendSearches();
+
+	// Don't tick again
+	return false;
+}
+
+/** Complete multi-backend search with the merged results */
+void UMultiplayerSessionsSubsystem::FinishBackendSearches()
+{
+	const bool bWasSuccessful = BackendSearches.ContainsByPredicate([](const FMultiplayerBackendSearch& BackendSearch) { return BackendSearch.bWasSuccessful; });
+	CancelBackendSearches();
+
+	RecordSessionResult(EMultiplayerSessionsTraceOperation::FindSessions, bWasSuccessful, 0, &LastSessionSearch->SearchResults);
+	if (LastSessionSearch->SearchResults.IsEmpty())
+	{
+		CompleteFindSessions(TArray<FOnlineSessionSearchResult>(), false, FindSessionsRequestToken);
+		return;
+	}
+
+	RankSearchResults(LastSessionSearch.ToSharedRef(), bWasSuccessful);
+}
+
+/** Stop waiting for backends' searches */
+void UMultiplayerSessionsSubsystem::CancelBackendSearches()
+{
+	for (const FMultiplayerBackendSearch& BackendSearch : BackendSearches)
+	{
+		if (!BackendSearch.bIsComplete && BackendSearch.SessionInterface.IsValid())
+		{
+			BackendSearch.SessionInterface->ClearOnFindSessionsCompleteDelegate_Handle(BackendSearch.FindSessionsCompleteDelegateHandle);
+		}
+	}
+	BackendSearches.Reset();
+
+	FTSTicker::GetCoreTicker().RemoveTicker(BackendSearchTimeoutHandle);
+	BackendSearchTimeoutHandle.Reset();
+}
+
+/** Advertise the created session on the other configured backends */
+void UMultiplayerSessionsSubsystem::MirrorSessionToBackends()
+{
+	const ULocalPlayer* LocalPlayer = GetWorld() ? GetWorld()->GetFirstLocalPlayerFromController() : nullptr;
+	if (!LocalPlayer || !LastSessionSettings.IsValid())
+	{
+		return;
+	}
+
+	// Mirrors are best effort, the session on the default backend is the one the game relies on
+	for (const FName& SubsystemName : SearchOnlineSubsystems)
+	{
+		const IOnlineSubsystem* Subsystem = IOnlineSubsystem::Get(SubsystemName);
+		const IOnlineSessionPtr BackendSessionInterface = Subsystem ? Subsystem->GetSessionInterface() : nullptr;
+		if (!BackendSessionInterface.IsValid() || BackendSessionInterface == SessionInterface)
+		{
+			continue;
+		}
+
+		FOnlineSessionSettings MirrorSettings = *LastSessionSettings;
+		MirrorSettings.bIsLANMatch = SubsystemName == "NULL";
+		if (BackendSessionInterface->CreateSession(LocalPlayer->GetControllerId(), NAME_GameSession, MirrorSettings))
+		{
+			MirroredSessionSubsystems.Add(SubsystemName);
+		}
+	}
+}
+
+/** Remove the created session from the other configured backends */
+void UMultiplayerSessionsSubsystem::DestroyMirroredSessions()
+{
+	for (const FName& SubsystemName : MirroredSessionSubsystems)
+	{
+		if (const IOnlineSubsystem* Subsystem = IOnlineSubsystem::Get(SubsystemName))
+		{
+			if (const IOnlineSessionPtr BackendSessionInterface = Subsystem->GetSessionInterface())
+			{
+				BackendSessionInterface->DestroySession(NAME_GameSession);
+			}
+		}
+	}
+	MirroredSessionSubsystems.Reset();
+}
+
+#pragma endregion MULTI_BACKEND_SEARCH
+
+#pragma region JOIN_PIPELINE
+
+/** Id the chosen session's prepared join target is kept under: its session id, or its address for session directory entries */
+FString UMultiplayerSessionsSubsystem::GetJoinTargetId(const FOnlineSessionSearchResult& SessionResult)
+{
+	FString DirectoryAddress;
+	if (SessionResult.Session.SessionSettings.Get(SETTING_SESSIONDIRECTORYADDRESS, DirectoryAddress))
+	{
+		return DirectoryAddress;
+	}
+
+	return SessionResult.GetSessionIdStr();
+}
+
+/** Resolve the chosen session's address and start loading its map, so both are ready by the time the join completes */
+void UMultiplayerSessionsSubsystem::PrepareJoinTarget(const FOnlineSessionSearchResult& SessionResult)
+{
+	FMultiplayerJoinTarget& JoinTarget = PreparedJoinTargets.FindOrAdd(GetJoinTargetId(SessionResult));
+	JoinTarget.ConnectString.Reset();
+	if (!SessionResult.Session.SessionSettings.Get(SETTING_SESSIONDIRECTORYADDRESS, JoinTarget.ConnectString))
+	{
+		const IOnlineSessionPtr ResultSessionInterface = GetSearchResultSessionInterface(SessionResult);
+		if (!ResultSessionInterface.IsValid() || !ResultSessionInterface->GetResolvedConnectString(SessionResult, NAME_GamePort, JoinTarget.ConnectString))
+		{
+			JoinTarget.ConnectString.Reset();
+		}
+	}
+
+	if (!bPreloadJoinTargetMap || !SessionResult.Session.SessionSettings.Get(SETTING_MAPNAME, JoinTarget.MapName) || JoinTarget.MapName.IsEmpty())
+	{
+		return;
+	}
+
+	// Sessions sharing a map share its preload
+	if (PreloadingMapNames.Contains(JoinTarget.MapName) || PreloadedMapWorlds.Contains(JoinTarget.MapName))
+	{
+		return;
+	}
+
+	PreloadingMapNames.Add(JoinTarget.MapName);
+	LoadPackageAsync(JoinTarget.MapName, FLoadPackageAsyncDelegate::CreateUObject(this, &UMultiplayerSessionsSubsystem::OnJoinTargetMapPreloaded));
+}
+
+/** Callback called when the chosen session's map is loaded in the background */
+void UMultiplayerSessionsSubsystem::OnJoinTargetMapPreloaded(const FName& PackageName, UPackage* LoadedPackage, EAsyncLoadingResult::Type Result)
+{
+	// Join targets using the map were released while loading
+	const FString MapName = PackageName.ToString();
+	if (PreloadingMapNames.Remove(MapName) == 0 || Result != EAsyncLoadingResult::Succeeded || !LoadedPackage)
+	{
+		return;
+	}
+
+	// Referencing the package alone doesn't keep the world it holds from being collected
+	if (UWorld* PreloadedWorld = UWorld::FindWorldInPackage(LoadedPackage))
+	{
+		PreloadedMapWorlds.Add(MapName, PreloadedWorld);
+	}
+}
+
+/** Forget the join target prepared under the given id, letting its preloaded map be unloaded unless another target shares it */
+void UMultiplayerSessionsSubsystem::ReleaseJoinTarget(const FString& JoinTargetId)
+{
+	FMultiplayerJoinTarget JoinTarget;
+	if (!PreparedJoinTargets.RemoveAndCopyValue(JoinTargetId, JoinTarget) || JoinTarget.MapName.IsEmpty())
+	{
+		return;
+	}
+
+	for (const TPair<FString, FMultiplayerJoinTarget>& Pair : PreparedJoinTargets)
+	{
+		if (Pair.Value.MapName == JoinTarget.MapName)
+		{
+			return;
+		}
+	}
+
+	PreloadingMapNames.Remove(JoinTarget.MapName);
+	PreloadedMapWorlds.Remove(JoinTarget.MapName);
+}
+
+/** Forget every prepared join target, letting their preloaded maps be unloaded */
+void UMultiplayerSessionsSubsystem::ReleaseJoinTargets()
+{
+	PreparedJoinTargets.Reset();
+	JoiningTargetId.Reset();
+	PreloadingMapNames.Reset();
+	PreloadedMapWorlds.Reset();
+}
+
+/** Advertise the hosted session's map, so joining clients can preload it */
+void UMultiplayerSessionsSubsystem::AdvertiseHostedMap(UWorld* World)
+{
+	const FOnlineSessionSettings* CurrentSettings = SessionInterface.IsValid() ? SessionInterface->GetSessionSettings(NAME_GameSession) : nullptr;
+	if (!CurrentSettings)
+	{
+		return;
+	}
+
+	const FString MapName = UWorld::RemovePIEPrefix(World->GetOutermost()->GetName());
+	FString AdvertisedMapName;
+	if (CurrentSettings->Get(SETTING_MAPNAME, AdvertisedMapName) && AdvertisedMapName == MapName)
+	{
+		return;
+	}
+
+	FOnlineSessionSettings UpdatedSettings = *CurrentSettings;
+	UpdatedSettings.Set(SETTING_MAPNAME, MapName, EOnlineDataAdvertisementType::ViaOnlineService);
+	SessionInterface->UpdateSession(NAME_GameSession, UpdatedSettings, true);
+}
+
+#pragma endregion JOIN_PIPELINE
+
+#pragma region OPERATION_STATS
+
+/** Start timing a request, unless one of the same operation is already in flight */
+void UMultiplayerSessionsSubsystem::BeginOperationTiming(EMultiplayerSessionsTraceOperation Operation)
+{
+	// Requests issued on behalf of another one (e.g. re-creating after destroying) are timed from the first
+	if (!OperationStartTimes.Contains(Operation))
+	{
+		OperationStartTimes.Add(Operation, FPlatformTime::Seconds());
+	}
+}
+
+/** Stop timing a request, adding its latency to the operation's statistics */
+void UMultiplayerSessionsSubsystem::EndOperationTiming(EMultiplayerSessionsTraceOperation Operation, bool bWasSuccessful)
+{
+	double StartTime = 0.0;
+	if (!OperationStartTimes.RemoveAndCopyValue(Operation, StartTime))
+	{
+		return;
+	}
+
+	AddOperationLatency(OperationStats.FindOrAdd(Operation), FPlatformTime::Seconds() - StartTime, bWasSuccessful);
+}
+
+/** Count an allocation made for a request of the given operation */
+void UMultiplayerSessionsSubsystem::CountOperationAllocation(EMultiplayerSessionsTraceOperation Operation)
+{
+	++OperationStats.FindOrAdd(Operation).NumAllocations;
+}
+
+/** Add a completed request's latency to the given statistics */
+void UMultiplayerSessionsSubsystem::AddOperationLatency(FMultiplayerSessionsOperationStats& Stats, double Latency, bool bWasSuccessful)
+{
+	++Stats.NumCompleted;
+	Stats.TotalLatency += Latency;
+	if (!bWasSuccessful)
+	{
+		++Stats.NumFailed;
+	}
+
+	for (int32 BucketIndex = 0; BucketIndex < FMultiplayerSessionsOperationStats::NumLatencyBuckets; ++BucketIndex)
+	{
+		if (Latency <= FMultiplayerSessionsOperationStats::LatencyBucketBounds[BucketIndex])
+		{
+			++Stats.LatencyBucketCounts[BucketIndex];
+			break;
+		}
+	}
+}
+
+#pragma endregion OPERATION_STATS
+
+#pragma region SESSION_POOL
+
+/** Reset last session's settings for a new session, only allocating new ones while something else still holds them */
+void UMultiplayerSessionsSubsystem::ResetSessionSettings()
+{
+	if (!LastSessionSettings.IsValid() || !LastSessionSettings.IsUnique())
+	{
+		LastSessionSettings = MakeShared<FOnlineSessionSettings>();
+		CountOperationAllocation(EMultiplayerSessionsTraceOperation::CreateSession);
+		return;
+	}
+
+	// Settings map keeps its allocation for the new session's settings
+	FSessionSettings RetainedSettings = MoveTemp(LastSessionSettings->Settings);
+	RetainedSettings.Reset();
+	*LastSessionSettings = FOnlineSessionSettings();
+	LastSessionSettings->Settings = MoveTemp(RetainedSettings);
+}
+
+/** Search ready for a new request, reused from the pool when no search in flight or being ranked still holds it */
+TSharedRef<FOnlineSessionSearch> UMultiplayerSessionsSubsystem::AcquireSessionSearch(int32 MaxSearchResults)
+{
+	// Pooled searches are free once only the pool holds them, so the last search and searches in flight on other backends are never handed out twice
+	for (const TSharedRef<FOnlineSessionSearch>& PooledSearch : SessionSearchPool)
+	{
+		if (PooledSearch.GetSharedReferenceCount() != 1)
+		{
+			continue;
+		}
+
+		// Containers are reset rather than emptied, so they keep their allocations
+		FOnlineSessionSearch& SessionSearch = *PooledSearch;
+		SessionSearch.SearchResults.Reset();
+		SessionSearch.SearchState = EOnlineAsyncTaskState::NotStarted;
+		SessionSearch.MaxSearchResults = MaxSearchResults;
+		SessionSearch.QuerySettings.SearchParams.Reset();
+		SessionSearch.bIsLanQuery = false;
+		SessionSearch.PingBucketSize = 0;
+		SessionSearch.PlatformHash = 0;
+		SessionSearch.TimeoutInSeconds = 0.f;
+		return PooledSearch;
+	}
+
+	const TSharedRef<FOnlineSessionSearch> SessionSearch = MakeShared<FOnlineSessionSearch>();
+	SessionSearch->MaxSearchResults = MaxSearchResults;
+	CountOperationAllocation(EMultiplayerSessionsTraceOperation::FindSessions);
+
+	if (SessionSearchPool.Num() < MaxPooledSessionSearches)
+	{
+		SessionSearchPool.Add(SessionSearch);
+	}
+	return SessionSearch;
+}
+
+#pragma endregion SESSION_POOL
+
+#pragma region SEARCH_SNAPSHOT
+
+/** Load sessions found by the last run's search, if they're recent enough to be joined */
+void UMultiplayerSessionsSubsystem::LoadSearchSnapshot()
+{
+	if (SearchSnapshotFile.IsEmpty() || IsReplayingSessionTrace())
+	{
+		return;
+	}
+
+	const TSharedRef<FMultiplayerSessionsSearchSnapshot> LoadedSnapshot = MakeShared<FMultiplayerSessionsSearchSnapshot>();
+	if (!LoadedSnapshot->LoadFromFile(GetSearchSnapshotPath()))
+	{
+		return;
+	}
+
+	LoadedSnapshot->RemoveExpiredEntries(FTimespan::FromSeconds(SearchSnapshotMaxAge));
+	if (!LoadedSnapshot->Entries.IsEmpty())
+	{
+		SearchSnapshot = LoadedSnapshot;
+	}
+}
+
+/** Save ranked search results, so they can be offered on the next start */
+void UMultiplayerSessionsSubsystem::SaveSearchSnapshot(const TArray<FOnlineSessionSearchResult>& SessionResults) const
+{
+	if (SearchSnapshotFile.IsEmpty() || IsReplayingSessionTrace() || SessionResults.IsEmpty())
+	{
+		return;
+	}
+
+	// Only sessions that can be travelled to without searching again are kept
+	FMultiplayerSessionsSearchSnapshot Snapshot;
+	Snapshot.Entries.Reserve(SessionResults.Num());
+	for (const FOnlineSessionSearchResult& SessionResult : SessionResults)
+	{
+		FString Address;
+		if (!SessionResult.Session.SessionSettings.Get(SETTING_SESSIONDIRECTORYADDRESS, Address))
+		{
+			const IOnlineSessionPtr ResultSessionInterface = GetSearchResultSessionInterface(SessionResult);
+			if (!ResultSessionInterface.IsValid() || !ResultSessionInterface->GetResolvedConnectString(SessionResult, NAME_GamePort, Address))
+			{
+				continue;
+			}
+		}
+
+		Snapshot.Entries.Add(FMultiplayerSessionsSearchSnapshot::MakeEntry(SessionResult, Address));
+	}
+
+	if (!Snapshot.Entries.IsEmpty())
+	{
+		Snapshot.SaveToFile(GetSearchSnapshotPath());
+	}
+}
+
+/** Complete find sessions request with the loaded snapshot's sessions, if any matches. Only done once, on the first search */
+bool UMultiplayerSessionsSubsystem::ServeSearchSnapshot(int32 MaxSearchResults, const FString& MatchType)
+{
+	if (!SearchSnapshot.IsValid())
+	{
+		return false;
+	}
+
+	const TSharedPtr<FMultiplayerSessionsSearchSnapshot> ServedSnapshot = MoveTemp(SearchSnapshot);
+
+	// Sessions may have expired since the snapshot was loaded
+	ServedSnapshot->RemoveExpiredEntries(FTimespan::FromSeconds(SearchSnapshotMaxAge));
+
+	TArray<FOnlineSessionSearchResult> SessionResults;
+	for (const FMultiplayerSessionsSearchSnapshotEntry& Entry : ServedSnapshot->Entries)
+	{
+		if (SessionResults.Num() >= MaxSearchResults)
+		{
+			break;
+		}
+
+		// Snapshot may have been saved by another build, which this one can't play with
+		if (!MultiplayerSessionsBuildFingerprint::AreCompatible(MultiplayerSessionsBuildFingerprint::GetLocalFingerprint(), Entry.BuildFingerprint, BuildCompatibilityRange))
+		{
+			continue;
+		}
+
+		if ((bLastSearchForSpectators || Entry.NumOpenPublicConnections > 0) && (MatchType.IsEmpty() || Entry.MatchType == MatchType))
+		{
+			SessionResults.Add(FMultiplayerSessionsSearchSnapshot::MakeSearchResult(Entry));
+		}
+	}
+
+	if (SessionResults.IsEmpty())
+	{
+		return false;
+	}
+
+	CompleteFindSessions(MoveTemp(SessionResults), true, FindSessionsRequestToken);
+	return true;
+}
+
+/** Full path of the search snapshot file */
+FString UMultiplayerSessionsSubsystem::GetSearchSnapshotPath() const
+{
+	return FPaths::Combine(FPaths::ProjectSavedDir(), SearchSnapshotFile);
+}
+
+/** Session to join in place of one picked from the served snapshot: the same session if the refreshing search found it with room left, else the best one of its match type with room left. Spectator searches don't need room left */
+const FOnlineSessionSearchResult* UMultiplayerSessionsSubsystem::FindRefreshedSearchResult(const TArray<FOnlineSessionSearchResult>& SessionResults, const FOnlineSessionSearchResult& SnapshotResult) const
+{
+	FString SnapshotAddress;
+	FString SnapshotMatchType;
+	SnapshotResult.Session.SessionSettings.Get(SETTING_SESSIONDIRECTORYADDRESS, SnapshotAddress);
+	SnapshotResult.Session.SessionSettings.Get(FName("MatchType"), SnapshotMatchType);
+
+	// Results come ranked best first, so the first one of the match type is the replacement
+	const FOnlineSessionSearchResult* Replacement = nullptr;
+	for (const FOnlineSessionSearchResult& SessionResult : SessionResults)
+	{
+		FString MatchType;
+		SessionResult.Session.SessionSettings.Get(FName("MatchType"), MatchType);
+		if ((!bLastSearchForSpectators && SessionResult.Session.NumOpenPublicConnections <= 0) || (!SnapshotMatchType.IsEmpty() && MatchType != SnapshotMatchType))
+		{
+			continue;
+		}
+
+		// Snapshot sessions are only known by their address
+		FString Address;
+		if (!SessionResult.Session.SessionSettings.Get(SETTING_SESSIONDIRECTORYADDRESS, Address))
+		{
+			const IOnlineSessionPtr ResultSessionInterface = GetSearchResultSessionInterface(SessionResult);
+			if (!ResultSessionInterface.IsValid() || !ResultSessionInterface->GetResolvedConnectString(SessionResult, NAME_GamePort, Address))
+			{
+				Address.Reset();
+			}
+		}
+
+		if (!SnapshotAddress.IsEmpty() && Address == SnapshotAddress)
+		{
+			return &SessionResult;
+		}
+
+		if (!Replacement)
+		{
+			Replacement = &SessionResult;
+		}
+	}
+
+	return Replacement;
+}
+
+#pragma endregion SEARCH_SNAPSHOT
+
+#pragma region QUICK_MATCH
+
+/** Join the best session of the given match type, creating one if none is found after re-checking with a randomized back-off */
+void UMultiplayerSessionsSubsystem::QuickMatch(int32 NumPublicConnections, const FString& MatchType, int32 MaxSearchResults)
+{
+	if (bIsQuickMatchInProgress)
+	{
+		UE_LOG(LogMultiplayerSessions, Warning, TEXT("Quick match already in progress"));
+		return;
+	}
+
+	bIsQuickMatchInProgress = true;
+	QuickMatchNumPublicConnections = NumPublicConnections;
+	QuickMatchMatchType = MatchType;
+	QuickMatchMaxSearchResults = MaxSearchResults;
+	QuickMatchNumSearches = 0;
+	QuickMatchSnapshotPick.Reset();
+
+	SearchQuickMatch();
+}
+
+/** Search for the quick match's sessions */
+void UMultiplayerSessionsSubsystem::SearchQuickMatch()
+{
+	++QuickMatchNumSearches;
+	FindSessionsAsync(QuickMatchMaxSearchResults, QuickMatchMatchType).Next([WeakThis = TWeakObjectPtr<UMultiplayerSessionsSubsystem>(this)](const FMultiplayerFindSessionsResult& Result)
+	{
+		if (UMultiplayerSessionsSubsystem* This = WeakThis.Get())
+		{
+			This->OnQuickMatchSearchComplete(Result);
+		}
+	});
+}
+
+/** Join the best session found, or keep looking */
+void UMultiplayerSessionsSubsystem::OnQuickMatchSearchComplete(const FMultiplayerFindSessionsResult& Result)
+{
+	if (!bIsQuickMatchInProgress)
+	{
+		return;
+	}
+
+	// Results come ranked best first, so join the first one with room left
+	const FOnlineSessionSearchResult* SessionResult = Result.SessionResults.FindByPredicate([](const FOnlineSessionSearchResult& Candidate)
+	{
+		return Candidate.Session.NumOpenPublicConnections > 0;
+	});
+
+	// Snapshot sessions may be gone or full by now, so the pick waits for the search confirming them
+	if (SessionResult && IsRefreshingSearchSnapshot())
+	{
+		QuickMatchSnapshotPick = *SessionResult;
+		MultiplayerOnSearchSnapshotRefreshedDelegate.AddUObject(this, &UMultiplayerSessionsSubsystem::OnQuickMatchSearchSnapshotRefreshed);
+		return;
+	}
+
+	JoinQuickMatchSession(SessionResult);
+}
+
+/** Join the picked session, or keep looking if there's none */
+void UMultiplayerSessionsSubsystem::JoinQuickMatchSession(const FOnlineSessionSearchResult* SessionResult)
+{
+	if (!SessionResult)
+	{
+		ContinueQuickMatch();
+		return;
+	}
+
+	JoinSessionAsync(*SessionResult).Next([WeakThis = TWeakObjectPtr<UMultiplayerSessionsSubsystem>(this)](EOnJoinSessionCompleteResult::Type JoinResult)
+	{
+		if (UMultiplayerSessionsSubsystem* This = WeakThis.Get())
+		{
+			This->OnQuickMatchJoinComplete(JoinResult);
+		}
+	});
+}
+
+/** Callback called when the search confirming the served snapshot is complete, joining the session picked from the snapshot once confirmed, or its replacement */
+void UMultiplayerSessionsSubsystem::OnQuickMatchSearchSnapshotRefreshed(const TArray<FOnlineSessionSearchResult>& SessionResults, bool bWasSuccessful)
+{
+	MultiplayerOnSearchSnapshotRefreshedDelegate.RemoveAll(this);
+
+	if (!bIsQuickMatchInProgress || !QuickMatchSnapshotPick.IsSet())
+	{
+		return;
+	}
+
+	const FOnlineSessionSearchResult SnapshotPick = QuickMatchSnapshotPick.GetValue();
+	QuickMatchSnapshotPick.Reset();
+	JoinQuickMatchSession(bWasSuccessful ? FindRefreshedSearchResult(SessionResults, SnapshotPick) : nullptr);
+}
+
+/** Complete the quick match once joined, or keep looking if the session couldn't be joined */
+void UMultiplayerSessionsSubsystem::OnQuickMatchJoinComplete(EOnJoinSessionCompleteResult::Type Result)
+{
+	if (!bIsQuickMatchInProgress)
+	{
+		return;
+	}
+
+	// Session may have filled up since it was found, which is worth another look rather than giving up
+	if (Result == EOnJoinSessionCompleteResult::Success)
+	{
+		CompleteQuickMatch(EMultiplayerQuickMatchResult::Joined);
+	}
+	else
+	{
+		ContinueQuickMatch();
+	}
+}
+
+/** Re-check after a randomized back-off, or create the session once every re-check came back empty */
+void UMultiplayerSessionsSubsystem::ContinueQuickMatch()
+{
+	// Players searching at the same time wait for different times, so the first one to give up hosts and the others find its session on their re-check.
+	// Back-off doubles on every re-check, leaving the backend time to advertise the new session
+	UGameInstance* GameInstance = GetGameInstance();
+	if (QuickMatchNumSearches <= QuickMatchRechecks && GameInstance)
+	{
+		const float MaxBackOff = FMath::Max(QuickMatchMinBackOff, QuickMatchMaxBackOff) * static_cast<float>(1 << (QuickMatchNumSearches - 1));
+		const float BackOff = FMath::FRandRange(QuickMatchMinBackOff, MaxBackOff);
+		GameInstance->GetTimerManager().SetTimer(QuickMatchTimerHandle, this, &UMultiplayerSessionsSubsystem::SearchQuickMatch, FMath::Max(BackOff, KINDA_SMALL_NUMBER), false);
+		return;
+	}
+
+	CreateSessionAsync(QuickMatchNumPublicConnections, QuickMatchMatchType).Next([WeakThis = TWeakObjectPtr<UMultiplayerSessionsSubsystem>(this)](bool bWasSuccessful)
+	{
+		UMultiplayerSessionsSubsystem* This = WeakThis.Get();
+		if (!This)
+		{
+			return;
+		}
+
+		// Players whose back-offs ran out at the same time each created a session, which the tie-break settles on one of
+		UGameInstance* CreatingGameInstance = This->GetGameInstance();
+		if (bWasSuccessful && CreatingGameInstance && This->bIsQuickMatchInProgress)
+		{
+			CreatingGameInstance->GetTimerManager().SetTimer(This->QuickMatchTimerHandle, This, &UMultiplayerSessionsSubsystem::SearchQuickMatchTieBreak, FMath::Max(This->QuickMatchTieBreakDelay, KINDA_SMALL_NUMBER), false);
+			return;
+		}
+
+		This->CompleteQuickMatch(bWasSuccessful ? EMultiplayerQuickMatchResult::Created : EMultiplayerQuickMatchResult::Failed);
+	});
+}
+
+/** Search again once the created session had time to be advertised, so players that created theirs at the same time settle on one */
+void UMultiplayerSessionsSubsystem::SearchQuickMatchTieBreak()
+{
+	FindSessionsAsync(QuickMatchMaxSearchResults, QuickMatchMatchType).Next([WeakThis = TWeakObjectPtr<UMultiplayerSessionsSubsystem>(this)](const FMultiplayerFindSessionsResult& Result)
+	{
+		if (UMultiplayerSessionsSubsystem* This = WeakThis.Get())
+		{
+			This->OnQuickMatchTieBreakSearchComplete(Result);
+		}
+	});
+}
+
+/** Keep the created session if it has the lowest id among the ones found, or destroy it and join the one that has */
+void UMultiplayerSessionsSubsystem::OnQuickMatchTieBreakSearchComplete(const FMultiplayerFindSessionsResult& Result)
+{
+	if (!bIsQuickMatchInProgress)
+	{
+		return;
+	}
+
+	// Sessions hosted elsewhere, e.g. by the lobby fleet, have nothing to settle locally
+	const FNamedOnlineSession* NamedSession = SessionInterface.IsValid() ? SessionInterface->GetNamedSession(NAME_GameSession) : nullptr;
+	const FString OwnId = NamedSession ? GetQuickMatchTieBreakId(NamedSession->SessionSettings, IsUsingSessionDirectory() ? DirectorySessionId : NamedSession->GetSessionIdStr()) : FString();
+	if (OwnId.IsEmpty())
+	{
+		CompleteQuickMatch(EMultiplayerQuickMatchResult::Created);
+		return;
+	}
+
+	// Every player sees the same ids, so they all agree on the lowest one without talking to each other
+	const FOnlineSessionSearchResult* WinningResult = nullptr;
+	FString WinningId = OwnId;
+	for (const FOnlineSessionSearchResult& SessionResult : Result.SessionResults)
+	{
+		const FString SessionId = GetQuickMatchTieBreakId(SessionResult.Session.SessionSettings, SessionResult.Session.SessionInfo.IsValid() ? SessionResult.GetSessionIdStr() : FString());
+		if (SessionResult.Session.NumOpenPublicConnections > 0 && !SessionId.IsEmpty() && SessionId < WinningId)
+		{
+			WinningResult = &SessionResult;
+			WinningId = SessionId;
+		}
+	}
+
+	if (!WinningResult)
+	{
+		CompleteQuickMatch(EMultiplayerQuickMatchResult::Created);
+		return;
+	}
+
+	UE_LOG(LogMultiplayerSessions, Log, TEXT("Quick match session %s lost the tie-break to %s, joining it instead"), *OwnId, *WinningId);
+	DestroySessionAsync().Next([WeakThis = TWeakObjectPtr<UMultiplayerSessionsSubsystem>(this), WinningResult = *WinningResult](bool bWasSuccessful)
+	{
+		if (UMultiplayerSessionsSubsystem* This = WeakThis.Get(); This && This->bIsQuickMatchInProgress)
+		{
+			This->JoinQuickMatchSession(&WinningResult);
+		}
+	});
+}
+
+/** Id sessions are ordered by for the quick match's tie-break, the same for every player finding them. Empty if the session has none */
+FString UMultiplayerSessionsSubsystem::GetQuickMatchTieBreakId(const FOnlineSessionSettings& SessionSettings, const FString& SessionId)
+{
+	// Session key and directory id are the same on every backend the session is found through, unlike backend session ids
+	FString TieBreakId;
+	if (SessionSettings.Get(SETTING_SESSIONKEY, TieBreakId) || SessionSettings.Get(SETTING_SESSIONDIRECTORYID, TieBreakId))
+	{
+		return TieBreakId;
+	}
+
+	return SessionId;
+}
+
+/** Complete quick match, notifying the multicast delegate */
+void UMultiplayerSessionsSubsystem::CompleteQuickMatch(EMultiplayerQuickMatchResult Result)
+{
+	if (!bIsQuickMatchInProgress)
+	{
+		return;
+	}
+
+	bIsQuickMatchInProgress = false;
+	QuickMatchSnapshotPick.Reset();
+	MultiplayerOnQuickMatchCompleteDelegate.Broadcast(Result);
 }
 
-#pragma endregion SESSION
\ No newline at end of file
+#pragma endregion QUICK_MATCH
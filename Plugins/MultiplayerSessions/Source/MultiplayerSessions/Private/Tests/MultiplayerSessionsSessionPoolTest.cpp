@@ -0,0 +1,60 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+// Unreal Engine
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+#include "UObject/Package.h"
+#include "OnlineSessionSettings.h"
+
+// MultiplayerSessions
+#include "Subsystems/MultiplayerSessionsSubsystem.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FMultiplayerSessionsSessionSearchPoolTest, "MultiplayerSessions.Subsystem.SessionSearchPool", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+/** Acquire searches the way each find sessions request does, checking that the pool stops allocating once warmed up and never hands out a search still held elsewhere */
+bool FMultiplayerSessionsSessionSearchPoolTest::RunTest(const FString& Parameters)
+{
+	// Pool needs neither a running game nor an online subsystem, so the subsystem is never initialized
+	UMultiplayerSessionsSubsystem* const MultiplayerSessionsSubsystem = NewObject<UMultiplayerSessionsSubsystem>(GetTransientPackage());
+
+	constexpr int32 MaxSearchResults = 10;
+	constexpr int32 NumResultsFound = 4;
+	constexpr int32 NumSteadyRequests = 5;
+
+	// First request has nothing to reuse
+	MultiplayerSessionsSubsystem->LastSessionSearch = MultiplayerSessionsSubsystem->AcquireSessionSearch(MaxSearchResults);
+	const FOnlineSessionSearch* const PooledSearch = MultiplayerSessionsSubsystem->LastSessionSearch.Get();
+	MultiplayerSessionsSubsystem->LastSessionSearch->SearchResults.SetNum(NumResultsFound);
+	const int32 WarmResultsCapacity = MultiplayerSessionsSubsystem->LastSessionSearch->SearchResults.Max();
+	const int32 WarmNumAllocations = MultiplayerSessionsSubsystem->GetOperationStats(EMultiplayerSessionsTraceOperation::FindSessions).NumAllocations;
+	TestEqual(TEXT("Searches allocated warming up"), WarmNumAllocations, 1);
+
+	// Last search is released before the next one is set up, so the same search comes back with its allocations kept
+	for (int32 Request = 0; Request < NumSteadyRequests; ++Request)
+	{
+		MultiplayerSessionsSubsystem->LastSessionSearch.Reset();
+		MultiplayerSessionsSubsystem->LastSessionSearch = MultiplayerSessionsSubsystem->AcquireSessionSearch(MaxSearchResults);
+
+		const FOnlineSessionSearch& SessionSearch = *MultiplayerSessionsSubsystem->LastSessionSearch;
+		TestTrue(FString::Printf(TEXT("Search %d reused from the pool"), Request), &SessionSearch == PooledSearch);
+		TestEqual(FString::Printf(TEXT("Search %d results"), Request), SessionSearch.SearchResults.Num(), 0);
+		TestEqual(FString::Printf(TEXT("Search %d results capacity"), Request), SessionSearch.SearchResults.Max(), WarmResultsCapacity);
+		MultiplayerSessionsSubsystem->LastSessionSearch->SearchResults.SetNum(NumResultsFound);
+	}
+	TestEqual(TEXT("Searches allocated after warm-up"), MultiplayerSessionsSubsystem->GetOperationStats(EMultiplayerSessionsTraceOperation::FindSessions).NumAllocations, WarmNumAllocations);
+
+	// Search still being ranked keeps its results, so the next request gets another one
+	const TSharedPtr<FOnlineSessionSearch> RankedSearch = MultiplayerSessionsSubsystem->LastSessionSearch;
+	MultiplayerSessionsSubsystem->LastSessionSearch.Reset();
+	MultiplayerSessionsSubsystem->LastSessionSearch = MultiplayerSessionsSubsystem->AcquireSessionSearch(MaxSearchResults);
+	TestTrue(TEXT("Search being ranked isn't handed out"), MultiplayerSessionsSubsystem->LastSessionSearch != RankedSearch);
+	TestEqual(TEXT("Results of the search being ranked"), RankedSearch->SearchResults.Num(), NumResultsFound);
+	TestEqual(TEXT("Searches allocated while another is held"), MultiplayerSessionsSubsystem->GetOperationStats(EMultiplayerSessionsTraceOperation::FindSessions).NumAllocations, WarmNumAllocations + 1);
+
+	MultiplayerSessionsSubsystem->LastSessionSearch.Reset();
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,169 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Trace/MultiplayerSessionsTrace.h"
+
+// Unreal Engine
+#include "Misc/FileHelper.h"
+#include "OnlineSessionSettings.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+
+// MultiplayerSessions
+#include "MultiplayerSessions.h"
+
+namespace
+{
+	/** Identifies multiplayer sessions trace files */
+	constexpr uint32 TraceMagic = 0x5254534D;
+
+	/** Current trace file version */
+	constexpr uint32 TraceVersion = 2;
+}
+
+/** Serialize session result */
+FArchive& operator<<(FArchive& Ar, FMultiplayerSessionsTraceSessionResult& SessionResult)
+{
+	Ar << SessionResult.MatchType;
+	Ar << SessionResult.NumOpenPublicConnections;
+	Ar << SessionResult.NumPublicConnections;
+	Ar << SessionResult.PingInMs;
+	return Ar;
+}
+
+/** Serialize event */
+FArchive& operator<<(FArchive& Ar, FMultiplayerSessionsTraceEvent& Event)
+{
+	uint8 Operation = static_cast<uint8>(Event.Operation);
+	Ar << Operation;
+	Event.Operation = static_cast<EMultiplayerSessionsTraceOperation>(Operation);
+
+	Ar << Event.RequestTime;
+	Ar << Event.CompletionTime;
+	Ar << Event.Parameters;
+	Ar << Event.bWasSuccessful;
+	Ar << Event.JoinResult;
+	Ar << Event.SessionResults;
+	return Ar;
+}
+
+#pragma region TRACE
+
+/** Save trace to the given file */
+bool FMultiplayerSessionsTrace::SaveToFile(const FString& Filename) const
+{
+	TArray<uint8> Data;
+	FMemoryWriter Writer(Data);
+
+	uint32 Magic = TraceMagic;
+	uint32 Version = TraceVersion;
+	Writer << Magic;
+	Writer << Version;
+	Writer << const_cast<TArray<FMultiplayerSessionsTraceEvent>&>(Events);
+
+	if (!FFileHelper::SaveArrayToFile(Data, *Filename))
+	{
+		UE_LOG(LogMultiplayerSessions, Warning, TEXT("Couldn't save session trace to %s"), *Filename);
+		return false;
+	}
+
+	return true;
+}
+
+/** Load trace from the given file, replacing current events */
+bool FMultiplayerSessionsTrace::LoadFromFile(const FString& Filename)
+{
+	Events.Reset();
+
+	TArray<uint8> Data;
+	if (!FFileHelper::LoadFileToArray(Data, *Filename))
+	{
+		UE_LOG(LogMultiplayerSessions, Warning, TEXT("Couldn't load session trace from %s"), *Filename);
+		return false;
+	}
+
+	FMemoryReader Reader(Data);
+	uint32 Magic = 0;
+	uint32 Version = 0;
+	Reader << Magic;
+	Reader << Version;
+	if (Magic != TraceMagic || Version != TraceVersion)
+	{
+		UE_LOG(LogMultiplayerSessions, Warning, TEXT("%s isn't a supported session trace"), *Filename);
+		return false;
+	}
+
+	Reader << Events;
+	if (Reader.IsError())
+	{
+		Events.Reset();
+		UE_LOG(LogMultiplayerSessions, Warning, TEXT("Session trace %s is corrupted"), *Filename);
+		return false;
+	}
+
+	return true;
+}
+
+/** Convert search result into its traced summary */
+FMultiplayerSessionsTraceSessionResult FMultiplayerSessionsTrace::MakeSessionResult(const FOnlineSessionSearchResult& SearchResult)
+{
+	FMultiplayerSessionsTraceSessionResult SessionResult;
+	SearchResult.Session.SessionSettings.Get(FName("MatchType"), SessionResult.MatchType);
+	SessionResult.NumOpenPublicConnections = SearchResult.Session.NumOpenPublicConnections;
+	SessionResult.NumPublicConnections = SearchResult.Session.SessionSettings.NumPublicConnections;
+	SessionResult.PingInMs = SearchResult.PingInMs;
+	return SessionResult;
+}
+
+/** Convert traced summary back into a search result */
+FOnlineSessionSearchResult FMultiplayerSessionsTrace::MakeSearchResult(const FMultiplayerSessionsTraceSessionResult& SessionResult)
+{
+	FOnlineSessionSearchResult SearchResult;
+	SearchResult.Session.NumOpenPublicConnections = SessionResult.NumOpenPublicConnections;
+	SearchResult.Session.SessionSettings.NumPublicConnections = SessionResult.NumPublicConnections;
+	SearchResult.Session.SessionSettings.Set(FName("MatchType"), SessionResult.MatchType, EOnlineDataAdvertisementType::DontAdvertise);
+	SearchResult.PingInMs = SessionResult.PingInMs;
+	return SearchResult;
+}
+
+/** Describe settings a session is created with as request parameters */
+TMap<FString, FString> FMultiplayerSessionsTrace::MakeSettingsParameters(const FOnlineSessionSettings& SessionSettings)
+{
+	TMap<FString, FString> Parameters;
+	Parameters.Add(TEXT("NumPublicConnections"), LexToString(SessionSettings.NumPublicConnections));
+	Parameters.Add(TEXT("NumPrivateConnections"), LexToString(SessionSettings.NumPrivateConnections));
+	Parameters.Add(TEXT("bIsLANMatch"), LexToString(SessionSettings.bIsLANMatch));
+	Parameters.Add(TEXT("bIsDedicated"), LexToString(SessionSettings.bIsDedicated));
+	Parameters.Add(TEXT("bUsesPresence"), LexToString(SessionSettings.bUsesPresence));
+	Parameters.Add(TEXT("bUseLobbiesIfAvailable"), LexToString(SessionSettings.bUseLobbiesIfAvailable));
+	for (const TPair<FName, FOnlineSessionSetting>& Setting : SessionSettings.Settings)
+	{
+		Parameters.Add(Setting.Key.ToString(), Setting.Value.Data.ToString());
+	}
+	return Parameters;
+}
+
+/** Describe a search's filters as request parameters */
+TMap<FString, FString> FMultiplayerSessionsTrace::MakeSearchParameters(const FOnlineSessionSearch& SessionSearch)
+{
+	TMap<FString, FString> Parameters;
+	Parameters.Add(TEXT("MaxSearchResults"), LexToString(SessionSearch.MaxSearchResults));
+	Parameters.Add(TEXT("bIsLanQuery"), LexToString(SessionSearch.bIsLanQuery));
+	for (const TPair<FName, FOnlineSessionSearchParam>& SearchParam : SessionSearch.QuerySettings.SearchParams)
+	{
+		Parameters.Add(SearchParam.Key.ToString(), FString::Printf(TEXT("%s %s"), EOnlineComparisonOp::ToString(SearchParam.Value.ComparisonOp), *SearchParam.Value.Data.ToString()));
+	}
+	return Parameters;
+}
+
+/** Describe a session being joined as request parameters */
+TMap<FString, FString> FMultiplayerSessionsTrace::MakeJoinParameters(const FOnlineSessionSearchResult& SearchResult)
+{
+	TMap<FString, FString> Parameters = MakeSettingsParameters(SearchResult.Session.SessionSettings);
+	Parameters.Add(TEXT("SessionId"), SearchResult.GetSessionIdStr());
+	Parameters.Add(TEXT("OwningUserName"), SearchResult.Session.OwningUserName);
+	Parameters.Add(TEXT("NumOpenPublicConnections"), LexToString(SearchResult.Session.NumOpenPublicConnections));
+	Parameters.Add(TEXT("PingInMs"), LexToString(SearchResult.PingInMs));
+	return Parameters;
+}
+
+#pragma endregion TRACE
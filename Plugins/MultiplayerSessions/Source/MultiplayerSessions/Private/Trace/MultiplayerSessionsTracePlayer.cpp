@@ -0,0 +1,46 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Trace/MultiplayerSessionsTracePlayer.h"
+
+#pragma region REPLAY
+
+/** Load trace to play back */
+bool FMultiplayerSessionsTracePlayer::Load(const FString& Filename)
+{
+	PendingEvents.Reset();
+
+	FMultiplayerSessionsTrace Trace;
+	if (!Trace.LoadFromFile(Filename))
+	{
+		return false;
+	}
+
+	for (FMultiplayerSessionsTraceEvent& Event : Trace.Events)
+	{
+		PendingEvents.FindOrAdd(Event.Operation).Add(MoveTemp(Event));
+	}
+
+	return true;
+}
+
+/** Take next recorded event for the given operation */
+bool FMultiplayerSessionsTracePlayer::PopEvent(EMultiplayerSessionsTraceOperation Operation, FMultiplayerSessionsTraceEvent& OutEvent)
+{
+	TArray<FMultiplayerSessionsTraceEvent>* Events = PendingEvents.Find(Operation);
+	if (!Events || Events->IsEmpty())
+	{
+		return false;
+	}
+
+	OutEvent = MoveTemp((*Events)[0]);
+	Events->RemoveAt(0);
+	return true;
+}
+
+/** Time, in seconds, the event's completion is delayed by, once scaled */
+float FMultiplayerSessionsTracePlayer::GetScaledLatency(const FMultiplayerSessionsTraceEvent& Event) const
+{
+	return FMath::Max(0.f, static_cast<float>(Event.CompletionTime - Event.RequestTime) * TimeScale);
+}
+
+#pragma endregion REPLAY
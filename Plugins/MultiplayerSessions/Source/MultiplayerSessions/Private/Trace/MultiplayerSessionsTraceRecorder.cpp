@@ -0,0 +1,60 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Trace/MultiplayerSessionsTraceRecorder.h"
+
+// Unreal Engine
+#include "OnlineSessionSettings.h"
+
+#pragma region RECORDING
+
+/** Constructor */
+FMultiplayerSessionsTraceRecorder::FMultiplayerSessionsTraceRecorder(const FString& InFilename)
+	: Filename(InFilename)
+	, StartTime(FPlatformTime::Seconds())
+{
+}
+
+/** Record a request being made, with the parameters it was made with */
+void FMultiplayerSessionsTraceRecorder::BeginRequest(EMultiplayerSessionsTraceOperation Operation, TMap<FString, FString> Parameters)
+{
+	PendingRequests.FindOrAdd(Operation).Add({ FPlatformTime::Seconds() - StartTime, MoveTemp(Parameters) });
+}
+
+/** Record the completion of the oldest pending request of the given operation */
+void FMultiplayerSessionsTraceRecorder::EndRequest(EMultiplayerSessionsTraceOperation Operation, bool bWasSuccessful, uint8 JoinResult, const TArray<FOnlineSessionSearchResult>* SearchResults)
+{
+	const double CompletionTime = FPlatformTime::Seconds() - StartTime;
+
+	FMultiplayerSessionsTraceEvent& Event = Trace.Events.AddDefaulted_GetRef();
+	Event.Operation = Operation;
+	Event.CompletionTime = CompletionTime;
+	Event.bWasSuccessful = bWasSuccessful;
+	Event.JoinResult = JoinResult;
+
+	// Completions without a recorded request (e.g. internal re-creation) took no time
+	TArray<FPendingRequest>* Requests = PendingRequests.Find(Operation);
+	Event.RequestTime = CompletionTime;
+	if (Requests && !Requests->IsEmpty())
+	{
+		Event.RequestTime = (*Requests)[0].RequestTime;
+		Event.Parameters = MoveTemp((*Requests)[0].Parameters);
+		Requests->RemoveAt(0);
+	}
+
+	if (SearchResults)
+	{
+		Event.SessionResults.Reserve(SearchResults->Num());
+		for (const FOnlineSessionSearchResult& SearchResult : *SearchResults)
+		{
+			Event.SessionResults.Add(FMultiplayerSessionsTrace::MakeSessionResult(SearchResult));
+		}
+	}
+}
+
+/** Save recorded trace to its file */
+bool FMultiplayerSessionsTraceRecorder::Save() const
+{
+	return Trace.SaveToFile(Filename);
+}
+
+#pragma endregion RECORDING
@@ -0,0 +1,52 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+// Unreal Engine
+#include "CoreMinimal.h"
+
+// MultiplayerSessions
+#include "AsyncActions/MultiplayerSessionsAsyncAction.h"
+
+#include "CreateMultiplayerSessionAsyncAction.generated.h"
+
+/**
+ * Latent node creating a multiplayer session
+ */
+UCLASS()
+class MULTIPLAYERSESSIONS_API UCreateMultiplayerSessionAsyncAction : public UMultiplayerSessionsAsyncAction
+{
+	GENERATED_BODY()
+
+#pragma region ASYNC_ACTION
+
+public:
+
+	/** Create multiplayer session */
+	UFUNCTION(BlueprintCallable, Category = "MultiplayerSessions", meta = (BlueprintInternalUseOnly = "true", WorldContext = "InWorldContextObject"))
+	static UCreateMultiplayerSessionAsyncAction* CreateMultiplayerSession(UObject* InWorldContextObject, int32 NumPublicConnections = 4, const FString& MatchType = TEXT("FreeForAll"));
+
+	/** Start request */
+	virtual void Activate() override;
+
+public:
+
+	/** Called when the session was created */
+	UPROPERTY(BlueprintAssignable)
+	FMultiplayerSessionsAsyncActionSignature OnSuccess;
+
+	/** Called when the session couldn't be created */
+	UPROPERTY(BlueprintAssignable)
+	FMultiplayerSessionsAsyncActionSignature OnFailure;
+
+private:
+
+	/** Number of public connections allowed */
+	int32 NumPublicConnections = 4;
+
+	/** Match type */
+	FString MatchType;
+
+#pragma endregion ASYNC_ACTION
+
+};
@@ -0,0 +1,44 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+// Unreal Engine
+#include "CoreMinimal.h"
+
+// MultiplayerSessions
+#include "AsyncActions/MultiplayerSessionsAsyncAction.h"
+
+#include "DestroyMultiplayerSessionAsyncAction.generated.h"
+
+/**
+ * Latent node destroying the multiplayer session
+ */
+UCLASS()
+class MULTIPLAYERSESSIONS_API UDestroyMultiplayerSessionAsyncAction : public UMultiplayerSessionsAsyncAction
+{
+	GENERATED_BODY()
+
+#pragma region ASYNC_ACTION
+
+public:
+
+	/** Destroy multiplayer session */
+	UFUNCTION(BlueprintCallable, Category = "MultiplayerSessions", meta = (BlueprintInternalUseOnly = "true", WorldContext = "InWorldContextObject"))
+	static UDestroyMultiplayerSessionAsyncAction* DestroyMultiplayerSession(UObject* InWorldContextObject);
+
+	/** Start request */
+	virtual void Activate() override;
+
+public:
+
+	/** Called when the session was destroyed */
+	UPROPERTY(BlueprintAssignable)
+	FMultiplayerSessionsAsyncActionSignature OnSuccess;
+
+	/** Called when the session couldn't be destroyed */
+	UPROPERTY(BlueprintAssignable)
+	FMultiplayerSessionsAsyncActionSignature OnFailure;
+
+#pragma endregion ASYNC_ACTION
+
+};
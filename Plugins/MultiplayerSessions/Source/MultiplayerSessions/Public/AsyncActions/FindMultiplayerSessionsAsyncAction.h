@@ -0,0 +1,55 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+// Unreal Engine
+#include "CoreMinimal.h"
+
+// MultiplayerSessions
+#include "AsyncActions/MultiplayerSessionsAsyncAction.h"
+#include "AsyncActions/MultiplayerSessionSearchResult.h"
+
+#include "FindMultiplayerSessionsAsyncAction.generated.h"
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FFindMultiplayerSessionsAsyncActionSignature, const TArray<FMultiplayerSessionSearchResult>&, SessionResults);
+
+/**
+ * Latent node finding multiplayer sessions
+ */
+UCLASS()
+class MULTIPLAYERSESSIONS_API UFindMultiplayerSessionsAsyncAction : public UMultiplayerSessionsAsyncAction
+{
+	GENERATED_BODY()
+
+#pragma region ASYNC_ACTION
+
+public:
+
+	/** Find multiplayer sessions of the given match type (any match type if empty) */
+	UFUNCTION(BlueprintCallable, Category = "MultiplayerSessions", meta = (BlueprintInternalUseOnly = "true", WorldContext = "InWorldContextObject"))
+	static UFindMultiplayerSessionsAsyncAction* FindMultiplayerSessions(UObject* InWorldContextObject, int32 MaxSearchResults = 10000, const FString& MatchType = TEXT(""));
+
+	/** Start request */
+	virtual void Activate() override;
+
+public:
+
+	/** Called when sessions were found */
+	UPROPERTY(BlueprintAssignable)
+	FFindMultiplayerSessionsAsyncActionSignature OnSuccess;
+
+	/** Called when the search failed or found no sessions */
+	UPROPERTY(BlueprintAssignable)
+	FFindMultiplayerSessionsAsyncActionSignature OnFailure;
+
+private:
+
+	/** Maximum number of search results */
+	int32 MaxSearchResults = 10000;
+
+	/** Match type sessions must have */
+	FString MatchType;
+
+#pragma endregion ASYNC_ACTION
+
+};
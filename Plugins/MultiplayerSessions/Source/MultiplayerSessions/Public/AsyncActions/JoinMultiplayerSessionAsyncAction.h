@@ -0,0 +1,52 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+// Unreal Engine
+#include "CoreMinimal.h"
+
+// MultiplayerSessions
+#include "AsyncActions/MultiplayerSessionsAsyncAction.h"
+#include "AsyncActions/MultiplayerSessionSearchResult.h"
+
+#include "JoinMultiplayerSessionAsyncAction.generated.h"
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FJoinMultiplayerSessionAsyncActionSignature, const FString&, Address);
+
+/**
+ * Latent node joining a multiplayer session
+ */
+UCLASS()
+class MULTIPLAYERSESSIONS_API UJoinMultiplayerSessionAsyncAction : public UMultiplayerSessionsAsyncAction
+{
+	GENERATED_BODY()
+
+#pragma region ASYNC_ACTION
+
+public:
+
+	/** Join multiplayer session, providing the address to travel to */
+	UFUNCTION(BlueprintCallable, Category = "MultiplayerSessions", meta = (BlueprintInternalUseOnly = "true", WorldContext = "InWorldContextObject"))
+	static UJoinMultiplayerSessionAsyncAction* JoinMultiplayerSession(UObject* InWorldContextObject, const FMultiplayerSessionSearchResult& SessionResult);
+
+	/** Start request */
+	virtual void Activate() override;
+
+public:
+
+	/** Called when the session was joined */
+	UPROPERTY(BlueprintAssignable)
+	FJoinMultiplayerSessionAsyncActionSignature OnSuccess;
+
+	/** Called when the session couldn't be joined */
+	UPROPERTY(BlueprintAssignable)
+	FJoinMultiplayerSessionAsyncActionSignature OnFailure;
+
+private:
+
+	/** Session to join */
+	FMultiplayerSessionSearchResult SessionResult;
+
+#pragma endregion ASYNC_ACTION
+
+};
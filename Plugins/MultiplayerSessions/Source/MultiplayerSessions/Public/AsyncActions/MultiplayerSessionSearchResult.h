@@ -0,0 +1,47 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+// Unreal Engine
+#include "CoreMinimal.h"
+#include "OnlineSessionSettings.h"
+
+#include "MultiplayerSessionSearchResult.generated.h"
+
+/**
+ * Blueprint friendly wrapper around a session search result
+ */
+USTRUCT(BlueprintType)
+struct FMultiplayerSessionSearchResult
+{
+	GENERATED_USTRUCT_BODY()
+
+public:
+
+	/** Constructor */
+	FMultiplayerSessionSearchResult() = default;
+
+	/** Constructor from an online session search result */
+	explicit FMultiplayerSessionSearchResult(const FOnlineSessionSearchResult& InOnlineResult);
+
+public:
+
+	/** Match type */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+	FString MatchType;
+
+	/** Number of public connections still available */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+	int32 NumOpenPublicConnections = 0;
+
+	/** Number of public connections allowed */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+	int32 NumPublicConnections = 0;
+
+	/** Ping to the session's host, in milliseconds */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+	int32 PingInMs = 0;
+
+	/** Wrapped online session search result */
+	FOnlineSessionSearchResult OnlineResult;
+};
@@ -0,0 +1,38 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+// Unreal Engine
+#include "CoreMinimal.h"
+#include "Kismet/BlueprintAsyncActionBase.h"
+
+#include "MultiplayerSessionsAsyncAction.generated.h"
+
+// Forward declarations - MultiplayerSessions
+class UMultiplayerSessionsSubsystem;
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE(FMultiplayerSessionsAsyncActionSignature);
+
+/**
+ * Base for latent Blueprint nodes wrapping a single multiplayer sessions subsystem request
+ */
+UCLASS(Abstract)
+class MULTIPLAYERSESSIONS_API UMultiplayerSessionsAsyncAction : public UBlueprintAsyncActionBase
+{
+	GENERATED_BODY()
+
+#pragma region ASYNC_ACTION
+
+protected:
+
+	/** Get multiplayer sessions subsystem from the world context the node was created with */
+	UMultiplayerSessionsSubsystem* GetMultiplayerSessionsSubsystem() const;
+
+protected:
+
+	/** World context the node was created with */
+	TWeakObjectPtr<UObject> WorldContextObject;
+
+#pragma endregion ASYNC_ACTION
+
+};
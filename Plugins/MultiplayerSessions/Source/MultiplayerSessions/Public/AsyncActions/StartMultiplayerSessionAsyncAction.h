@@ -0,0 +1,44 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+// Unreal Engine
+#include "CoreMinimal.h"
+
+// MultiplayerSessions
+#include "AsyncActions/MultiplayerSessionsAsyncAction.h"
+
+#include "StartMultiplayerSessionAsyncAction.generated.h"
+
+/**
+ * Latent node starting the multiplayer session
+ */
+UCLASS()
+class MULTIPLAYERSESSIONS_API UStartMultiplayerSessionAsyncAction : public UMultiplayerSessionsAsyncAction
+{
+	GENERATED_BODY()
+
+#pragma region ASYNC_ACTION
+
+public:
+
+	/** Start multiplayer session */
+	UFUNCTION(BlueprintCallable, Category = "MultiplayerSessions", meta = (BlueprintInternalUseOnly = "true", WorldContext = "InWorldContextObject"))
+	static UStartMultiplayerSessionAsyncAction* StartMultiplayerSession(UObject* InWorldContextObject);
+
+	/** Start request */
+	virtual void Activate() override;
+
+public:
+
+	/** Called when the session was started */
+	UPROPERTY(BlueprintAssignable)
+	FMultiplayerSessionsAsyncActionSignature OnSuccess;
+
+	/** Called when the session couldn't be started */
+	UPROPERTY(BlueprintAssignable)
+	FMultiplayerSessionsAsyncActionSignature OnFailure;
+
+#pragma endregion ASYNC_ACTION
+
+};
@@ -0,0 +1,89 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+// Unreal Engine
+#include "CoreMinimal.h"
+#include "OnlineBeaconClient.h"
+
+#include "MultiplayerSessionsBeaconClient.generated.h"
+
+/** Result of a slot reservation request */
+UENUM(BlueprintType)
+enum class EMultiplayerReservationResult : uint8
+{
+	Success,
+	SessionFull,
+	IncompatibleBuild,
+	IncompatibleMatchType,
+	ConnectionFailed,
+	InvalidPlayerId
+};
+
+DECLARE_DELEGATE_OneParam(FOnMultiplayerReservationComplete, EMultiplayerReservationResult Result);
+
+/**
+ * Beacon used by clients for reserving a slot in a session before travelling to it
+ */
+UCLASS(Transient, NotPlaceable)
+class MULTIPLAYERSESSIONS_API AMultiplayerSessionsBeaconClient : public AOnlineBeaconClient
+{
+	GENERATED_BODY()
+
+#pragma region OVERRIDES
+
+public:
+
+	/** Called when the connection to the beacon host is established */
+	virtual void OnConnected() override;
+
+	/** Called when the connection to the beacon host fails */
+	virtual void OnFailure() override;
+
+#pragma endregion OVERRIDES
+
+#pragma region RESERVATION
+
+public:
+
+	/** Connect to the beacon host at the given address and request a slot */
+	bool RequestReservation(const FString& ConnectInfo, const FString& InPlayerId, int32 InBuildUniqueId, const FString& InMatchType);
+
+	/** Player id the reservation is requested for */
+	const FString& GetPlayerId() const { return PlayerId; }
+
+private:
+
+	/** Request slot to the beacon host, for the player the beacon connection was validated for */
+	UFUNCTION(Server, Reliable)
+	void ServerRequestReservation(int32 InBuildUniqueId, const FString& InMatchType);
+
+	/** Receive beacon host's response to the slot request */
+	UFUNCTION(Client, Reliable)
+	void ClientReservationResponse(EMultiplayerReservationResult Result);
+
+	/** Notify result and close the connection */
+	void CompleteReservation(EMultiplayerReservationResult Result);
+
+public:
+
+	/** Delegate called when the reservation is complete, whatever its result */
+	FOnMultiplayerReservationComplete OnReservationCompleteDelegate;
+
+private:
+
+	/** Player id the reservation is requested for */
+	FString PlayerId;
+
+	/** Build unique id of the requesting client */
+	int32 BuildUniqueId = 0;
+
+	/** Match type the client is looking for */
+	FString MatchType;
+
+	/** Tracks whether the reservation result has already been notified */
+	bool bReservationComplete = false;
+
+#pragma endregion RESERVATION
+
+};
@@ -0,0 +1,74 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+// Unreal Engine
+#include "CoreMinimal.h"
+#include "OnlineBeaconHostObject.h"
+
+// MultiplayerSessions
+#include "Beacons/MultiplayerSessionsBeaconClient.h"
+
+#include "MultiplayerSessionsBeaconHostObject.generated.h"
+
+/**
+ * Beacon host object answering slot reservation requests for the hosted session
+ */
+UCLASS(Transient, NotPlaceable, Config=Game)
+class MULTIPLAYERSESSIONS_API AMultiplayerSessionsBeaconHostObject : public AOnlineBeaconHostObject
+{
+	GENERATED_BODY()
+
+#pragma region INITIALIZATION
+
+public:
+
+	/** Constructor */
+	AMultiplayerSessionsBeaconHostObject();
+
+	/** Setup session's requirements for accepting reservations */
+	void SetupReservations(int32 InNumPublicConnections, int32 InBuildUniqueId, int32 InBuildCompatibilityRange, const FString& InMatchType);
+
+#pragma endregion INITIALIZATION
+
+#pragma region RESERVATION
+
+public:
+
+	/** Check request against session's requirements and reserve a slot if there's room */
+	EMultiplayerReservationResult ProcessReservationRequest(const FString& PlayerId, int32 InBuildUniqueId, const FString& InMatchType);
+
+	/** Number of slots taken, including connected players and pending reservations. Spectators watch from private slots, so they aren't counted */
+	int32 GetNumUsedSlots();
+
+private:
+
+	/** Remove reservations that timed out or whose player already logged in */
+	void PruneReservations();
+
+public:
+
+	/** Time, in seconds, a reservation is held for a player that hasn't logged in yet */
+	UPROPERTY(Config)
+	float ReservationTimeout = 30.f;
+
+private:
+
+	/** Number of public connections allowed */
+	int32 NumPublicConnections = 0;
+
+	/** Build unique id of the session */
+	int32 BuildUniqueId = 0;
+
+	/** Number of net protocol versions, either side of the session's, reserving players may be on */
+	int32 BuildCompatibilityRange = 0;
+
+	/** Match type of the session */
+	FString MatchType;
+
+	/** Time, in seconds, each pending reservation was made at, by player id */
+	TMap<FString, double> Reservations;
+
+#pragma endregion RESERVATION
+
+};
@@ -0,0 +1,33 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+// Unreal Engine
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+
+#include "LobbyFleetCommandlet.generated.h"
+
+/**
+ * Runs the lobby fleet manager as a standalone local process, packing many headless lobby servers on this machine:
+ * UnrealEditor-Cmd <Project> -run=LobbyFleet [-Port=7790] [-MaxServers=16] [-MinIdleServers=2] [-FirstGamePort=7777] [-FirstBeaconPort=15000]
+ *   [-PublicHost=] [-ServerExecutable=] [-ServerMap=] [-ServerArguments=] [-MaxTotalMemoryMB=0] [-RecycleMemoryMB=0] [-RecycleEmptyTime=60]
+ */
+UCLASS()
+class MULTIPLAYERSESSIONS_API ULobbyFleetCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+#pragma region OVERRIDES
+
+public:
+
+	/** Constructor */
+	ULobbyFleetCommandlet();
+
+	/** Run commandlet */
+	virtual int32 Main(const FString& Params) override;
+
+#pragma endregion OVERRIDES
+
+};
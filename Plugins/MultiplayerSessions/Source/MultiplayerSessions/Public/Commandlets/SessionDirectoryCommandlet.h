@@ -0,0 +1,32 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+// Unreal Engine
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+
+#include "SessionDirectoryCommandlet.generated.h"
+
+/**
+ * Runs the session directory as a standalone local process:
+ * UnrealEditor-Cmd <Project> -run=SessionDirectory [-Port=7788] [-HeartbeatTimeout=15]
+ */
+UCLASS()
+class MULTIPLAYERSESSIONS_API USessionDirectoryCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+#pragma region OVERRIDES
+
+public:
+
+	/** Constructor */
+	USessionDirectoryCommandlet();
+
+	/** Run commandlet */
+	virtual int32 Main(const FString& Params) override;
+
+#pragma endregion OVERRIDES
+
+};
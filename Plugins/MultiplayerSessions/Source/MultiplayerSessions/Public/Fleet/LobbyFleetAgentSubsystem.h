@@ -0,0 +1,98 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+// Unreal Engine
+#include "CoreMinimal.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+#include "Containers/Ticker.h"
+
+#include "LobbyFleetAgentSubsystem.generated.h"
+
+// Forward declarations - Unreal Engine
+class FSocket;
+class FInternetAddr;
+
+/**
+ * Connects a lobby server started by the lobby fleet to its manager: reports the server's load every second
+ * and hosts the lobby the manager assigns to it.
+ * Only created when the server was started with -FleetManager=<host:port> -FleetServerId=<id>
+ */
+UCLASS()
+class MULTIPLAYERSESSIONS_API ULobbyFleetAgentSubsystem : public UGameInstanceSubsystem
+{
+	GENERATED_BODY()
+
+#pragma region INITIALIZATION
+
+public:
+
+	/** Only create the subsystem on servers started by the lobby fleet */
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+
+	/** Initialize subsystem */
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+
+	/** Deinitialize subsystem */
+	virtual void Deinitialize() override;
+
+#pragma endregion INITIALIZATION
+
+#pragma region FLEET
+
+private:
+
+	/** Ticker callback accumulating frame times, reporting load and receiving host requests */
+	bool TickFleetAgent(float DeltaTime);
+
+	/** Report server's state and load to the manager */
+	void SendReport();
+
+	/** Create the lobby requested by the manager */
+	void HandleHostRequest(const TArray<FString>& Fields);
+
+	/** Tell the manager the requested lobby is up, so it hands this server's address to the requester */
+	void SendAccepted();
+
+	/** Callback called when the requested lobby's session is created */
+	UFUNCTION()
+	void OnCreateSessionComplete(bool bWasSuccessful);
+
+private:
+
+	/** Time, in seconds, between reports */
+	static constexpr float ReportInterval = 1.f;
+
+	/** Socket used for talking to the manager */
+	FSocket* Socket = nullptr;
+
+	/** Address of the manager */
+	TSharedPtr<FInternetAddr> ManagerAddr;
+
+	/** Id the manager knows this server by */
+	int32 ServerId = 0;
+
+	/** Whether the server was assigned a lobby */
+	bool bIsHosting = false;
+
+	/** Id of the host request the server's lobby was created for */
+	FString HostRequestId;
+
+	/** Whether the assigned lobby's session is created */
+	bool bIsLobbyCreated = false;
+
+	/** Handle for the ticker driving the agent */
+	FTSTicker::FDelegateHandle FleetAgentTickerHandle;
+
+	/** Number of frames since the last report */
+	int32 NumReportFrames = 0;
+
+	/** Total frame time, in seconds, since the last report */
+	float ReportFrameTime = 0.f;
+
+	/** Buffer reused for receiving datagrams */
+	TArray<uint8> ReceiveBuffer;
+
+#pragma endregion FLEET
+
+};
@@ -0,0 +1,93 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+// Unreal Engine
+#include "CoreMinimal.h"
+
+// Forward declarations - Unreal Engine
+class FSocket;
+class FInternetAddr;
+
+DECLARE_DELEGATE_TwoParams(FOnLobbyFleetRequestComplete, const FString& Address, bool bWasSuccessful);
+
+/**
+ * Client for the lobby fleet manager, used by players for having one of the fleet's servers host their lobby
+ */
+class MULTIPLAYERSESSIONS_API FLobbyFleetClient
+{
+
+#pragma region INITIALIZATION
+
+public:
+
+	/** Destructor */
+	~FLobbyFleetClient();
+
+	/** Open socket used for talking to the manager at the given address (host[:port]) */
+	bool Connect(const FString& ManagerAddress);
+
+	/** Close socket, failing any pending request */
+	void Disconnect();
+
+	/** Whether the client can talk to the manager */
+	bool IsConnected() const { return Socket != nullptr; }
+
+#pragma endregion INITIALIZATION
+
+#pragma region FLEET
+
+public:
+
+	/** Ask the manager for a server hosting a lobby of the given match type, completing with the address players travel to */
+	void RequestLobby(const FString& MatchType, int32 NumPublicConnections, const FOnLobbyFleetRequestComplete& OnComplete);
+
+	/** Process replies and retry or time out pending requests */
+	void Tick();
+
+private:
+
+	/** Send message to the manager */
+	void Send(const FString& Message) const;
+
+public:
+
+	/** Time, in seconds, to wait before resending an unanswered request */
+	double RequestRetryInterval = 1.0;
+
+	/** Time, in seconds, after which an unanswered request fails. Longer than the manager waits for a server to free up */
+	double RequestTimeout = 45.0;
+
+private:
+
+	/** Request waiting for the manager's reply */
+	struct FPendingRequest
+	{
+		/** Message sent to the manager */
+		FString Message;
+
+		/** Delegate called when the request is complete */
+		FOnLobbyFleetRequestComplete OnComplete;
+
+		/** Time, in seconds, when the request was first sent */
+		double StartTime = 0.0;
+
+		/** Time, in seconds, when the request was last sent */
+		double LastSendTime = 0.0;
+	};
+
+	/** Socket used for talking to the manager */
+	FSocket* Socket = nullptr;
+
+	/** Address of the manager */
+	TSharedPtr<FInternetAddr> ManagerAddr;
+
+	/** Requests waiting for the manager's reply, by request id */
+	TMap<FString, FPendingRequest> PendingRequests;
+
+	/** Buffer reused for receiving datagrams */
+	TArray<uint8> ReceiveBuffer;
+
+#pragma endregion FLEET
+
+};
@@ -0,0 +1,249 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+// Unreal Engine
+#include "CoreMinimal.h"
+#include "HAL/PlatformProcess.h"
+
+// Forward declarations - Unreal Engine
+class FSocket;
+class FInternetAddr;
+
+/** Lifecycle of a lobby server run by the fleet */
+enum class ELobbyFleetServerState : uint8
+{
+	/** Process started, waiting for its first report */
+	Starting,
+
+	/** Lobby map loaded and waiting for a host request */
+	Idle,
+
+	/** Sent a host request, waiting for the server to accept it */
+	Assigning,
+
+	/** Hosting a lobby */
+	Hosting
+};
+
+/** Request for a lobby waiting for a server to free up */
+struct FLobbyFleetHostRequest
+{
+	/** Address of the requester */
+	TSharedPtr<FInternetAddr> RequesterAddress;
+
+	/** Id the requester identifies the request with */
+	FString RequestId;
+
+	/** Match type of the lobby */
+	FString MatchType;
+
+	/** Number of public connections of the lobby */
+	int32 NumPublicConnections = 0;
+
+	/** Time, in seconds, the request was received at */
+	double RequestTime = 0.0;
+};
+
+/** Lobby server process run by the fleet, with its last reported load */
+struct FLobbyFleetServer
+{
+	/** Id the server reports with */
+	int32 ServerId = 0;
+
+	/** Port the server's game listens on */
+	int32 GamePort = 0;
+
+	/** Port the server's reservation beacon listens on */
+	int32 BeaconPort = 0;
+
+	/** Handle of the server's process */
+	FProcHandle ProcessHandle;
+
+	/** State of the server */
+	ELobbyFleetServerState State = ELobbyFleetServerState::Starting;
+
+	/** Address the server reports from, which host requests are forwarded to */
+	TSharedPtr<FInternetAddr> ReportAddress;
+
+	/** Number of connected players */
+	int32 NumPlayers = 0;
+
+	/** Average frame time, in milliseconds, over the last report interval */
+	float AverageFrameTime = 0.f;
+
+	/** Physical memory used by the process, in megabytes */
+	int32 MemoryMB = 0;
+
+	/** Time, in seconds, the process was started at */
+	double StartTime = 0.0;
+
+	/** Time, in seconds, of the last report */
+	double LastReportTime = 0.0;
+
+	/** Time, in seconds, the server last had players, or was assigned a lobby */
+	double LastOccupiedTime = 0.0;
+
+	/** Host request the server was sent, while waiting for it to be accepted */
+	FLobbyFleetHostRequest AssignedRequest;
+
+	/** Time, in seconds, the host request was first sent to the server */
+	double AssignTime = 0.0;
+
+	/** Time, in seconds, the host request was last sent to the server */
+	double LastAssignSendTime = 0.0;
+};
+
+/**
+ * Runs many headless lobby servers on one machine: starts them ahead of time so idle ones are always ready,
+ * hands host requests to the least loaded idle server, and recycles servers once their lobby is empty or they use too much memory.
+ * Served over UDP by the LobbyFleet commandlet.
+ */
+class MULTIPLAYERSESSIONS_API FLobbyFleetManager
+{
+
+#pragma region INITIALIZATION
+
+public:
+
+	/** Destructor */
+	~FLobbyFleetManager();
+
+	/** Start listening for reports and host requests on the given port */
+	bool Start(int32 Port);
+
+	/** Stop listening and shut down every server */
+	void Stop();
+
+	/** Whether the manager is listening */
+	bool IsRunning() const { return Socket != nullptr; }
+
+#pragma endregion INITIALIZATION
+
+#pragma region FLEET
+
+public:
+
+	/** Wait up to WaitTime seconds for messages, process all pending ones and update the fleet */
+	void Tick(float WaitTime);
+
+	/** Number of servers running, including starting ones */
+	int32 GetNumServers() const { return Servers.Num(); }
+
+private:
+
+	/** Handle a single message */
+	void HandleMessage(const FString& Message, const FInternetAddr& Sender);
+
+	/** Update server's load from its report */
+	void HandleReport(const TArray<FString>& Fields, const FInternetAddr& Sender);
+
+	/** Queue host request, or answer it again if it was already assigned */
+	void HandleHostRequest(const TArray<FString>& Fields, const FInternetAddr& Sender);
+
+	/** Answer the requester once the server it was assigned accepted its lobby */
+	void HandleAccepted(const TArray<FString>& Fields);
+
+	/** Hand queued requests to idle servers, failing the ones that waited too long */
+	void AssignHostRequests();
+
+	/** Resend host requests servers haven't accepted yet, returning the servers that didn't accept in time to idle */
+	void UpdateAssigningServers();
+
+	/** Answer the request and remember the reply, so retries get the same one */
+	void ReplyToHostRequest(const FLobbyFleetHostRequest& Request, const FString& Reply);
+
+	/** Shut down servers that exited, stopped reporting, or should be recycled */
+	void RecycleServers();
+
+	/** Start servers until enough idle ones are ready, within the machine's limits */
+	void PrewarmServers();
+
+	/** Start a lobby server process */
+	bool StartServer();
+
+	/** Shut down server's process */
+	void StopServer(FLobbyFleetServer& Server, const TCHAR* Reason);
+
+	/** Idle server with the lowest load, if any */
+	FLobbyFleetServer* FindLeastLoadedIdleServer();
+
+	/** Address players travel to for joining the given server */
+	FString GetServerAddress(const FLobbyFleetServer& Server) const;
+
+public:
+
+	/** Executable lobby servers are started with. Empty uses this process' executable */
+	FString ServerExecutable;
+
+	/** Map lobby servers start on, so they're ready to host as soon as they report */
+	FString ServerMap = TEXT("/Game/ThirdPerson/Maps/Lobby");
+
+	/** Extra arguments lobby servers are started with */
+	FString ServerArguments;
+
+	/** Host players reach this machine's servers at. Empty uses the machine's local address */
+	FString PublicHost;
+
+	/** Game port of the first server, the next ones using the following ports */
+	int32 FirstGamePort = 7777;
+
+	/** Reservation beacon port of the first server, the next ones using the following ports */
+	int32 FirstBeaconPort = 15000;
+
+	/** Maximum number of servers run at once */
+	int32 MaxServers = 16;
+
+	/** Number of idle servers kept ready for host requests */
+	int32 MinIdleServers = 2;
+
+	/** Memory, in megabytes, all servers may use together before no more are started. 0 doesn't limit it */
+	int32 MaxTotalMemoryMB = 0;
+
+	/** Memory, in megabytes, above which an empty server is recycled. 0 doesn't limit it */
+	int32 RecycleMemoryMB = 0;
+
+	/** Time, in seconds, a server's lobby may stay empty before the server is recycled */
+	double RecycleEmptyTime = 60.0;
+
+	/** Time, in seconds, a starting server has to send its first report */
+	double StartupTimeout = 120.0;
+
+	/** Time, in seconds, after which a server that stopped reporting is shut down */
+	double ReportTimeout = 15.0;
+
+	/** Time, in seconds, a host request waits for an idle server before being refused */
+	double HostRequestTimeout = 30.0;
+
+	/** Time, in seconds, a server has to accept the host request it was sent before going back to idle */
+	double AssignTimeout = 10.0;
+
+	/** Time, in seconds, to wait before resending a host request a server hasn't accepted */
+	double AssignRetryInterval = 1.0;
+
+private:
+
+	/** Socket used for receiving reports and requests */
+	FSocket* Socket = nullptr;
+
+	/** Port the manager listens on */
+	int32 ManagerPort = 0;
+
+	/** Servers run by the fleet */
+	TArray<FLobbyFleetServer> Servers;
+
+	/** Host requests waiting for an idle server */
+	TArray<FLobbyFleetHostRequest> PendingHostRequests;
+
+	/** Replies to assigned requests, by requester and request id, so retried requests get the same server */
+	TMap<FString, TPair<FString, double>> RecentAssignments;
+
+	/** Id for the next server */
+	int32 NextServerId = 1;
+
+	/** Buffer reused for receiving datagrams */
+	TArray<uint8> ReceiveBuffer;
+
+#pragma endregion FLEET
+
+};
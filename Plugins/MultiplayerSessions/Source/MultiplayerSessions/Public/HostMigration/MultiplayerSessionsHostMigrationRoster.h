@@ -0,0 +1,125 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+// Unreal Engine
+#include "CoreMinimal.h"
+#include "GameFramework/Info.h"
+
+#include "MultiplayerSessionsHostMigrationRoster.generated.h"
+
+/**
+ * Player that can take over the session if the host leaves
+ */
+USTRUCT(BlueprintType)
+struct FMultiplayerHostMigrationPlayer
+{
+	GENERATED_USTRUCT_BODY()
+
+public:
+
+	/** Unique net id of the player, as a string. Other players find the session this player re-creates by its owner */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+	FString PlayerId;
+
+	/** Order in which the player joined the session. Lowest one is elected as the successor */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+	int32 JoinOrder = 0;
+
+	/** Host's world time, in seconds, the host last heard from the player at */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+	float LastHeartbeatTime = 0.f;
+};
+
+/**
+ * Everything needed for re-creating the session on a new host
+ */
+USTRUCT(BlueprintType)
+struct FMultiplayerHostMigrationRoster
+{
+	GENERATED_USTRUCT_BODY()
+
+public:
+
+	/** Connected players, excluding the host */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+	TArray<FMultiplayerHostMigrationPlayer> Players;
+
+	/** Number of public connections allowed */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+	int32 NumPublicConnections = 0;
+
+	/** Match type */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+	FString MatchType;
+
+	/** Path to the map the session is playing */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+	FString PathToMap;
+
+	/** Host's world time, in seconds, the roster was last refreshed at */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+	float UpdateTime = 0.f;
+
+	/** Get the player elected for taking over the session, if any, skipping players the host hadn't heard from for more than MaxHeartbeatAge seconds */
+	const FMultiplayerHostMigrationPlayer* GetSuccessor(float MaxHeartbeatAge) const;
+};
+
+/**
+ * Replicates the session's roster to every client, so they can agree on a successor and reach it if the host leaves
+ */
+UCLASS(NotPlaceable)
+class MULTIPLAYERSESSIONS_API AMultiplayerSessionsHostMigrationRoster : public AInfo
+{
+	GENERATED_BODY()
+
+#pragma region INITIALIZATION
+
+public:
+
+	/** Constructor */
+	AMultiplayerSessionsHostMigrationRoster();
+
+	/** Setup session's settings shared with the successor */
+	void SetupRoster(int32 NumPublicConnections, const FString& MatchType);
+
+#pragma endregion INITIALIZATION
+
+#pragma region OVERRIDES
+
+public:
+
+	/** Refresh roster on the server */
+	virtual void Tick(float DeltaSeconds) override;
+
+	/** Setup replicated properties */
+	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+
+#pragma endregion OVERRIDES
+
+#pragma region ROSTER
+
+private:
+
+	/** Rebuild roster out of the connected players */
+	void RefreshRoster();
+
+	/** Hand replicated roster over to the multiplayer sessions subsystem */
+	UFUNCTION()
+	void OnRep_Roster();
+
+private:
+
+	/** Replicated roster */
+	UPROPERTY(ReplicatedUsing = OnRep_Roster)
+	FMultiplayerHostMigrationRoster Roster;
+
+	/** Join order of every player seen by the host, by player id */
+	TMap<FString, int32> JoinOrders;
+
+	/** Join order for the next player */
+	int32 NextJoinOrder = 0;
+
+#pragma endregion ROSTER
+
+};
@@ -17,6 +17,7 @@ class UButton;
 
 // Forward declarations - MultiplayerSessions
 class UMultiplayerSessionsSubsystem;
+enum class EMultiplayerQuickMatchResult : uint8;
 
 /**
  * 
@@ -42,10 +43,25 @@ protected:
 	
 public:
 
-	/** Setup menu */
+	/** Setup menu. Menus created outside of the menu pool hand off to the pooled instance of their class */
 	UFUNCTION(BlueprintCallable)
 	void SetupMenu(const FMultiplayerSessionSettings& InMultiplayerSessionSettings);
 
+	/** Show menu, adding it back to the viewport if a level transition removed it */
+	UFUNCTION(BlueprintCallable)
+	void ShowMenu();
+
+	/** Hide menu, keeping it in the viewport */
+	UFUNCTION(BlueprintCallable)
+	void HideMenu();
+
+	/** Whether the menu is shown */
+	UFUNCTION(BlueprintPure)
+	bool IsMenuVisible() const;
+
+	/** Mark menu as owned by the menu pool */
+	void MarkAsPooled() { bIsPooled = true; }
+
 private:
 
 	/** Callback for HostButton's OnClicked event */
@@ -60,9 +76,12 @@ private:
 	UFUNCTION()
 	void QuitButtonClicked();
 
-	/** Remove menu */
+	/** Callback for SpectateButton's OnClicked event */
 	UFUNCTION()
-	void RemoveMenu();
+	void SpectateButtonClicked();
+
+	/** Button the running find and join were started with, enabled again if they fail */
+	UButton* GetJoinRequestButton() const;
 
 private:
 
@@ -78,19 +97,42 @@ private:
 	UPROPERTY(meta = (BindWidget))
 	TObjectPtr<UButton> QuitButton;
 
+	/** Button used for watching an already existing game session as a spectator. Optional */
+	UPROPERTY(meta = (BindWidgetOptional))
+	TObjectPtr<UButton> SpectateButton;
+
+	/** Tracks whether the running find and join were started for spectating */
+	bool bIsSpectating = false;
+
+	/** Tracks whether the menu is owned by the menu pool */
+	bool bIsPooled = false;
+
 #pragma endregion MENU
 
 #pragma region SESSION
 
 protected:
 
+	/** Bind callbacks to the multiplayer sessions subsystem, if they weren't already */
+	void BindSessionCallbacks();
+
+	/** Callback called when the multiplayer sessions subsystem's online subsystem is ready */
+	UFUNCTION()
+	void OnSubsystemReady(bool bWasSuccessful);
+
 	/** Callback called when the multiplayer session creation is complete */
 	UFUNCTION()
 	void OnCreateSession(bool bWasSuccessful);
 
+	/** Travel to the created session's lobby, listening on it unless the lobby fleet hosts it */
+	void TravelToCreatedSession();
+
 	/** Callback called when the multiplayer sessions finding is complete */
 	void OnFindSessions(const TArray<FOnlineSessionSearchResult>& SessionResults, bool bWasSuccessful);
 
+	/** Callback called when the search confirming the served snapshot is complete, joining the session picked from the snapshot once confirmed, or its replacement */
+	void OnSearchSnapshotRefreshed(const TArray<FOnlineSessionSearchResult>& SessionResults, bool bWasSuccessful);
+
 	/** Callback called when the multiplayer session join is complete */
 	void OnJoinSession(EOnJoinSessionCompleteResult::Type Result);
 
@@ -102,6 +144,9 @@ protected:
 	UFUNCTION()
 	void OnDestroySession(bool bWasSuccessful);
 
+	/** Callback called when the quick match is complete */
+	void OnQuickMatch(EMultiplayerQuickMatchResult Result);
+
 private:
 	
 	/** Subsystem designed to handle all online session functionality */
@@ -112,6 +157,12 @@ private:
 	UPROPERTY()
 	FMultiplayerSessionSettings MultiplayerSessionSettings;
 
+	/** Tracks whether callbacks are bound to the multiplayer sessions subsystem */
+	bool bAreSessionCallbacksBound = false;
+
+	/** Session picked from the served snapshot, joined once the refreshing search confirms or replaces it */
+	TOptional<FOnlineSessionSearchResult> SnapshotPick;
+
 #pragma endregion SESSION
 	
 };
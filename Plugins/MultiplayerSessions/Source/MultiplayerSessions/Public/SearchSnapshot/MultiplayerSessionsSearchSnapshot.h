@@ -0,0 +1,78 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+// Unreal Engine
+#include "CoreMinimal.h"
+
+// Forward declarations - Unreal Engine
+class FOnlineSessionSearchResult;
+
+/** Summary of a session found by a search, with what's needed for joining it without searching again */
+struct MULTIPLAYERSESSIONS_API FMultiplayerSessionsSearchSnapshotEntry
+{
+	/** Address clients can travel to for joining the session */
+	FString Address;
+
+	/** Match type */
+	FString MatchType;
+
+	/** Map the session was playing, if advertised */
+	FString MapName;
+
+	/** Number of public connections still available */
+	int32 NumOpenPublicConnections = 0;
+
+	/** Number of public connections allowed */
+	int32 NumPublicConnections = 0;
+
+	/** Ping to the session's host, in milliseconds */
+	int32 PingInMs = 0;
+
+	/** Fingerprint of the build hosting the session */
+	int32 BuildFingerprint = 0;
+
+	/** Port the session's reservation beacon listens on, on the same host as Address. 0 if the session takes no reservations */
+	int32 BeaconPort = 0;
+
+	/** Time, in UTC, the session was found at */
+	FDateTime FoundTime;
+
+	/** Serialize entry */
+	friend FArchive& operator<<(FArchive& Ar, FMultiplayerSessionsSearchSnapshotEntry& Entry);
+};
+
+/**
+ * Sessions found by the most recent search, stored as a compact binary file so they can be offered on the next start
+ * before a new search completes
+ */
+class MULTIPLAYERSESSIONS_API FMultiplayerSessionsSearchSnapshot
+{
+
+#pragma region SEARCH_SNAPSHOT
+
+public:
+
+	/** Save snapshot to the given file */
+	bool SaveToFile(const FString& Filename) const;
+
+	/** Load snapshot from the given file, mapping it into memory when the platform allows it, replacing current entries */
+	bool LoadFromFile(const FString& Filename);
+
+	/** Remove entries found longer ago than the given age */
+	void RemoveExpiredEntries(const FTimespan& MaxAge);
+
+	/** Convert search result, joined through the given address, into its snapshot entry */
+	static FMultiplayerSessionsSearchSnapshotEntry MakeEntry(const FOnlineSessionSearchResult& SearchResult, const FString& Address);
+
+	/** Convert snapshot entry back into a search result, joined by travelling straight to its address */
+	static FOnlineSessionSearchResult MakeSearchResult(const FMultiplayerSessionsSearchSnapshotEntry& Entry);
+
+public:
+
+	/** Sessions found, in ranking order */
+	TArray<FMultiplayerSessionsSearchSnapshotEntry> Entries;
+
+#pragma endregion SEARCH_SNAPSHOT
+
+};
@@ -0,0 +1,111 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+// Unreal Engine
+#include "CoreMinimal.h"
+
+// MultiplayerSessions
+#include "SessionDirectory/SessionDirectoryEntry.h"
+
+// Forward declarations - Unreal Engine
+class FSocket;
+class FInternetAddr;
+
+DECLARE_DELEGATE_TwoParams(FOnSessionDirectoryQueryComplete, const TArray<FSessionDirectoryEntry>& Entries, bool bWasSuccessful);
+
+/**
+ * Client for the session directory, used by hosts for advertising their sessions and by clients for finding them
+ */
+class MULTIPLAYERSESSIONS_API FSessionDirectoryClient
+{
+
+#pragma region INITIALIZATION
+
+public:
+
+	/** Destructor */
+	~FSessionDirectoryClient();
+
+	/** Open socket used for talking to the directory at the given address (host[:port]) */
+	bool Connect(const FString& DirectoryAddress);
+
+	/** Close socket, failing any pending query */
+	void Disconnect();
+
+	/** Whether the client can talk to the directory */
+	bool IsConnected() const { return Socket != nullptr; }
+
+#pragma endregion INITIALIZATION
+
+#pragma region DIRECTORY
+
+public:
+
+	/** Register session in the directory, or update it if already registered */
+	void RegisterSession(const FSessionDirectoryEntry& Entry);
+
+	/** Refresh session's heartbeat and number of open connections */
+	void HeartbeatSession(const FString& SessionId, int32 NumOpenPublicConnections);
+
+	/** Remove session from the directory */
+	void UnregisterSession(const FString& SessionId);
+
+	/** Find sessions with the given match type (any, if empty) and at least MinOpenPublicConnections open connections */
+	void QuerySessions(const FString& MatchType, int32 MinOpenPublicConnections, int32 MaxResults, const FOnSessionDirectoryQueryComplete& OnComplete);
+
+	/** Process replies and retry or time out pending queries */
+	void Tick();
+
+	/** Whether there are queries waiting for a reply */
+	bool HasPendingQueries() const { return !PendingQueries.IsEmpty(); }
+
+private:
+
+	/** Send message to the directory */
+	void Send(const FString& Message) const;
+
+public:
+
+	/** Time, in seconds, to wait before resending an unanswered query */
+	double QueryRetryInterval = 0.25;
+
+	/** Time, in seconds, after which an unanswered query fails */
+	double QueryTimeout = 2.0;
+
+private:
+
+	/** Query waiting for the directory's reply */
+	struct FPendingQuery
+	{
+		/** Message sent to the directory */
+		FString Message;
+
+		/** Delegate called when the query is complete */
+		FOnSessionDirectoryQueryComplete OnComplete;
+
+		/** Time, in seconds, when the query was first sent */
+		double StartTime = 0.0;
+
+		/** Time, in seconds, when the query was last sent */
+		double LastSendTime = 0.0;
+	};
+
+	/** Socket used for talking to the directory */
+	FSocket* Socket = nullptr;
+
+	/** Address of the directory */
+	TSharedPtr<FInternetAddr> DirectoryAddr;
+
+	/** Queries waiting for the directory's reply, by request id */
+	TMap<int32, FPendingQuery> PendingQueries;
+
+	/** Id for the next query */
+	int32 NextRequestId = 1;
+
+	/** Buffer reused for receiving datagrams */
+	TArray<uint8> ReceiveBuffer;
+
+#pragma endregion DIRECTORY
+
+};
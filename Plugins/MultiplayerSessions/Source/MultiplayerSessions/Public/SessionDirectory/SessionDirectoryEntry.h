@@ -0,0 +1,50 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+// Unreal Engine
+#include "CoreMinimal.h"
+
+#include "SessionDirectoryEntry.generated.h"
+
+/**
+ * Summary of a session registered in the session directory
+ */
+USTRUCT(BlueprintType)
+struct FSessionDirectoryEntry
+{
+	GENERATED_USTRUCT_BODY()
+
+public:
+
+	/** Unique identifier of the session, chosen by its host */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+	FString SessionId;
+
+	/** Match type */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+	FString MatchType;
+
+	/** Address clients can travel to for joining the session */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+	FString Address;
+
+	/** Number of public connections still available */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+	int32 NumOpenPublicConnections = 0;
+
+	/** Number of public connections allowed */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+	int32 NumPublicConnections = 0;
+
+	/** Fingerprint of the build hosting the session */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+	int32 BuildFingerprint = 0;
+
+	/** Port the session's reservation beacon listens on, on the same host as Address. 0 if the session takes no reservations */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+	int32 BeaconPort = 0;
+
+	/** Time, in seconds, of the last heartbeat received by the directory */
+	double LastHeartbeatTime = 0.0;
+};
@@ -0,0 +1,91 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+// Unreal Engine
+#include "CoreMinimal.h"
+
+// MultiplayerSessions
+#include "SessionDirectory/SessionDirectoryEntry.h"
+
+// Forward declarations - Unreal Engine
+class FSocket;
+class FInternetAddr;
+
+/**
+ * Lightweight session directory: hosts register and heartbeat their sessions, clients query them by match type and open slots.
+ * Can be used in-process, or served over UDP by the SessionDirectory commandlet.
+ */
+class MULTIPLAYERSESSIONS_API FSessionDirectoryServer
+{
+
+#pragma region INITIALIZATION
+
+public:
+
+	/** Destructor */
+	~FSessionDirectoryServer();
+
+	/** Start listening for directory requests on the given port */
+	bool Start(int32 Port);
+
+	/** Stop listening for directory requests */
+	void Stop();
+
+	/** Whether the directory is listening for requests */
+	bool IsRunning() const { return Socket != nullptr; }
+
+#pragma endregion INITIALIZATION
+
+#pragma region DIRECTORY
+
+public:
+
+	/** Wait up to WaitTime seconds for requests, process all pending ones and expire stale sessions */
+	void Tick(float WaitTime);
+
+	/** Register session, or update it if already registered */
+	void RegisterSession(const FSessionDirectoryEntry& Entry);
+
+	/** Refresh session's heartbeat and number of open connections */
+	bool HeartbeatSession(const FString& SessionId, int32 NumOpenPublicConnections);
+
+	/** Remove session from directory */
+	void UnregisterSession(const FString& SessionId);
+
+	/** Find sessions with the given match type (any, if empty) and at least MinOpenPublicConnections open connections */
+	void QuerySessions(const FString& MatchType, int32 MinOpenPublicConnections, int32 MaxResults, TArray<FSessionDirectoryEntry>& OutEntries) const;
+
+	/** Remove sessions whose last heartbeat is older than the timeout */
+	void ExpireSessions();
+
+	/** Number of registered sessions */
+	int32 GetNumSessions() const { return Entries.Num(); }
+
+private:
+
+	/** Handle a single request */
+	void HandleMessage(const FString& Message, const FInternetAddr& Sender);
+
+public:
+
+	/** Time, in seconds, after which a session without heartbeats is removed */
+	double HeartbeatTimeout = 15.0;
+
+private:
+
+	/** Socket used for receiving requests */
+	FSocket* Socket = nullptr;
+
+	/** Registered sessions, by session id */
+	TMap<FString, FSessionDirectoryEntry> Entries;
+
+	/** Registered session ids, by match type */
+	TMap<FString, TSet<FString>> SessionIdsByMatchType;
+
+	/** Buffer reused for receiving datagrams */
+	TArray<uint8> ReceiveBuffer;
+
+#pragma endregion DIRECTORY
+
+};
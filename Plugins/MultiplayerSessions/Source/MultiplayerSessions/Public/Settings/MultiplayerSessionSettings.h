@@ -32,4 +32,8 @@ public:
 	/** Path to lobby map */
 	UPROPERTY(EditAnywhere, BlueprintReadWrite)
 	FString PathToLobby;
+
+	/** Whether joining hosts a session when none is found, so players searching at the same time end up in the same lobby */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	bool bUseQuickMatch = false;
 };
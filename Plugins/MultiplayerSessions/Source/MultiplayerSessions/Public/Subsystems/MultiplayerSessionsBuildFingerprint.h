@@ -0,0 +1,44 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+// Unreal Engine
+#include "CoreMinimal.h"
+
+// Forward declarations - Unreal Engine
+class FOnlineSessionSettings;
+class FOnlineSessionSearch;
+class FOnlineSessionSearchResult;
+
+/** Session setting holding the fingerprint of the build hosting the session */
+#define SETTING_BUILDFINGERPRINT FName(TEXT("BuildFingerprint"))
+
+/** Session setting holding the net protocol version of the build hosting the session */
+#define SETTING_NETPROTOCOLVERSION FName(TEXT("NetProtocolVersion"))
+
+namespace MultiplayerSessionsBuildFingerprint
+{
+	/** Fingerprint of this build, generated at compile time from the net protocol, content and engine versions */
+	MULTIPLAYERSESSIONS_API int32 GetLocalFingerprint();
+
+	/** Net protocol version the given fingerprint was generated from */
+	MULTIPLAYERSESSIONS_API int32 GetNetProtocolVersion(int32 Fingerprint);
+
+	/** Whether builds with the given fingerprints can play together: same build, or net protocol versions within the compatibility range */
+	MULTIPLAYERSESSIONS_API bool AreCompatible(int32 Fingerprint, int32 OtherFingerprint, int32 CompatibilityRange);
+
+	/** Advertise this build's fingerprint on the session, as its build unique id and as filterable settings */
+	MULTIPLAYERSESSIONS_API void AdvertiseFingerprint(FOnlineSessionSettings& SessionSettings);
+
+	/** Have the backend only return sessions compatible with this build, as far as its query filters allow */
+	MULTIPLAYERSESSIONS_API void AddQueryFilter(FOnlineSessionSearch& SessionSearch, int32 CompatibilityRange);
+
+	/** Whether the search result is compatible with this build. Results that don't advertise a fingerprint are left to the reservation check */
+	MULTIPLAYERSESSIONS_API bool IsSearchResultCompatible(const FOnlineSessionSearchResult& SearchResult, int32 CompatibilityRange);
+
+	/** Make the engine's net version check agree with the compatibility range, so builds found compatible can also connect */
+	MULTIPLAYERSESSIONS_API void ApplyNetworkCompatibility(int32 CompatibilityRange);
+
+	/** Restore the engine's own net version check */
+	MULTIPLAYERSESSIONS_API void ResetNetworkCompatibility();
+}
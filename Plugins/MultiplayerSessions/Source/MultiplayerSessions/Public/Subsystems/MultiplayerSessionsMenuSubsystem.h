@@ -0,0 +1,54 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+// Unreal Engine
+#include "CoreMinimal.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+
+// MultiplayerSessions
+#include "Settings/MultiplayerSessionSettings.h"
+
+#include "MultiplayerSessionsMenuSubsystem.generated.h"
+
+// Forward declarations - MultiplayerSessions
+class UMenu;
+
+/**
+ * Keeps one menu instance per class alive for the whole game, so returning to the menu after travelling doesn't rebuild it
+ */
+UCLASS()
+class MULTIPLAYERSESSIONS_API UMultiplayerSessionsMenuSubsystem : public UGameInstanceSubsystem
+{
+	GENERATED_BODY()
+
+#pragma region INITIALIZATION
+
+public:
+
+	/** Deinitialize subsystem */
+	virtual void Deinitialize() override;
+
+#pragma endregion INITIALIZATION
+
+#pragma region MENU_POOL
+
+public:
+
+	/** Show pooled menu of the given class, creating it on first use */
+	UFUNCTION(BlueprintCallable, Category = "MultiplayerSessions")
+	UMenu* ShowMenu(TSubclassOf<UMenu> MenuClass, const FMultiplayerSessionSettings& MultiplayerSessionSettings);
+
+	/** Hide every pooled menu */
+	UFUNCTION(BlueprintCallable, Category = "MultiplayerSessions")
+	void HideMenus();
+
+private:
+
+	/** Menus created so far, owned by the game instance so they survive level transitions */
+	UPROPERTY()
+	TMap<TSubclassOf<UMenu>, TObjectPtr<UMenu>> PooledMenus;
+
+#pragma endregion MENU_POOL
+
+};
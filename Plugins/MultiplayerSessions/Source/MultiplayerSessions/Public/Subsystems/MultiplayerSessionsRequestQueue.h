@@ -0,0 +1,120 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+// Unreal Engine
+#include "CoreMinimal.h"
+#include "Async/Future.h"
+
+/**
+ * Serializes requests for a single session operation, handing each one its own future.
+ * The online session interface only reports completions per operation, so requests are issued one at a time, each with a token its completion must carry.
+ * Token 0 is never handed out, so completions of operations made outside of the queue leave it untouched.
+ */
+template<typename ResultType>
+class TMultiplayerSessionsRequestQueue
+{
+
+public:
+
+	/** Queue request, issuing it right away with its token if no other request is in progress */
+	TFuture<ResultType> Enqueue(TFunction<void(uint32 RequestToken)> Issue)
+	{
+		TSharedRef<TPromise<ResultType>> Promise = MakeShared<TPromise<ResultType>>();
+		TFuture<ResultType> Future = Promise->GetFuture();
+
+		if (++LastToken == 0)
+		{
+			++LastToken;
+		}
+		Requests.Add({ Promise, MoveTemp(Issue), LastToken });
+
+		if (!bIsFrontIssued)
+		{
+			IssueFront();
+		}
+
+		return Future;
+	}
+
+	/** Complete request in progress if it has the given token, and issue the next one */
+	void Complete(uint32 RequestToken, const ResultType& Result)
+	{
+		Complete(RequestToken, ResultType(Result));
+	}
+
+	/** Complete request in progress if it has the given token, moving the result into its future, and issue the next one */
+	void Complete(uint32 RequestToken, ResultType&& Result)
+	{
+		if (!bIsFrontIssued || Requests[0].Token != RequestToken)
+		{
+			return;
+		}
+
+		// Queue keeps its allocation, as requests keep coming
+		FRequest Request = MoveTemp(Requests[0]);
+		Requests.RemoveAt(0, 1, false);
+		bIsFrontIssued = false;
+
+		// Continuations may queue further requests, which are issued right away
+		Request.Promise->SetValue(MoveTemp(Result));
+
+		if (!bIsFrontIssued && !Requests.IsEmpty())
+		{
+			IssueFront();
+		}
+	}
+
+	/** Complete every request with the given result, without issuing them */
+	void Reset(const ResultType& Result)
+	{
+		TArray<FRequest> FailedRequests = MoveTemp(Requests);
+		Requests.Reset();
+		bIsFrontIssued = false;
+
+		for (const FRequest& Request : FailedRequests)
+		{
+			Request.Promise->SetValue(Result);
+		}
+	}
+
+	/** Whether a request is in progress */
+	bool IsBusy() const { return bIsFrontIssued; }
+
+private:
+
+	/** Issue request at the front of the queue */
+	void IssueFront()
+	{
+		bIsFrontIssued = true;
+
+		// Issuing may complete the request synchronously, modifying the queue. Requests are only issued once, so the function is moved out rather than copied
+		const TFunction<void(uint32)> Issue = MoveTemp(Requests[0].Issue);
+		Issue(Requests[0].Token);
+	}
+
+private:
+
+	/** Queued request */
+	struct FRequest
+	{
+		/** Promise fulfilled when the request is complete */
+		TSharedRef<TPromise<ResultType>> Promise;
+
+		/** Function issuing the request, given its token */
+		TFunction<void(uint32)> Issue;
+
+		/** Token identifying the request's completion */
+		uint32 Token = 0;
+	};
+
+	/** Queued requests. Front one is in progress when bIsFrontIssued is set */
+	TArray<FRequest> Requests;
+
+	/** Tracks whether the request at the front of the queue was issued */
+	bool bIsFrontIssued = false;
+
+	/** Token handed to the last queued request */
+	uint32 LastToken = 0;
+
+};
@@ -0,0 +1,31 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+// Unreal Engine
+#include "CoreMinimal.h"
+
+// Forward declarations - Unreal Engine
+class FOnlineSessionSearchResult;
+
+/** Criteria search results are filtered and ranked with */
+struct FMultiplayerSessionsSearchFilter
+{
+	/** Match type sessions must have. Empty accepts any match type */
+	FString MatchType;
+
+	/** Maximum number of results kept */
+	int32 MaxResults = 16;
+
+	/** Number of net protocol versions, either side of this build's, sessions may be on. 0 only accepts sessions of this exact build */
+	int32 BuildCompatibilityRange = 0;
+
+	/** Whether sessions with no open public connection left are kept, as spectators watch from private slots */
+	bool bIncludeFullSessions = false;
+};
+
+namespace MultiplayerSessionsSearchRanking
+{
+	/** Filter, score and sort search results in parallel, returning the best ones first. Safe to call off the game thread */
+	MULTIPLAYERSESSIONS_API TArray<FOnlineSessionSearchResult> RankSearchResults(const TArray<FOnlineSessionSearchResult>& SearchResults, const FMultiplayerSessionsSearchFilter& Filter);
+}
@@ -6,22 +6,146 @@
 #include "CoreMinimal.h"
 #include "Subsystems/GameInstanceSubsystem.h"
 #include "Interfaces/OnlineSessionInterface.h"
+#include "Containers/Ticker.h"
+#include "Engine/EngineBaseTypes.h"
+#include "Engine/EngineTypes.h"
 
 // MultiplayerSessions
 #include "Settings/MultiplayerSessionSettings.h"
+#include "Subsystems/MultiplayerSessionsRequestQueue.h"
+#include "Beacons/MultiplayerSessionsBeaconClient.h"
+#include "HostMigration/MultiplayerSessionsHostMigrationRoster.h"
+#include "Trace/MultiplayerSessionsTrace.h"
 
 #include "MultiplayerSessionsSubsystem.generated.h"
 
+// Forward declarations - Unreal Engine
+class AOnlineBeaconHost;
+class UNetDriver;
+
+// Forward declarations - MultiplayerSessions
+class FSessionDirectoryClient;
+class FLobbyFleetClient;
+class AMultiplayerSessionsBeaconHostObject;
+struct FSessionDirectoryEntry;
+class FMultiplayerSessionsTraceRecorder;
+class FMultiplayerSessionsTracePlayer;
+class FMultiplayerSessionsSearchSnapshot;
+
+/** Session setting holding the address of sessions found through the session directory */
+#define SETTING_SESSIONDIRECTORYADDRESS FName(TEXT("SessionDirectoryAddress"))
+
+/** Session setting holding the id sessions found through the session directory were registered with */
+#define SETTING_SESSIONDIRECTORYID FName(TEXT("SessionDirectoryId"))
+
+/** Session setting identifying a hosted session across every backend it's advertised on */
+#define SETTING_SESSIONKEY FName(TEXT("SessionKey"))
+
+/** Session setting holding the name of the online subsystem a search result was found through */
+#define SETTING_SEARCHONLINESUBSYSTEM FName(TEXT("SearchOnlineSubsystem"))
+
+/** Outcome of a quick match */
+enum class EMultiplayerQuickMatchResult : uint8
+{
+	/** Joined an existing session */
+	Joined,
+
+	/** No session was found, so one was created */
+	Created,
+
+	/** Neither joining nor creating a session succeeded */
+	Failed
+};
+
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FMultiplayerOnCreateSessionCompleteSignature, bool, bWasSuccessful);
 DECLARE_MULTICAST_DELEGATE_TwoParams(FMultiplayerOnFindSessionsCompleteSignature, const TArray<FOnlineSessionSearchResult>& SessionResults, bool bWasSuccessful);
 DECLARE_MULTICAST_DELEGATE_OneParam(FMultiplayerOnJoinSessionCompleteSignature, EOnJoinSessionCompleteResult::Type Result);
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FMultiplayerOnStartSessionCompleteSignature, bool, bWasSuccessful);
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FMultiplayerOnDestroySessionCompleteSignature, bool, bWasSuccessful);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FMultiplayerOnSubsystemReadySignature, bool, bWasSuccessful);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FMultiplayerOnHostMigrationStartedSignature, bool, bIsNewHost);
+DECLARE_MULTICAST_DELEGATE_TwoParams(FMultiplayerOnSearchSnapshotRefreshedSignature, const TArray<FOnlineSessionSearchResult>& SessionResults, bool bWasSuccessful);
+DECLARE_MULTICAST_DELEGATE_OneParam(FMultiplayerOnQuickMatchCompleteSignature, EMultiplayerQuickMatchResult Result);
+
+/** Result of a find sessions request */
+struct FMultiplayerFindSessionsResult
+{
+	/** Sessions found */
+	TArray<FOnlineSessionSearchResult> SessionResults;
+
+	/** Whether the search succeeded */
+	bool bWasSuccessful = false;
+};
+
+/** Search running on one of the backends of a multi-backend search */
+struct FMultiplayerBackendSearch
+{
+	/** Name of the backend's online subsystem */
+	FName SubsystemName = NAME_None;
+
+	/** Backend's session interface */
+	IOnlineSessionPtr SessionInterface;
+
+	/** Backend's own search */
+	TSharedPtr<FOnlineSessionSearch> SessionSearch;
+
+	/** Handle for the backend's find sessions complete delegate */
+	FDelegateHandle FindSessionsCompleteDelegateHandle;
+
+	/** Whether the backend answered */
+	bool bIsComplete = false;
+
+	/** Whether the backend's search succeeded */
+	bool bWasSuccessful = false;
+};
+
+/** Join target prepared when a session is chosen, ahead of its join completing */
+struct FMultiplayerJoinTarget
+{
+	/** Address of the session, resolved when it was chosen */
+	FString ConnectString;
+
+	/** Name of the session's map, preloaded while joining */
+	FString MapName;
+};
+
+/** Latency statistics of a session operation, from the request to its completion */
+struct FMultiplayerSessionsOperationStats
+{
+	/** Number of latency buckets */
+	static constexpr int32 NumLatencyBuckets = 9;
+
+	/** Upper bounds, in seconds, of the latency buckets */
+	static constexpr double LatencyBucketBounds[NumLatencyBuckets] = { 0.05, 0.1, 0.25, 0.5, 1.0, 2.5, 5.0, 10.0, 30.0 };
+
+	/** Number of requests completed within each bucket's bound, slower ones only being counted in the totals */
+	int32 LatencyBucketCounts[NumLatencyBuckets] = {};
+
+	/** Number of requests completed */
+	int32 NumCompleted = 0;
+
+	/** Number of requests that failed */
+	int32 NumFailed = 0;
+
+	/** Total latency, in seconds, of the completed requests */
+	double TotalLatency = 0.0;
+
+	/** Number of session settings and search objects allocated for requests, rather than reused from the pool */
+	int32 NumAllocations = 0;
+};
+
+/** Progress of a host migration on this instance */
+enum class EMultiplayerHostMigrationState : uint8
+{
+	None,
+	BecomingHost,
+	JoiningNewHost
+};
 
 /**
  * 
  */
-UCLASS()
+UCLASS(config=Game)
 class MULTIPLAYERSESSIONS_API UMultiplayerSessionsSubsystem : public UGameInstanceSubsystem
 {
 	GENERATED_BODY()
@@ -30,8 +154,51 @@ class MULTIPLAYERSESSIONS_API UMultiplayerSessionsSubsystem : public UGameInstan
 	
 public:
 
-	/** Constructor */
-	UMultiplayerSessionsSubsystem();
+	/** Initialize subsystem */
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+
+	/** Deinitialize subsystem */
+	virtual void Deinitialize() override;
+
+	/** Whether the online subsystem has been warmed up and the session interface is available */
+	UFUNCTION(BlueprintPure)
+	bool IsOnlineSubsystemReady() const { return bIsOnlineSubsystemReady; }
+
+private:
+
+	/** Ticker callback used for warming up the online subsystem outside of the subsystem's initialization */
+	bool WarmUpOnlineSubsystem(float DeltaTime);
+
+	/** Get online subsystem and session interface, if they weren't already */
+	bool InitializeOnlineSubsystem();
+
+public:
+
+	/** Delegate called when the online subsystem's warm up is complete */
+	UPROPERTY(BlueprintAssignable)
+	FMultiplayerOnSubsystemReadySignature MultiplayerOnSubsystemReadyDelegate;
+
+private:
+
+	/** Handle for the ticker used for warming up the online subsystem */
+	FTSTicker::FDelegateHandle WarmUpTickerHandle;
+
+	/** Tracks whether the online subsystem's warm up is complete and its session interface was found */
+	bool bIsOnlineSubsystemReady = false;
+
+	/** Time, in seconds, waited before trying to get the online subsystem again */
+	UPROPERTY(Config)
+	float OnlineSubsystemRetryDelay = 2.f;
+
+	/** Number of times getting the online subsystem is tried again before reporting the failure */
+	UPROPERTY(Config)
+	int32 MaxOnlineSubsystemRetries = 5;
+
+	/** Number of times getting the online subsystem was tried again since the last report */
+	int32 NumOnlineSubsystemRetries = 0;
+
+	/** Name of the online subsystem in use */
+	FName OnlineSubsystemName = NAME_None;
 
 #pragma endregion INITIALIZATION
 
@@ -40,13 +207,13 @@ public:
 public:
 	
 	/** Create session */
-	void CreateSession(int32 NumPublicConnections, FString MatchType);
+	void CreateSession(int32 NumPublicConnections, const FString& MatchType);
 	
-	/** Find sessions */
-	void FindSessions(int32 MaxSearchResults);
+	/** Find sessions, keeping the best ranked ones of the given match type (any match type if empty). Searches for spectators keep full sessions too */
+	void FindSessions(int32 MaxSearchResults, const FString& MatchType = FString(), bool bForSpectators = false);
 
-	/** Join session */
-	void JoinSession(const FOnlineSessionSearchResult& SessionResult);
+	/** Join session, as a spectator watching from one of its private slots if asked to */
+	void JoinSession(const FOnlineSessionSearchResult& SessionResult, bool bAsSpectator = false);
 	
 	/** Start session */
 	void StartSession();
@@ -54,8 +221,62 @@ public:
 	/** Destroy session */
 	void DestroySession();
 
+	/** Get address used for travelling to the joined session */
+	bool GetResolvedConnectString(FString& OutAddress) const;
+
+	/** Create session, returning a future holding this request's result */
+	TFuture<bool> CreateSessionAsync(int32 NumPublicConnections, const FString& MatchType);
+
+	/** Find sessions, returning a future holding this request's results */
+	TFuture<FMultiplayerFindSessionsResult> FindSessionsAsync(int32 MaxSearchResults, const FString& MatchType = FString(), bool bForSpectators = false);
+
+	/** Join session, returning a future holding this request's result */
+	TFuture<EOnJoinSessionCompleteResult::Type> JoinSessionAsync(const FOnlineSessionSearchResult& SessionResult, bool bAsSpectator = false);
+
+	/** Start session, returning a future holding this request's result */
+	TFuture<bool> StartSessionAsync();
+
+	/** Destroy session, returning a future holding this request's result */
+	TFuture<bool> DestroySessionAsync();
+
 protected:
 
+	/** Create session on behalf of the future based request with the given token, 0 for requests made on behalf of another one */
+	void IssueCreateSession(int32 NumPublicConnections, const FString& MatchType, uint32 RequestToken);
+
+	/** Find sessions on behalf of the future based request with the given token, 0 for requests made on behalf of another one */
+	void IssueFindSessions(int32 MaxSearchResults, const FString& MatchType, bool bForSpectators, uint32 RequestToken);
+
+	/** Join session on behalf of the future based request with the given token, 0 for requests made on behalf of another one */
+	void IssueJoinSession(const FOnlineSessionSearchResult& SessionResult, bool bAsSpectator, uint32 RequestToken);
+
+	/** Start session on behalf of the future based request with the given token, 0 for requests made on behalf of another one */
+	void IssueStartSession(uint32 RequestToken);
+
+	/** Destroy session on behalf of the future based request with the given token, 0 for requests made on behalf of another one */
+	void IssueDestroySession(uint32 RequestToken);
+
+	/** Complete create session request, notifying the future of the request with the given token, if any, and the multicast delegate */
+	void CompleteCreateSession(bool bWasSuccessful, uint32 RequestToken);
+
+	/** Complete find sessions request, notifying the multicast delegate and moving the results into the future of the request with the given token, if any */
+	void CompleteFindSessions(TArray<FOnlineSessionSearchResult> SessionResults, bool bWasSuccessful, uint32 RequestToken);
+
+	/** Complete join session request, notifying the future of the request with the given token, if any, and the multicast delegate */
+	void CompleteJoinSession(EOnJoinSessionCompleteResult::Type Result, uint32 RequestToken);
+
+	/** Complete start session request, notifying the future of the request with the given token, if any, and the multicast delegate */
+	void CompleteStartSession(bool bWasSuccessful, uint32 RequestToken);
+
+	/** Complete destroy session request, notifying the future of the request with the given token, if any, and the multicast delegate */
+	void CompleteDestroySession(bool bWasSuccessful, uint32 RequestToken);
+
+	/** Filter, score and sort search results on worker threads, completing the find sessions request with the best ones */
+	void RankSearchResults(const TSharedRef<FOnlineSessionSearch>& SessionSearch, bool bWasSuccessful);
+
+	/** Join session, once a slot was reserved for it or when reservations aren't used */
+	void JoinReservedSession(const FOnlineSessionSearchResult& SessionResult);
+
 	/** Callback bound to the delegate used for creating the session is completed */
 	void OnCreateSessionComplete(FName SessionName, bool bWasSuccessful);
 
@@ -93,12 +314,35 @@ private:
 	/** Pointer to the online session interface */
 	IOnlineSessionPtr SessionInterface;
 
+	/** Session interface of the backend the current session was joined through, when it's not the default one */
+	IOnlineSessionPtr JoinedSessionInterface;
+
+	/** Session interface the session is being destroyed through */
+	IOnlineSessionPtr DestroyingSessionInterface;
+
 	/** Last online session's settings */
 	TSharedPtr<FOnlineSessionSettings> LastSessionSettings;
 
 	/** Last online session search */
 	TSharedPtr<FOnlineSessionSearch> LastSessionSearch;
 
+	/** Match type requested by the last online session search */
+	FString LastSearchMatchType;
+
+	/** Maximum number of results requested by the last online session search, 0 or less leaving it to SearchResultsTopK */
+	int32 LastSearchMaxResults = 0;
+
+	/** Whether the last online session search was made for spectators, keeping sessions with no open public connection left */
+	bool bLastSearchForSpectators = false;
+
+	/** Maximum number of ranked search results handed back to the game thread, further capping the number requested by the search */
+	UPROPERTY(Config)
+	int32 SearchResultsTopK = 16;
+
+	/** Number of net protocol versions, either side of this build's, sessions may be on during rolling updates. 0 only finds sessions of this exact build */
+	UPROPERTY(Config)
+	int32 BuildCompatibilityRange = 0;
+
 	/** Delegate called by the Online Session Interface when creating the session is completed */
 	FOnCreateSessionCompleteDelegate CreateSessionCompleteDelegate;
 
@@ -135,5 +379,647 @@ private:
 	/** Last multiplayer session settings */
 	FMultiplayerSessionSettings LastMultiplayerSessionSettings;
 
+	/** Create session requests made through the future based API */
+	TMultiplayerSessionsRequestQueue<bool> CreateSessionRequests;
+
+	/** Find sessions requests made through the future based API */
+	TMultiplayerSessionsRequestQueue<FMultiplayerFindSessionsResult> FindSessionsRequests;
+
+	/** Join session requests made through the future based API */
+	TMultiplayerSessionsRequestQueue<EOnJoinSessionCompleteResult::Type> JoinSessionRequests;
+
+	/** Start session requests made through the future based API */
+	TMultiplayerSessionsRequestQueue<bool> StartSessionRequests;
+
+	/** Destroy session requests made through the future based API */
+	TMultiplayerSessionsRequestQueue<bool> DestroySessionRequests;
+
+	/** Token of the future based create session request in flight, 0 if none */
+	uint32 CreateSessionRequestToken = 0;
+
+	/** Token of the future based find sessions request in flight, 0 if none */
+	uint32 FindSessionsRequestToken = 0;
+
+	/** Token of the future based join session request in flight, 0 if none */
+	uint32 JoinSessionRequestToken = 0;
+
+	/** Token of the future based start session request in flight, 0 if none */
+	uint32 StartSessionRequestToken = 0;
+
+	/** Token of the future based destroy session request in flight, 0 if none */
+	uint32 DestroySessionRequestToken = 0;
+
 #pragma endregion SESSION
+
+#pragma region SESSION_DIRECTORY
+
+public:
+
+	/** Whether sessions are advertised and found through the session directory, instead of the online subsystem's search */
+	bool IsUsingSessionDirectory() const;
+
+private:
+
+	/** Ticker callback used for processing session directory replies and heartbeats */
+	bool TickSessionDirectory(float DeltaTime);
+
+	/** Register the created session in the session directory */
+	void RegisterDirectorySession();
+
+	/** Remove the created session from the session directory */
+	void UnregisterDirectorySession();
+
+	/** Callback called when the session directory query is complete */
+	void OnDirectoryQueryComplete(const TArray<FSessionDirectoryEntry>& Entries, bool bWasSuccessful);
+
+private:
+
+	/** Address (host[:port]) of the session directory. Empty disables it */
+	UPROPERTY(Config)
+	FString SessionDirectoryAddress;
+
+	/** Time, in seconds, between heartbeats sent to the session directory */
+	UPROPERTY(Config)
+	float SessionDirectoryHeartbeatInterval = 5.f;
+
+	/** Client used for talking to the session directory */
+	TSharedPtr<FSessionDirectoryClient> SessionDirectoryClient;
+
+	/** Handle for the ticker used for the session directory */
+	FTSTicker::FDelegateHandle SessionDirectoryTickerHandle;
+
+	/** Id of the session registered in the session directory, if any */
+	FString DirectorySessionId;
+
+	/** Time, in seconds, of the last heartbeat sent to the session directory */
+	double LastDirectoryHeartbeatTime = 0.0;
+
+	/** Address of the session joined through the session directory, if any */
+	FString DirectoryConnectString;
+
+#pragma endregion SESSION_DIRECTORY
+
+#pragma region LOBBY_FLEET
+
+public:
+
+	/** Whether created sessions are hosted by one of the lobby fleet's servers, instead of by this player as a listen server */
+	bool IsUsingLobbyFleet() const;
+
+	/** Address of the lobby the fleet hosted for the last created session, which players travel to instead of listening themselves */
+	bool GetFleetLobbyAddress(FString& OutAddress) const;
+
+private:
+
+	/** Ticker callback used for processing lobby fleet replies */
+	bool TickLobbyFleet(float DeltaTime);
+
+	/** Callback called when the lobby fleet request is complete */
+	void OnLobbyFleetRequestComplete(const FString& Address, bool bWasSuccessful);
+
+private:
+
+	/** Address (host[:port]) of the lobby fleet manager hosting created sessions. Empty hosts them as listen servers */
+	UPROPERTY(Config)
+	FString LobbyFleetAddress;
+
+	/** Client used for talking to the lobby fleet manager */
+	TSharedPtr<FLobbyFleetClient> LobbyFleetClient;
+
+	/** Handle for the ticker used for the lobby fleet */
+	FTSTicker::FDelegateHandle LobbyFleetTickerHandle;
+
+	/** Address of the lobby hosted by the fleet for the last created session, if any */
+	FString FleetLobbyAddress;
+
+#pragma endregion LOBBY_FLEET
+
+#pragma region SESSION_RESERVATION
+
+private:
+
+	/** Request a slot to the next candidate session's beacon, joining it once reserved */
+	void TryNextReservationCandidate();
+
+	/** Callback called when the slot reservation request is complete */
+	void OnReservationComplete(EMultiplayerReservationResult Result);
+
+	/** Get address of the candidate session's reservation beacon */
+	bool GetBeaconConnectString(const FOnlineSessionSearchResult& SessionResult, FString& OutConnectInfo) const;
+
+	/** Port this instance's reservation beacon listens on. Overridden by -BeaconPort=, which lobby fleet servers sharing a machine are started with */
+	static int32 GetBeaconListenPort();
+
+	/** Destroy reservation beacon client, once it's done with its current callback */
+	void DestroyReservationBeaconClient();
+
+	/** Callback called when a map is loaded, used for starting the hosted session's services and resuming host migrations */
+	void OnPostLoadMapWithWorld(UWorld* LoadedWorld);
+
+	/** Start the hosted session's services on the given world: map advertisement, reservation beacon and host migration roster */
+	void StartHostingServices(UWorld* World);
+
+	/** Start listening for reservation requests for the hosted session */
+	void StartReservationBeaconHost(UWorld* World);
+
+	/** Stop listening for reservation requests */
+	void StopReservationBeaconHost();
+
+private:
+
+	/** Whether a slot is reserved through the host's beacon before joining a session */
+	UPROPERTY(Config)
+	bool bUseReservationBeacon = true;
+
+	/** Whether sessions whose beacon can't be reached are joined anyway, instead of counting as a failed reservation */
+	UPROPERTY(Config)
+	bool bJoinWhenReservationBeaconUnreachable = false;
+
+	/** Beacon client used for the current reservation request */
+	TWeakObjectPtr<AMultiplayerSessionsBeaconClient> ReservationBeaconClient;
+
+	/** Session whose slot is currently being reserved */
+	FOnlineSessionSearchResult ReservationCandidate;
+
+	/** Sessions waiting for a reservation attempt, in the order they were requested */
+	TArray<FOnlineSessionSearchResult> ReservationCandidates;
+
+	/** Result of the last rejected reservation */
+	EMultiplayerReservationResult LastReservationResult = EMultiplayerReservationResult::Success;
+
+	/** Beacon host listening for reservation requests for the hosted session */
+	TWeakObjectPtr<AOnlineBeaconHost> ReservationBeaconHost;
+
+	/** Beacon host object answering reservation requests for the hosted session */
+	TWeakObjectPtr<AMultiplayerSessionsBeaconHostObject> ReservationBeaconHostObject;
+
+	/** Handle for the delegate called when a map is loaded */
+	FDelegateHandle PostLoadMapDelegateHandle;
+
+	/** Tracks whether this instance created the current session */
+	bool bIsHostingSession = false;
+
+#pragma endregion SESSION_RESERVATION
+
+#pragma region HOST_MIGRATION
+
+public:
+
+	/** Cache roster replicated by the host, used for electing a successor if the host leaves */
+	void CacheHostMigrationRoster(const FMultiplayerHostMigrationRoster& Roster);
+
+	/** Whether a host migration is in progress */
+	bool IsMigratingHost() const { return HostMigrationState != EMultiplayerHostMigrationState::None; }
+
+private:
+
+	/** Callback called when a net driver fails, used for detecting the host leaving */
+	void OnNetworkFailure(UWorld* World, UNetDriver* NetDriver, ENetworkFailure::Type FailureType, const FString& ErrorString);
+
+	/** Elect successor out of the cached roster, if it was still fresh when the host was last heard from, and start migrating to it */
+	void BeginHostMigration(double HostLastHeardTime);
+
+	/** Continue host migration once the map loaded after the host left */
+	void ContinueHostMigration();
+
+	/** Search for the session re-created by the elected successor, so its address is resolved by the session interface */
+	void TravelToMigratedHost();
+
+	/** Travel to the session re-created by the elected successor, or try again later if it isn't advertised yet */
+	void OnHostMigrationSearchComplete(const FMultiplayerFindSessionsResult& Result);
+
+	/** Arm the next attempt at reaching the successor, or give up once out of attempts */
+	void RetryHostMigrationTravel(const FString& Reason);
+
+	/** Stop host migration, forgetting the cached roster */
+	void ResetHostMigration();
+
+	/** Start replicating the hosted session's roster */
+	void StartHostMigrationRoster(UWorld* World);
+
+	/** Stop replicating the hosted session's roster */
+	void StopHostMigrationRoster();
+
+public:
+
+	/** Delegate called when the host left and a migration to a successor started */
+	UPROPERTY(BlueprintAssignable)
+	FMultiplayerOnHostMigrationStartedSignature MultiplayerOnHostMigrationStartedDelegate;
+
+private:
+
+	/** Whether clients re-create the session on a successor when the host leaves */
+	UPROPERTY(Config)
+	bool bEnableHostMigration = true;
+
+	/** Time, in seconds, clients give the successor for re-creating the session before travelling to it */
+	UPROPERTY(Config)
+	float HostMigrationTravelDelay = 3.f;
+
+	/** Number of times clients try to reach the successor before giving up */
+	UPROPERTY(Config)
+	int32 HostMigrationMaxTravelAttempts = 3;
+
+	/** Maximum number of sessions searched when looking for the session re-created by the successor */
+	UPROPERTY(Config)
+	int32 HostMigrationMaxSearchResults = 100;
+
+	/** Time, in seconds, after which a roster or a player's heartbeat in it is too old for electing a successor */
+	UPROPERTY(Config)
+	float HostMigrationMaxHeartbeatAge = 5.f;
+
+	/** Last roster replicated by the host */
+	FMultiplayerHostMigrationRoster CachedHostMigrationRoster;
+
+	/** Time, in seconds, the last roster was received at */
+	double CachedHostMigrationRosterTime = 0.0;
+
+	/** Progress of the current host migration */
+	EMultiplayerHostMigrationState HostMigrationState = EMultiplayerHostMigrationState::None;
+
+	/** Unique net id, as a string, of the elected successor */
+	FString HostMigrationSuccessorId;
+
+	/** Address of the session re-created by the elected successor, once found */
+	FString HostMigrationConnectString;
+
+	/** Number of times this client tried to reach the successor */
+	int32 HostMigrationTravelAttempts = 0;
+
+	/** Handle for the timer used for travelling to the successor */
+	FTimerHandle HostMigrationTimerHandle;
+
+	/** Actor replicating the hosted session's roster */
+	TWeakObjectPtr<AMultiplayerSessionsHostMigrationRoster> HostMigrationRoster;
+
+	/** Handle for the delegate called when a net driver fails */
+	FDelegateHandle NetworkFailureDelegateHandle;
+
+#pragma endregion HOST_MIGRATION
+
+#pragma region SESSION_TRACE
+
+public:
+
+	/** Whether session requests are answered by a recorded trace, instead of the session interface */
+	bool IsReplayingSessionTrace() const { return SessionTracePlayer.IsValid(); }
+
+private:
+
+	/** Start recording or replaying session requests, as configured */
+	void StartSessionTrace();
+
+	/** Stop recording or replaying session requests, saving the recorded trace */
+	void StopSessionTrace();
+
+	/** Record request made to the session interface, with the parameters it was made with, if recording */
+	void RecordSessionRequest(EMultiplayerSessionsTraceOperation Operation, TMap<FString, FString> Parameters = TMap<FString, FString>());
+
+	/** Record result returned by the session interface, if recording, and save the trace so far */
+	void RecordSessionResult(EMultiplayerSessionsTraceOperation Operation, bool bWasSuccessful, uint8 JoinResult = 0, const TArray<FOnlineSessionSearchResult>* SearchResults = nullptr);
+
+	/** Answer request with the next recorded result of its operation, after its recorded latency */
+	void ReplaySessionRequest(EMultiplayerSessionsTraceOperation Operation);
+
+private:
+
+	/** File session requests are recorded to, relative to the saved directory. Empty disables recording. Overridden by -SessionTraceRecord= */
+	UPROPERTY(Config)
+	FString SessionTraceRecordFile;
+
+	/** File session requests are replayed from, relative to the saved directory. Empty disables replay. Overridden by -SessionTraceReplay= */
+	UPROPERTY(Config)
+	FString SessionTraceReplayFile;
+
+	/** Scale applied to replayed latencies. Overridden by -SessionTraceTimeScale= */
+	UPROPERTY(Config)
+	float SessionTraceTimeScale = 1.f;
+
+	/** Recorder capturing session interface traffic, if recording */
+	TSharedPtr<FMultiplayerSessionsTraceRecorder> SessionTraceRecorder;
+
+	/** Player answering session requests, if replaying */
+	TSharedPtr<FMultiplayerSessionsTracePlayer> SessionTracePlayer;
+
+	/** Handles for the tickers completing replayed requests */
+	TArray<FTSTicker::FDelegateHandle> SessionTraceTickerHandles;
+
+#pragma endregion SESSION_TRACE
+
+#pragma region MULTI_BACKEND_SEARCH
+
+public:
+
+	/** Whether sessions are searched for on several online subsystems at once */
+	bool IsUsingMultiBackendSearch() const { return !SearchOnlineSubsystems.IsEmpty(); }
+
+private:
+
+	/** Session interface the current session lives in */
+	IOnlineSessionPtr GetActiveSessionInterface() const;
+
+	/** Session interface of the backend the search result was found through */
+	IOnlineSessionPtr GetSearchResultSessionInterface(const FOnlineSessionSearchResult& SessionResult) const;
+
+	/** Start searching on every configured backend */
+	void FindSessionsOnBackends(int32 MaxSearchResults);
+
+	/** Callback called when a backend's search is complete, merging its results */
+	void OnBackendFindSessionsComplete(bool bWasSuccessful, FName SubsystemName);
+
+	/** Ticker callback completing the search with the results merged so far, once slower backends took too long */
+	bool OnBackendSearchTimeout(float DeltaTime);
+
+	/** Complete multi-backend search with the merged results */
+	void FinishBackendSearches();
+
+	/** Stop waiting for backends' searches */
+	void CancelBackendSearches();
+
+	/** Advertise the created session on the other configured backends */
+	void MirrorSessionToBackends();
+
+	/** Remove the created session from the other configured backends */
+	void DestroyMirroredSessions();
+
+private:
+
+	/** Online subsystems searched at once (e.g. Steam and NULL for LAN). Empty only searches the default one */
+	UPROPERTY(Config)
+	TArray<FName> SearchOnlineSubsystems;
+
+	/** Time, in seconds, backends are waited for once searches started, before completing with the sessions merged so far */
+	UPROPERTY(Config)
+	float MultiBackendSearchTimeout = 3.f;
+
+	/** Searches running on each backend */
+	TArray<FMultiplayerBackendSearch> BackendSearches;
+
+	/** Keys of the sessions merged so far, so sessions advertised on several backends are only kept once */
+	TSet<FString> MergedSessionKeys;
+
+	/** Handle for the ticker bounding the wait for slower backends */
+	FTSTicker::FDelegateHandle BackendSearchTimeoutHandle;
+
+	/** Backends the created session was mirrored to */
+	TArray<FName> MirroredSessionSubsystems;
+
+#pragma endregion MULTI_BACKEND_SEARCH
+
+#pragma region JOIN_PIPELINE
+
+private:
+
+	/** Id the chosen session's prepared join target is kept under: its session id, or its address for session directory entries */
+	static FString GetJoinTargetId(const FOnlineSessionSearchResult& SessionResult);
+
+	/** Resolve the chosen session's address and start loading its map, so both are ready by the time the join completes */
+	void PrepareJoinTarget(const FOnlineSessionSearchResult& SessionResult);
+
+	/** Callback called when the chosen session's map is loaded in the background */
+	void OnJoinTargetMapPreloaded(const FName& PackageName, UPackage* LoadedPackage, EAsyncLoadingResult::Type Result);
+
+	/** Forget the join target prepared under the given id, letting its preloaded map be unloaded unless another target shares it */
+	void ReleaseJoinTarget(const FString& JoinTargetId);
+
+	/** Forget every prepared join target, letting their preloaded maps be unloaded */
+	void ReleaseJoinTargets();
+
+	/** Advertise the hosted session's map, so joining clients can preload it */
+	void AdvertiseHostedMap(UWorld* World);
+
+private:
+
+	/** Whether the chosen session's map is loaded in the background while joining */
+	UPROPERTY(Config)
+	bool bPreloadJoinTargetMap = true;
+
+	/** Join targets prepared for the chosen sessions, by join target id, as several may be joined or reserved in turn */
+	TMap<FString, FMultiplayerJoinTarget> PreparedJoinTargets;
+
+	/** Join target id of the session being joined, whose prepared address is used for travelling */
+	FString JoiningTargetId;
+
+	/** Names of the maps being preloaded for the chosen sessions */
+	TSet<FString> PreloadingMapNames;
+
+	/** Worlds of the maps preloaded for the chosen sessions, by map name. Referencing the world keeps it, and its package, loaded until travelling */
+	UPROPERTY()
+	TMap<FString, TObjectPtr<UWorld>> PreloadedMapWorlds;
+
+#pragma endregion JOIN_PIPELINE
+
+#pragma region OPERATION_STATS
+
+public:
+
+	/** Get latency statistics of the given session operation */
+	FMultiplayerSessionsOperationStats GetOperationStats(EMultiplayerSessionsTraceOperation Operation) const { return OperationStats.FindRef(Operation); }
+
+private:
+
+	/** Start timing a request, unless one of the same operation is already in flight */
+	void BeginOperationTiming(EMultiplayerSessionsTraceOperation Operation);
+
+	/** Stop timing a request, adding its latency to the operation's statistics */
+	void EndOperationTiming(EMultiplayerSessionsTraceOperation Operation, bool bWasSuccessful);
+
+	/** Count an allocation made for a request of the given operation */
+	void CountOperationAllocation(EMultiplayerSessionsTraceOperation Operation);
+
+	/** Add a completed request's latency to the given statistics */
+	static void AddOperationLatency(FMultiplayerSessionsOperationStats& Stats, double Latency, bool bWasSuccessful);
+
+private:
+
+	/** Time, in seconds, requests in flight were made at */
+	TMap<EMultiplayerSessionsTraceOperation, double> OperationStartTimes;
+
+	/** Latency statistics of each session operation */
+	TMap<EMultiplayerSessionsTraceOperation, FMultiplayerSessionsOperationStats> OperationStats;
+
+#pragma endregion OPERATION_STATS
+
+#pragma region SESSION_POOL
+
+private:
+
+	/** Reset last session's settings for a new session, only allocating new ones while something else still holds them */
+	void ResetSessionSettings();
+
+	/** Search ready for a new request, reused from the pool when no search in flight or being ranked still holds it */
+	TSharedRef<FOnlineSessionSearch> AcquireSessionSearch(int32 MaxSearchResults);
+
+private:
+
+	/** Maximum number of searches kept for reuse, enough for a search per backend while the previous one is being ranked */
+	static constexpr int32 MaxPooledSessionSearches = 8;
+
+	/** Searches kept for reuse */
+	TArray<TSharedRef<FOnlineSessionSearch>> SessionSearchPool;
+
+	/** Automation test checking that pooled searches are reused */
+	friend class FMultiplayerSessionsSessionSearchPoolTest;
+
+#pragma endregion SESSION_POOL
+
+#pragma region SEARCH_SNAPSHOT
+
+private:
+
+	/** Load sessions found by the last run's search, if they're recent enough to be joined */
+	void LoadSearchSnapshot();
+
+	/** Save ranked search results, so they can be offered on the next start */
+	void SaveSearchSnapshot(const TArray<FOnlineSessionSearchResult>& SessionResults) const;
+
+	/** Complete find sessions request with the loaded snapshot's sessions, if any matches. Only done once, on the first search */
+	bool ServeSearchSnapshot(int32 MaxSearchResults, const FString& MatchType);
+
+	/** Full path of the search snapshot file */
+	FString GetSearchSnapshotPath() const;
+
+public:
+
+	/** Whether the last search was served with the snapshot and is still being confirmed in the background. Its sessions may be gone or full, so they should only be joined once refreshed */
+	bool IsRefreshingSearchSnapshot() const { return bIsRefreshingSearchSnapshot; }
+
+	/** Session to join in place of one picked from the served snapshot: the same session if the refreshing search found it with room left, else the best one of its match type with room left. Spectator searches don't need room left */
+	const FOnlineSessionSearchResult* FindRefreshedSearchResult(const TArray<FOnlineSessionSearchResult>& SessionResults, const FOnlineSessionSearchResult& SnapshotResult) const;
+
+	/** Get statistics of the time taken to confirm the served snapshot, from serving it to the refreshing search's completion */
+	const FMultiplayerSessionsOperationStats& GetSearchSnapshotRefreshStats() const { return SearchSnapshotRefreshStats; }
+
+	/** Delegate called when the search started in the background after serving the snapshot is complete, confirming or replacing the snapshot's sessions */
+	FMultiplayerOnSearchSnapshotRefreshedSignature MultiplayerOnSearchSnapshotRefreshedDelegate;
+
+private:
+
+	/** File the last search results are saved to, relative to the saved directory. Empty disables the snapshot */
+	UPROPERTY(Config)
+	FString SearchSnapshotFile;
+
+	/** Time, in seconds, sessions in the snapshot are still considered joinable */
+	UPROPERTY(Config)
+	float SearchSnapshotMaxAge = 120.f;
+
+	/** Snapshot loaded on start, until the first search is served with it */
+	TSharedPtr<FMultiplayerSessionsSearchSnapshot> SearchSnapshot;
+
+	/** Whether the running search confirms the served snapshot, its request having already been completed */
+	bool bIsRefreshingSearchSnapshot = false;
+
+	/** Time, in seconds, the snapshot was served at */
+	double SearchSnapshotServeTime = 0.0;
+
+	/** Statistics of the time taken to confirm the served snapshot */
+	FMultiplayerSessionsOperationStats SearchSnapshotRefreshStats;
+
+#pragma endregion SEARCH_SNAPSHOT
+
+#pragma region QUICK_MATCH
+
+public:
+
+	/** Join the best session of the given match type, creating one if none is found after re-checking with a randomized back-off */
+	void QuickMatch(int32 NumPublicConnections, const FString& MatchType, int32 MaxSearchResults);
+
+	/** Whether a quick match is running, its searches, joins and creation being part of it */
+	bool IsQuickMatchInProgress() const { return bIsQuickMatchInProgress; }
+
+private:
+
+	/** Search for the quick match's sessions */
+	void SearchQuickMatch();
+
+	/** Join the best session found, or keep looking */
+	void OnQuickMatchSearchComplete(const FMultiplayerFindSessionsResult& Result);
+
+	/** Join the picked session, or keep looking if there's none */
+	void JoinQuickMatchSession(const FOnlineSessionSearchResult* SessionResult);
+
+	/** Callback called when the search confirming the served snapshot is complete, joining the session picked from the snapshot once confirmed, or its replacement */
+	void OnQuickMatchSearchSnapshotRefreshed(const TArray<FOnlineSessionSearchResult>& SessionResults, bool bWasSuccessful);
+
+	/** Complete the quick match once joined, or keep looking if the session couldn't be joined */
+	void OnQuickMatchJoinComplete(EOnJoinSessionCompleteResult::Type Result);
+
+	/** Re-check after a randomized back-off, or create the session once every re-check came back empty */
+	void ContinueQuickMatch();
+
+	/** Search again once the created session had time to be advertised, so players that created theirs at the same time settle on one */
+	void SearchQuickMatchTieBreak();
+
+	/** Keep the created session if it has the lowest id among the ones found, or destroy it and join the one that has */
+	void OnQuickMatchTieBreakSearchComplete(const FMultiplayerFindSessionsResult& Result);
+
+	/** Id sessions are ordered by for the quick match's tie-break, the same for every player finding them. Empty if the session has none */
+	static FString GetQuickMatchTieBreakId(const FOnlineSessionSettings& SessionSettings, const FString& SessionId);
+
+	/** Complete quick match, notifying the multicast delegate */
+	void CompleteQuickMatch(EMultiplayerQuickMatchResult Result);
+
+public:
+
+	/** Delegate called when the quick match is complete */
+	FMultiplayerOnQuickMatchCompleteSignature MultiplayerOnQuickMatchCompleteDelegate;
+
+private:
+
+	/** Number of searches made after an empty search or a failed join, before creating a session */
+	UPROPERTY(Config)
+	int32 QuickMatchRechecks = 2;
+
+	/** Shortest time, in seconds, waited before re-checking */
+	UPROPERTY(Config)
+	float QuickMatchMinBackOff = 0.5f;
+
+	/** Longest time, in seconds, waited before the first re-check, doubled on every following one */
+	UPROPERTY(Config)
+	float QuickMatchMaxBackOff = 3.f;
+
+	/** Time, in seconds, waited after creating the session before searching for sessions created at the same time */
+	UPROPERTY(Config)
+	float QuickMatchTieBreakDelay = 1.f;
+
+	/** Tracks whether a quick match is running */
+	bool bIsQuickMatchInProgress = false;
+
+	/** Number of public connections of the session created by the quick match */
+	int32 QuickMatchNumPublicConnections = 0;
+
+	/** Match type the quick match looks for */
+	FString QuickMatchMatchType;
+
+	/** Maximum number of search results of the quick match's searches */
+	int32 QuickMatchMaxSearchResults = 0;
+
+	/** Number of searches made by the running quick match */
+	int32 QuickMatchNumSearches = 0;
+
+	/** Session picked from the served snapshot, joined once the refreshing search confirms or replaces it */
+	TOptional<FOnlineSessionSearchResult> QuickMatchSnapshotPick;
+
+	/** Handle for the timer waiting before re-checking */
+	FTimerHandle QuickMatchTimerHandle;
+
+#pragma endregion QUICK_MATCH
+
+#pragma region SPECTATOR
+
+public:
+
+	/** Whether the session being joined, or last joined, is watched as a spectator */
+	bool IsJoiningAsSpectator() const { return bJoinAsSpectator; }
+
+private:
+
+	/** Number of private slots created sessions keep for spectators, outside the public connections players search for */
+	UPROPERTY(Config)
+	int32 NumSpectatorSlots = 8;
+
+	/** Tracks whether the session is joined as a spectator */
+	bool bJoinAsSpectator = false;
+
+#pragma endregion SPECTATOR
 };
@@ -0,0 +1,108 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+// Unreal Engine
+#include "CoreMinimal.h"
+
+// Forward declarations - Unreal Engine
+class FOnlineSessionSearchResult;
+class FOnlineSessionSearch;
+class FOnlineSessionSettings;
+
+/** Session operation captured in a trace */
+enum class EMultiplayerSessionsTraceOperation : uint8
+{
+	CreateSession,
+	FindSessions,
+	JoinSession,
+	StartSession,
+	DestroySession
+};
+
+/** Summary of a session found by a traced search */
+struct MULTIPLAYERSESSIONS_API FMultiplayerSessionsTraceSessionResult
+{
+	/** Match type */
+	FString MatchType;
+
+	/** Number of public connections still available */
+	int32 NumOpenPublicConnections = 0;
+
+	/** Number of public connections allowed */
+	int32 NumPublicConnections = 0;
+
+	/** Ping to the session's host, in milliseconds */
+	int32 PingInMs = 0;
+
+	/** Serialize session result */
+	friend FArchive& operator<<(FArchive& Ar, FMultiplayerSessionsTraceSessionResult& SessionResult);
+};
+
+/** Single traced session request, with its result and timings */
+struct MULTIPLAYERSESSIONS_API FMultiplayerSessionsTraceEvent
+{
+	/** Operation requested */
+	EMultiplayerSessionsTraceOperation Operation = EMultiplayerSessionsTraceOperation::CreateSession;
+
+	/** Time, in seconds since the trace started, the request was made at */
+	double RequestTime = 0.0;
+
+	/** Time, in seconds since the trace started, the request completed at */
+	double CompletionTime = 0.0;
+
+	/** Parameters the request was made with (session settings, search filters or join target), by name */
+	TMap<FString, FString> Parameters;
+
+	/** Whether the request succeeded */
+	bool bWasSuccessful = false;
+
+	/** Join result, for join requests */
+	uint8 JoinResult = 0;
+
+	/** Sessions found, for find requests */
+	TArray<FMultiplayerSessionsTraceSessionResult> SessionResults;
+
+	/** Serialize event */
+	friend FArchive& operator<<(FArchive& Ar, FMultiplayerSessionsTraceEvent& Event);
+};
+
+/**
+ * Sequence of session requests captured from the session interface, stored as a compact binary file
+ */
+class MULTIPLAYERSESSIONS_API FMultiplayerSessionsTrace
+{
+
+#pragma region TRACE
+
+public:
+
+	/** Save trace to the given file */
+	bool SaveToFile(const FString& Filename) const;
+
+	/** Load trace from the given file, replacing current events */
+	bool LoadFromFile(const FString& Filename);
+
+	/** Convert search result into its traced summary */
+	static FMultiplayerSessionsTraceSessionResult MakeSessionResult(const FOnlineSessionSearchResult& SearchResult);
+
+	/** Convert traced summary back into a search result */
+	static FOnlineSessionSearchResult MakeSearchResult(const FMultiplayerSessionsTraceSessionResult& SessionResult);
+
+	/** Describe settings a session is created with as request parameters */
+	static TMap<FString, FString> MakeSettingsParameters(const FOnlineSessionSettings& SessionSettings);
+
+	/** Describe a search's filters as request parameters */
+	static TMap<FString, FString> MakeSearchParameters(const FOnlineSessionSearch& SessionSearch);
+
+	/** Describe a session being joined as request parameters */
+	static TMap<FString, FString> MakeJoinParameters(const FOnlineSessionSearchResult& SearchResult);
+
+public:
+
+	/** Traced requests, in completion order */
+	TArray<FMultiplayerSessionsTraceEvent> Events;
+
+#pragma endregion TRACE
+
+};
@@ -0,0 +1,42 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+// Unreal Engine
+#include "CoreMinimal.h"
+
+// MultiplayerSessions
+#include "Trace/MultiplayerSessionsTrace.h"
+
+/**
+ * Plays a recorded trace back in place of the session interface, answering each request with the next recorded result of its operation
+ */
+class MULTIPLAYERSESSIONS_API FMultiplayerSessionsTracePlayer
+{
+
+#pragma region REPLAY
+
+public:
+
+	/** Load trace to play back */
+	bool Load(const FString& Filename);
+
+	/** Take next recorded event for the given operation */
+	bool PopEvent(EMultiplayerSessionsTraceOperation Operation, FMultiplayerSessionsTraceEvent& OutEvent);
+
+	/** Time, in seconds, the event's completion is delayed by, once scaled */
+	float GetScaledLatency(const FMultiplayerSessionsTraceEvent& Event) const;
+
+public:
+
+	/** Scale applied to recorded latencies. 1 plays them back as recorded, 0 completes requests on the next tick */
+	float TimeScale = 1.f;
+
+private:
+
+	/** Recorded events not played back yet, by operation */
+	TMap<EMultiplayerSessionsTraceOperation, TArray<FMultiplayerSessionsTraceEvent>> PendingEvents;
+
+#pragma endregion REPLAY
+
+};
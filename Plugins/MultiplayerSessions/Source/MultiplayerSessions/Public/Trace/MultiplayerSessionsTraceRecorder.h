@@ -0,0 +1,59 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+// Unreal Engine
+#include "CoreMinimal.h"
+
+// MultiplayerSessions
+#include "Trace/MultiplayerSessionsTrace.h"
+
+/**
+ * Captures session requests and their results as they go through the session interface
+ */
+class MULTIPLAYERSESSIONS_API FMultiplayerSessionsTraceRecorder
+{
+
+#pragma region RECORDING
+
+public:
+
+	/** Constructor */
+	explicit FMultiplayerSessionsTraceRecorder(const FString& InFilename);
+
+	/** Record a request being made, with the parameters it was made with */
+	void BeginRequest(EMultiplayerSessionsTraceOperation Operation, TMap<FString, FString> Parameters);
+
+	/** Record the completion of the oldest pending request of the given operation */
+	void EndRequest(EMultiplayerSessionsTraceOperation Operation, bool bWasSuccessful, uint8 JoinResult = 0, const TArray<FOnlineSessionSearchResult>* SearchResults = nullptr);
+
+	/** Save recorded trace to its file */
+	bool Save() const;
+
+private:
+
+	/** File the trace is saved to */
+	FString Filename;
+
+	/** Time, in seconds, the recording started at */
+	double StartTime = 0.0;
+
+	/** Recorded trace */
+	FMultiplayerSessionsTrace Trace;
+
+	/** Request waiting for completion */
+	struct FPendingRequest
+	{
+		/** Time, in seconds since the recording started, the request was made at */
+		double RequestTime = 0.0;
+
+		/** Parameters the request was made with */
+		TMap<FString, FString> Parameters;
+	};
+
+	/** Requests waiting for completion, by operation */
+	TMap<EMultiplayerSessionsTraceOperation, TArray<FPendingRequest>> PendingRequests;
+
+#pragma endregion RECORDING
+
+};
@@ -18,5 +18,13 @@ public class MenuSystem : ModuleRules
 			"OnlineSubsystemSteam",
 			"OnlineSubsystem"
 		});
+
+		PrivateDependencyModuleNames.AddRange(new string[]
+		{
+			"HTTPServer",
+			"RenderCore",
+			"RHI",
+			"MultiplayerSessions"
+		});
 	}
 }
@@ -9,6 +9,10 @@
 #include "GameFramework/SpringArmComponent.h"
 #include "EnhancedInputComponent.h"
 #include "EnhancedInputSubsystems.h"
+#include "Engine/GameInstance.h"
+#include "GameFramework/PlayerState.h"
+#include "GameModes/LobbyGameMode.h"
+#include "Metrics/MovementLatencySubsystem.h"
 
 //////////////////////////////////////////////////////////////////////////
 // AMenuSystemCharacter
@@ -89,6 +93,8 @@ void AMenuSystemCharacter::Move(const FInputActionValue& Value)
 
 	if (Controller != nullptr)
 	{
+		RecordLatencyInput();
+
 		// find out which way is forward
 		const FRotator Rotation = Controller->GetControlRotation();
 		const FRotator YawRotation(0, Rotation.Yaw, 0);
@@ -112,8 +118,56 @@ void AMenuSystemCharacter::Look(const FInputActionValue& Value)
 
 	if (Controller != nullptr)
 	{
+		RecordLatencyInput();
+
 		// add yaw and pitch input to controller
 		AddControllerYawInput(LookAxisVector.X);
 		AddControllerPitchInput(LookAxisVector.Y);
 	}
+}
+
+void AMenuSystemCharacter::AddScriptedInput(const FVector2D& MovementVector, const FVector2D& LookAxisVector)
+{
+	// go through the same handlers as player input, so bots exercise the same movement code
+	Move(FInputActionValue(MovementVector));
+	Look(FInputActionValue(LookAxisVector));
+}
+
+void AMenuSystemCharacter::RecordLatencyInput()
+{
+	// the trace follows this input through prediction to the frame that renders it and the server's ack
+	const UGameInstance* GameInstance = GetGameInstance();
+	if (UMovementLatencySubsystem* MovementLatencySubsystem = GameInstance ? GameInstance->GetSubsystem<UMovementLatencySubsystem>() : nullptr)
+	{
+		MovementLatencySubsystem->RecordInput(this);
+	}
+}
+
+void AMenuSystemCharacter::OnClientCorrectionReceived(FNetworkPredictionData_Client_Character& ClientData, float TimeStamp, FVector NewLocation, FVector NewVelocity, UPrimitiveComponent* NewBase, FName NewBaseBoneName, bool bHasBase, bool bBaseRelativePosition, uint8 ServerMovementMode)
+{
+	Super::OnClientCorrectionReceived(ClientData, TimeStamp, NewLocation, NewVelocity, NewBase, NewBaseBoneName, bHasBase, bBaseRelativePosition, ServerMovementMode);
+
+	const UGameInstance* GameInstance = GetGameInstance();
+	if (UMovementLatencySubsystem* MovementLatencySubsystem = GameInstance ? GameInstance->GetSubsystem<UMovementLatencySubsystem>() : nullptr)
+	{
+		MovementLatencySubsystem->RecordCorrection(this);
+	}
+}
+
+float AMenuSystemCharacter::GetNetPriority(const FVector& ViewPos, const FVector& ViewDir, AActor* Viewer, AActor* ViewTarget, UActorChannel* InChannel, float Time, bool bLowBandwidth)
+{
+	const float NetPriority = Super::GetNetPriority(ViewPos, ViewDir, Viewer, ViewTarget, InChannel, Time, bLowBandwidth);
+
+	// spectators' connections are capped, so a lower priority spaces out the character's updates to them without ever pausing the channel
+	// the priority still grows with the time since the last update, so the character is never starved
+	const APlayerController* ViewerController = Cast<APlayerController>(Viewer);
+	if (ViewerController && ViewerController->PlayerState && ViewerController->PlayerState->IsOnlyASpectator())
+	{
+		if (const ALobbyGameMode* LobbyGameMode = GetWorld()->GetAuthGameMode<ALobbyGameMode>())
+		{
+			return NetPriority * LobbyGameMode->GetSpectatorNetPriority();
+		}
+	}
+
+	return NetPriority;
 }
\ No newline at end of file
@@ -0,0 +1,19 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Characters/MenuSystemSpectatorPawn.h"
+
+// Unreal Engine
+#include "Components/SphereComponent.h"
+#include "Engine/CollisionProfile.h"
+
+/** Constructor */
+AMenuSystemSpectatorPawn::AMenuSystemSpectatorPawn(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer)
+{
+	// Spectator pawns already don't replicate, fly through everything too, so moving never sweeps or overlaps
+	if (USphereComponent* CollisionComponent = GetCollisionComponent())
+	{
+		CollisionComponent->SetCollisionProfileName(UCollisionProfile::NoCollision_ProfileName);
+		CollisionComponent->SetGenerateOverlapEvents(false);
+	}
+}
@@ -5,14 +5,74 @@
 // Unreal Engine
 #include "GameFramework/GameStateBase.h"
 #include "GameFramework/PlayerState.h"
+#include "GameFramework/GameSession.h"
+#include "Engine/NetConnection.h"
+#include "Kismet/GameplayStatics.h"
+#include "OnlineSubsystem.h"
+#include "OnlineSessionSettings.h"
+#include "TimerManager.h"
+
+// MenuSystem
+#include "MenuSystem.h"
+#include "Characters/MenuSystemSpectatorPawn.h"
 
 #pragma region OVERRIDES
 
+/** Constructor */
+ALobbyGameMode::ALobbyGameMode()
+{
+	SpectatorClass = AMenuSystemSpectatorPawn::StaticClass();
+}
+
+/** Accept or reject a player attempting to join the server */
+void ALobbyGameMode::PreLogin(const FString& Options, const FString& Address, const FUniqueNetIdRepl& UniqueId, FString& ErrorMessage)
+{
+	Super::PreLogin(Options, Address, UniqueId, ErrorMessage);
+	if (!ErrorMessage.IsEmpty())
+	{
+		++NumRejectedPlayers;
+		return;
+	}
+
+	// Spectators don't take player slots, the game session having already checked them against its MaxSpectators
+	if (IsSpectatorLogin(Options))
+	{
+		return;
+	}
+
+	// Reject before the connection costs anything, rather than letting players in and kicking them
+	if (GetNumPlayers() >= GetLobbyCapacity())
+	{
+		ErrorMessage = TEXT("Lobby is full");
+	}
+	else if (LoginQueue.Num() >= MaxLoginQueueLength)
+	{
+		ErrorMessage = TEXT("Lobby is busy, try again later");
+	}
+
+	if (!ErrorMessage.IsEmpty())
+	{
+		++NumRejectedPlayers;
+		UE_LOG(LogMenuSystem, Log, TEXT("Rejected login from %s: %s"), *Address, *ErrorMessage);
+	}
+}
+
 /** Called after a successful login. This is the first place it is safe to call replicated functions on the PlayerController */
 void ALobbyGameMode::PostLogin(APlayerController* NewPlayer)
 {
 	Super::PostLogin(NewPlayer);
 
+	++NumLogins;
+
+	if (MustSpectate(NewPlayer))
+	{
+		ThrottleSpectator(NewPlayer);
+		if (MoveSpectatorSlot(true))
+		{
+			PrivateSlotSpectators.Add(NewPlayer);
+		}
+	}
+
 	if (GameState)
 	{
 		const int32 NumberOfPlayers = GameState.Get()->PlayerArray.Num();
@@ -43,8 +103,27 @@ void ALobbyGameMode::PostLogin(APlayerController* NewPlayer)
 /** Called when a Controller with a PlayerState leaves the game or is destroyed */
 void ALobbyGameMode::Logout(AController* Exiting)
 {
+	// Unregistering gives back a public slot, so the session's settings hand the public slot grown for the spectator back to the private ones
+	if (PrivateSlotSpectators.Remove(Exiting) > 0)
+	{
+		MoveSpectatorSlot(false);
+	}
+
 	Super::Logout(Exiting);
 
+	++NumLogouts;
+
+	// Leaving players free their queue position
+	const int32 QueueIndex = LoginQueue.IndexOfByPredicate([Exiting](const FLobbyQueuedPlayer& QueuedPlayer)
+	{
+		return QueuedPlayer.PlayerController == Exiting;
+	});
+	if (QueueIndex != INDEX_NONE)
+	{
+		LoginQueue.RemoveAt(QueueIndex);
+		NotifyQueuePositions(QueueIndex);
+	}
+
 	// Debug
 	const int32 NumberOfPlayers = GameState.Get()->PlayerArray.Num();
 	GEngine->AddOnScreenDebugMessage(
@@ -65,4 +144,205 @@ void ALobbyGameMode::Logout(AController* Exiting)
 	}
 }
 
-#pragma endregion OVERRIDES
\ No newline at end of file
+/** Called when the game mode is ready to start, used for starting the admission timer */
+void ALobbyGameMode::BeginPlay()
+{
+	Super::BeginPlay();
+
+	LoginTokens = FMath::Max(1.f, LoginsPerSecond);
+	LastAdmissionUpdateTime = FPlatformTime::Seconds();
+	GetWorldTimerManager().SetTimer(AdmissionTimerHandle, this, &ALobbyGameMode::UpdateAdmission, FMath::Max(0.01f, AdmissionUpdateInterval), true);
+}
+
+/** Start new player, or queue them if the login rate is exceeded. Spectators skip the queue */
+void ALobbyGameMode::HandleStartingNewPlayer_Implementation(APlayerController* NewPlayer)
+{
+	// Spectators don't spawn anything on the server, so starting them costs nothing worth spreading
+	if (MustSpectate(NewPlayer))
+	{
+		Super::HandleStartingNewPlayer_Implementation(NewPlayer);
+		return;
+	}
+
+	// Players arriving in a burst are spread over the following ticks, instead of all spawning on the same one
+	if (LoginQueue.IsEmpty() && ConsumeLoginToken())
+	{
+		++NumAdmittedPlayers;
+		Super::HandleStartingNewPlayer_Implementation(NewPlayer);
+		return;
+	}
+
+	FLobbyQueuedPlayer& QueuedPlayer = LoginQueue.AddDefaulted_GetRef();
+	QueuedPlayer.PlayerController = NewPlayer;
+	QueuedPlayer.QueueTime = FPlatformTime::Seconds();
+	NotifyQueuePositions(LoginQueue.Num() - 1);
+}
+
+#pragma endregion OVERRIDES
+
+#pragma region ADMISSION
+
+/** Get admission control metrics */
+FLobbyAdmissionMetrics ALobbyGameMode::GetAdmissionMetrics() const
+{
+	FLobbyAdmissionMetrics Metrics;
+	Metrics.QueueDepth = LoginQueue.Num();
+	Metrics.NumAdmitted = NumAdmittedPlayers;
+	Metrics.NumRejected = NumRejectedPlayers;
+	Metrics.NumLogins = NumLogins;
+	Metrics.NumLogouts = NumLogouts;
+	Metrics.NumQueued = NumQueuedAdmittedPlayers;
+	Metrics.AverageWaitTime = NumQueuedAdmittedPlayers > 0 ? static_cast<float>(TotalQueueWaitTime / NumQueuedAdmittedPlayers) : 0.f;
+	Metrics.MaxWaitTime = static_cast<float>(MaxQueueWaitTime);
+	return Metrics;
+}
+
+/** Timer callback refilling login tokens and admitting queued players */
+void ALobbyGameMode::UpdateAdmission()
+{
+	const double Now = FPlatformTime::Seconds();
+	const float MaxTokens = FMath::Max(1.f, LoginsPerSecond);
+	LoginTokens = FMath::Min(MaxTokens, LoginTokens + static_cast<float>(Now - LastAdmissionUpdateTime) * LoginsPerSecond);
+	LastAdmissionUpdateTime = Now;
+
+	if (LoginQueue.IsEmpty())
+	{
+		return;
+	}
+
+	int32 NumDequeued = 0;
+	while (NumDequeued < LoginQueue.Num() && ConsumeLoginToken())
+	{
+		AdmitPlayer(LoginQueue[NumDequeued]);
+		++NumDequeued;
+	}
+
+	if (NumDequeued > 0)
+	{
+		LoginQueue.RemoveAt(0, NumDequeued);
+		NotifyQueuePositions();
+
+		const FLobbyAdmissionMetrics Metrics = GetAdmissionMetrics();
+		UE_LOG(LogMenuSystem, Log, TEXT("Login queue: %d waiting, %.1fs average wait, %.1fs max wait"), Metrics.QueueDepth, Metrics.AverageWaitTime, Metrics.MaxWaitTime);
+	}
+}
+
+/** Take a login token, if any is available */
+bool ALobbyGameMode::ConsumeLoginToken()
+{
+	if (LoginTokens < 1.f)
+	{
+		return false;
+	}
+
+	LoginTokens -= 1.f;
+	return true;
+}
+
+/** Start queued player's game */
+void ALobbyGameMode::AdmitPlayer(const FLobbyQueuedPlayer& QueuedPlayer)
+{
+	// Players who left while queued are removed on logout, but the controller may already be pending kill
+	APlayerController* PlayerController = QueuedPlayer.PlayerController.Get();
+	if (!IsValid(PlayerController))
+	{
+		// Token wasn't used for starting anyone
+		LoginTokens += 1.f;
+		return;
+	}
+
+	const double WaitTime = FPlatformTime::Seconds() - QueuedPlayer.QueueTime;
+	++NumAdmittedPlayers;
+	++NumQueuedAdmittedPlayers;
+	TotalQueueWaitTime += WaitTime;
+	MaxQueueWaitTime = FMath::Max(MaxQueueWaitTime, WaitTime);
+
+	UE_LOG(LogMenuSystem, Verbose, TEXT("Admitted %s after %.2fs in the login queue"), *GetNameSafe(PlayerController), WaitTime);
+	Super::HandleStartingNewPlayer_Implementation(PlayerController);
+}
+
+/** Tell queued players their position in the queue */
+void ALobbyGameMode::NotifyQueuePositions(int32 FirstIndex) const
+{
+	for (int32 Index = FirstIndex; Index < LoginQueue.Num(); ++Index)
+	{
+		if (APlayerController* PlayerController = LoginQueue[Index].PlayerController.Get())
+		{
+			PlayerController->ClientMessage(FString::Printf(TEXT("Waiting to join the lobby: position %d of %d"), Index + 1, LoginQueue.Num()));
+		}
+	}
+}
+
+/** Maximum number of players, including queued ones. 0 uses the game session's MaxPlayers */
+int32 ALobbyGameMode::GetLobbyCapacity() const
+{
+	if (MaxLobbyPlayers > 0)
+	{
+		return MaxLobbyPlayers;
+	}
+
+	return GameSession ? GameSession->MaxPlayers : MAX_int32;
+}
+
+#pragma endregion ADMISSION
+
+#pragma region SPECTATORS
+
+/** Whether the connection options ask for joining as a spectator */
+bool ALobbyGameMode::IsSpectatorLogin(const FString& Options)
+{
+	return UGameplayStatics::ParseOption(Options, TEXT("SpectatorOnly")) == TEXT("1");
+}
+
+/** Make spectator's connection cheap: capped bandwidth and rare updates of its own controller and player state */
+void ALobbyGameMode::ThrottleSpectator(APlayerController* Spectator) const
+{
+	if (UNetConnection* Connection = Spectator->GetNetConnection(); Connection && SpectatorNetSpeed > 0)
+	{
+		Connection->CurrentNetSpeed = FMath::Min(Connection->CurrentNetSpeed, SpectatorNetSpeed);
+	}
+
+	Spectator->NetUpdateFrequency = SpectatorNetUpdateFrequency;
+	if (APlayerState* PlayerState = Spectator->GetPlayerState<APlayerState>())
+	{
+		PlayerState->NetUpdateFrequency = SpectatorNetUpdateFrequency;
+	}
+}
+
+/** Update the session so a spectator's slot counts as a private one instead of a public one, or back when leaving. Returns whether the update was requested */
+bool ALobbyGameMode::MoveSpectatorSlot(bool bIsJoining) const
+{
+	const IOnlineSubsystem* OnlineSubsystem = IOnlineSubsystem::Get();
+	const IOnlineSessionPtr SessionInterface = OnlineSubsystem ? OnlineSubsystem->GetSessionInterface() : nullptr;
+	const FOnlineSessionSettings* CurrentSettings = SessionInterface.IsValid() ? SessionInterface->GetSessionSettings(NAME_GameSession) : nullptr;
+	if (!CurrentSettings)
+	{
+		return false;
+	}
+
+	// Registering the spectator took one of the public slots, so the session grows a public slot out of its private ones, keeping its capacity.
+	// The backend then works out the open slots it advertises from the updated settings
+	FOnlineSessionSettings UpdatedSettings = *CurrentSettings;
+	if (bIsJoining)
+	{
+		if (UpdatedSettings.NumPrivateConnections <= 0)
+		{
+			return false;
+		}
+		++UpdatedSettings.NumPublicConnections;
+		--UpdatedSettings.NumPrivateConnections;
+	}
+	else
+	{
+		if (UpdatedSettings.NumPublicConnections <= 0)
+		{
+			return false;
+		}
+		--UpdatedSettings.NumPublicConnections;
+		++UpdatedSettings.NumPrivateConnections;
+	}
+
+	return SessionInterface->UpdateSession(NAME_GameSession, UpdatedSettings, true);
+}
+
+#pragma endregion SPECTATORS
\ No newline at end of file
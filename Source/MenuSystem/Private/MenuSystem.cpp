@@ -3,5 +3,7 @@
 #include "MenuSystem.h"
 #include "Modules/ModuleManager.h"
 
+DEFINE_LOG_CATEGORY(LogMenuSystem);
+
 IMPLEMENT_PRIMARY_GAME_MODULE( FDefaultGameModuleImpl, MenuSystem, "MenuSystem" );
  
\ No newline at end of file
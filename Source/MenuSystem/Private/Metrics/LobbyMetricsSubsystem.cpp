@@ -0,0 +1,245 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Metrics/LobbyMetricsSubsystem.h"
+
+// Unreal Engine
+#include "Engine/GameInstance.h"
+#include "Engine/NetDriver.h"
+#include "Engine/World.h"
+#include "HttpPath.h"
+#include "HttpServerModule.h"
+#include "HttpServerResponse.h"
+#include "IHttpRouter.h"
+#include "Misc/CommandLine.h"
+#include "Misc/Parse.h"
+
+// MultiplayerSessions
+#include "Subsystems/MultiplayerSessionsSubsystem.h"
+
+// MenuSystem
+#include "MenuSystem.h"
+#include "GameModes/LobbyGameMode.h"
+
+namespace
+{
+	/** Append a metric's help and type lines */
+	void AppendMetricHeader(FString& Output, const TCHAR* Name, const TCHAR* Help, const TCHAR* Type)
+	{
+		Output += FString::Printf(TEXT("# HELP %s %s\n# TYPE %s %s\n"), Name, Help, Name, Type);
+	}
+
+	/** Append a single sample, labels being written as-is between braces */
+	void AppendMetricSample(FString& Output, const TCHAR* Name, double Value, const FString& Labels = FString())
+	{
+		Output += Labels.IsEmpty()
+			? FString::Printf(TEXT("%s %.15g\n"), Name, Value)
+			: FString::Printf(TEXT("%s{%s} %.15g\n"), Name, *Labels, Value);
+	}
+
+	/** Label value of a session operation */
+	const TCHAR* GetOperationLabel(EMultiplayerSessionsTraceOperation Operation)
+	{
+		switch (Operation)
+		{
+		case EMultiplayerSessionsTraceOperation::CreateSession:
+			return TEXT("create");
+		case EMultiplayerSessionsTraceOperation::FindSessions:
+			return TEXT("find");
+		case EMultiplayerSessionsTraceOperation::JoinSession:
+			return TEXT("join");
+		case EMultiplayerSessionsTraceOperation::StartSession:
+			return TEXT("start");
+		case EMultiplayerSessionsTraceOperation::DestroySession:
+			return TEXT("destroy");
+		}
+		return TEXT("unknown");
+	}
+}
+
+#pragma region INITIALIZATION
+
+/** Only create the subsystem when a metrics port was configured */
+bool ULobbyMetricsSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+	return GetMetricsPort() > 0 && Super::ShouldCreateSubsystem(Outer);
+}
+
+/** Initialize subsystem */
+void ULobbyMetricsSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	// Session operation latencies are read from the sessions subsystem
+	Collection.InitializeDependency(UMultiplayerSessionsSubsystem::StaticClass());
+
+	const int32 Port = GetMetricsPort();
+	MetricsRouter = FHttpServerModule::Get().GetHttpRouter(Port);
+	if (!MetricsRouter.IsValid())
+	{
+		UE_LOG(LogMenuSystem, Error, TEXT("Couldn't serve metrics on port %d"), Port);
+		return;
+	}
+
+	MetricsRouteHandle = MetricsRouter->BindRoute(
+		FHttpPath(TEXT("/metrics")),
+		EHttpServerRequestVerbs::VERB_GET,
+		FHttpRequestHandler::CreateUObject(this, &ULobbyMetricsSubsystem::HandleMetricsRequest)
+	);
+	FHttpServerModule::Get().StartAllListeners();
+
+	FrameTimeTickerHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateUObject(this, &ULobbyMetricsSubsystem::TickFrameTime));
+
+	UE_LOG(LogMenuSystem, Log, TEXT("Serving metrics on port %d"), Port);
+}
+
+/** Deinitialize subsystem */
+void ULobbyMetricsSubsystem::Deinitialize()
+{
+	FTSTicker::GetCoreTicker().RemoveTicker(FrameTimeTickerHandle);
+	FrameTimeTickerHandle.Reset();
+
+	if (MetricsRouter.IsValid() && MetricsRouteHandle.IsValid())
+	{
+		MetricsRouter->UnbindRoute(MetricsRouteHandle);
+	}
+	MetricsRouteHandle.Reset();
+	MetricsRouter.Reset();
+
+	Super::Deinitialize();
+}
+
+/** Port metrics are served on, 0 if disabled */
+int32 ULobbyMetricsSubsystem::GetMetricsPort() const
+{
+	int32 Port = MetricsPort;
+	FParse::Value(FCommandLine::Get(), TEXT("MetricsPort="), Port);
+	return FMath::Max(0, Port);
+}
+
+#pragma endregion INITIALIZATION
+
+#pragma region METRICS
+
+/** Ticker callback accumulating frame times */
+bool ULobbyMetricsSubsystem::TickFrameTime(float DeltaTime)
+{
+	++NumFrames;
+	TotalFrameTime += DeltaTime;
+
+	// Longest frame is kept over a rolling window, so it doesn't depend on how often metrics are scraped
+	CurrentWindowTime += DeltaTime;
+	CurrentWindowMaxFrameTime = FMath::Max(CurrentWindowMaxFrameTime, DeltaTime);
+	if (CurrentWindowTime >= 1.f)
+	{
+		PreviousWindowMaxFrameTime = CurrentWindowMaxFrameTime;
+		CurrentWindowMaxFrameTime = 0.f;
+		CurrentWindowTime = 0.f;
+	}
+
+	return true;
+}
+
+/** Route callback answering scrapes with the current metrics */
+bool ULobbyMetricsSubsystem::HandleMetricsRequest(const FHttpServerRequest& Request, const FHttpResultCallback& OnComplete)
+{
+	OnComplete(FHttpServerResponse::Create(WriteMetrics(), TEXT("text/plain; version=0.0.4; charset=utf-8")));
+	return true;
+}
+
+/** Write current metrics in Prometheus text format */
+FString ULobbyMetricsSubsystem::WriteMetrics() const
+{
+	FString Output;
+
+	// Players
+	const UWorld* World = GetGameInstance()->GetWorld();
+	const ALobbyGameMode* LobbyGameMode = World ? World->GetAuthGameMode<ALobbyGameMode>() : nullptr;
+	const FLobbyAdmissionMetrics AdmissionMetrics = LobbyGameMode ? LobbyGameMode->GetAdmissionMetrics() : FLobbyAdmissionMetrics();
+
+	AppendMetricHeader(Output, TEXT("lobby_players"), TEXT("Players in the lobby"), TEXT("gauge"));
+	AppendMetricSample(Output, TEXT("lobby_players"), LobbyGameMode ? LobbyGameMode->GetNumPlayers() : 0);
+
+	AppendMetricHeader(Output, TEXT("lobby_login_queue_depth"), TEXT("Players waiting in the login queue"), TEXT("gauge"));
+	AppendMetricSample(Output, TEXT("lobby_login_queue_depth"), AdmissionMetrics.QueueDepth);
+
+	AppendMetricHeader(Output, TEXT("lobby_logins_total"), TEXT("Players logged in"), TEXT("counter"));
+	AppendMetricSample(Output, TEXT("lobby_logins_total"), AdmissionMetrics.NumLogins);
+
+	AppendMetricHeader(Output, TEXT("lobby_logouts_total"), TEXT("Players logged out"), TEXT("counter"));
+	AppendMetricSample(Output, TEXT("lobby_logouts_total"), AdmissionMetrics.NumLogouts);
+
+	AppendMetricHeader(Output, TEXT("lobby_rejected_logins_total"), TEXT("Connections rejected before logging in"), TEXT("counter"));
+	AppendMetricSample(Output, TEXT("lobby_rejected_logins_total"), AdmissionMetrics.NumRejected);
+
+	// Session operations, as cumulative latency histograms
+	if (const UMultiplayerSessionsSubsystem* MultiplayerSessionsSubsystem = GetGameInstance()->GetSubsystem<UMultiplayerSessionsSubsystem>())
+	{
+		AppendMetricHeader(Output, TEXT("session_operation_duration_seconds"), TEXT("Time from a session request to its completion"), TEXT("histogram"));
+		FString FailuresOutput;
+		FString AllocationsOutput;
+		for (const EMultiplayerSessionsTraceOperation Operation : {
+			EMultiplayerSessionsTraceOperation::CreateSession,
+			EMultiplayerSessionsTraceOperation::FindSessions,
+			EMultiplayerSessionsTraceOperation::JoinSession,
+			EMultiplayerSessionsTraceOperation::StartSession,
+			EMultiplayerSessionsTraceOperation::DestroySession })
+		{
+			const FMultiplayerSessionsOperationStats Stats = MultiplayerSessionsSubsystem->GetOperationStats(Operation);
+			const FString OperationLabel = FString::Printf(TEXT("operation=\"%s\""), GetOperationLabel(Operation));
+
+			int32 CumulativeCount = 0;
+			for (int32 BucketIndex = 0; BucketIndex < FMultiplayerSessionsOperationStats::NumLatencyBuckets; ++BucketIndex)
+			{
+				CumulativeCount += Stats.LatencyBucketCounts[BucketIndex];
+				const FString BucketLabels = FString::Printf(TEXT("%s,le=\"%g\""), *OperationLabel, FMultiplayerSessionsOperationStats::LatencyBucketBounds[BucketIndex]);
+				AppendMetricSample(Output, TEXT("session_operation_duration_seconds_bucket"), CumulativeCount, BucketLabels);
+			}
+			AppendMetricSample(Output, TEXT("session_operation_duration_seconds_bucket"), Stats.NumCompleted, OperationLabel + TEXT(",le=\"+Inf\""));
+			AppendMetricSample(Output, TEXT("session_operation_duration_seconds_sum"), Stats.TotalLatency, OperationLabel);
+			AppendMetricSample(Output, TEXT("session_operation_duration_seconds_count"), Stats.NumCompleted, OperationLabel);
+
+			AppendMetricSample(FailuresOutput, TEXT("session_operation_failures_total"), Stats.NumFailed, OperationLabel);
+			AppendMetricSample(AllocationsOutput, TEXT("session_operation_allocations_total"), Stats.NumAllocations, OperationLabel);
+		}
+
+		AppendMetricHeader(Output, TEXT("session_operation_failures_total"), TEXT("Session requests that failed"), TEXT("counter"));
+		Output += FailuresOutput;
+
+		AppendMetricHeader(Output, TEXT("session_operation_allocations_total"), TEXT("Session settings and search objects allocated rather than reused"), TEXT("counter"));
+		Output += AllocationsOutput;
+	}
+
+	// Tick time, averaged by dividing the rates of both counters
+	AppendMetricHeader(Output, TEXT("server_frames_total"), TEXT("Frames ticked"), TEXT("counter"));
+	AppendMetricSample(Output, TEXT("server_frames_total"), static_cast<double>(NumFrames));
+
+	AppendMetricHeader(Output, TEXT("server_frame_time_seconds_total"), TEXT("Time spent ticking frames"), TEXT("counter"));
+	AppendMetricSample(Output, TEXT("server_frame_time_seconds_total"), TotalFrameTime);
+
+	AppendMetricHeader(Output, TEXT("server_frame_time_max_seconds"), TEXT("Longest frame over the last second"), TEXT("gauge"));
+	AppendMetricSample(Output, TEXT("server_frame_time_max_seconds"), FMath::Max(CurrentWindowMaxFrameTime, PreviousWindowMaxFrameTime));
+
+	// Bandwidth is the net driver's own per second average
+	int32 NumConnections = 0;
+	uint32 InBytesPerSecond = 0;
+	uint32 OutBytesPerSecond = 0;
+	if (const UNetDriver* NetDriver = World ? World->GetNetDriver() : nullptr)
+	{
+		NumConnections = NetDriver->ClientConnections.Num();
+		InBytesPerSecond = NetDriver->InBytesPerSecond;
+		OutBytesPerSecond = NetDriver->OutBytesPerSecond;
+	}
+
+	AppendMetricHeader(Output, TEXT("net_connections"), TEXT("Client connections"), TEXT("gauge"));
+	AppendMetricSample(Output, TEXT("net_connections"), NumConnections);
+
+	AppendMetricHeader(Output, TEXT("net_in_bytes_per_second"), TEXT("Bytes received per second"), TEXT("gauge"));
+	AppendMetricSample(Output, TEXT("net_in_bytes_per_second"), InBytesPerSecond);
+
+	AppendMetricHeader(Output, TEXT("net_out_bytes_per_second"), TEXT("Bytes sent per second"), TEXT("gauge"));
+	AppendMetricSample(Output, TEXT("net_out_bytes_per_second"), OutBytesPerSecond);
+
+	return Output;
+}
+
+#pragma endregion METRICS
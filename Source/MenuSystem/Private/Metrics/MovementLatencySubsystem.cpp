@@ -0,0 +1,272 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Metrics/MovementLatencySubsystem.h"
+
+// Unreal Engine
+#include "Engine/NetDriver.h"
+#include "Engine/World.h"
+#include "GameFramework/CharacterMovementComponent.h"
+#include "GameFramework/PlayerState.h"
+#include "HAL/FileManager.h"
+#include "Misc/CommandLine.h"
+#include "Misc/CoreDelegates.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Parse.h"
+#include "Misc/Paths.h"
+#include "ProfilingDebugging/CsvProfiler.h"
+#include "RenderCore.h"
+#include "RHI.h"
+#include "Stats/Stats.h"
+
+// MenuSystem
+#include "MenuSystem.h"
+#include "Characters/MenuSystemCharacter.h"
+
+DECLARE_STATS_GROUP(TEXT("MovementLatency"), STATGROUP_MovementLatency, STATCAT_Advanced);
+DECLARE_FLOAT_ACCUMULATOR_STAT(TEXT("Input to render (ms)"), STAT_MovementLatency_InputToRender, STATGROUP_MovementLatency);
+DECLARE_FLOAT_ACCUMULATOR_STAT(TEXT("Input to render p95 (ms)"), STAT_MovementLatency_InputToRenderP95, STATGROUP_MovementLatency);
+DECLARE_FLOAT_ACCUMULATOR_STAT(TEXT("Input to server ack (ms)"), STAT_MovementLatency_InputToAck, STATGROUP_MovementLatency);
+DECLARE_FLOAT_ACCUMULATOR_STAT(TEXT("Input to server ack p95 (ms)"), STAT_MovementLatency_InputToAckP95, STATGROUP_MovementLatency);
+DECLARE_FLOAT_ACCUMULATOR_STAT(TEXT("Corrections per second"), STAT_MovementLatency_CorrectionRate, STATGROUP_MovementLatency);
+
+CSV_DEFINE_CATEGORY(MovementLatency, true);
+
+#pragma region INITIALIZATION
+
+/** Only create the subsystem on clients, when tracing was requested */
+bool UMovementLatencySubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+	return !IsRunningDedicatedServer()
+		&& (bTraceMovementLatency || FParse::Param(FCommandLine::Get(), TEXT("MovementLatencyReport")))
+		&& Super::ShouldCreateSubsystem(Outer);
+}
+
+/** Initialize subsystem */
+void UMovementLatencySubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	FParse::Value(FCommandLine::Get(), TEXT("MovementLatencyReportInterval="), MovementLatencyReportInterval);
+	MovementLatencyReportInterval = FMath::Max(0.1f, MovementLatencyReportInterval);
+
+	// One report per process, so several clients can run on the same machine
+	ReportFilename = FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("Latency"), FString::Printf(TEXT("MovementLatency_%u.csv"), FPlatformProcess::GetCurrentProcessId()));
+	FFileHelper::SaveStringToFile(TEXT("Time,Inputs,AvgInputToRenderMs,P95InputToRenderMs,MaxInputToRenderMs,Acks,AvgInputToAckMs,P95InputToAckMs,MaxInputToAckMs,Corrections,CorrectionsPerSecond,PingMs,PktLagMs,PktLagVarianceMs,PktLossPercent,PktIncomingLossPercent\n"), *ReportFilename);
+
+	EndFrameDelegateHandle = FCoreDelegates::OnEndFrame.AddUObject(this, &UMovementLatencySubsystem::OnEndFrame);
+	ReportTickerHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateUObject(this, &UMovementLatencySubsystem::TickReport));
+
+	UE_LOG(LogMenuSystem, Log, TEXT("Movement latency report written to %s"), *ReportFilename);
+}
+
+/** Deinitialize subsystem */
+void UMovementLatencySubsystem::Deinitialize()
+{
+	FCoreDelegates::OnEndFrame.Remove(EndFrameDelegateHandle);
+	EndFrameDelegateHandle.Reset();
+
+	FTSTicker::GetCoreTicker().RemoveTicker(ReportTickerHandle);
+	ReportTickerHandle.Reset();
+
+	Super::Deinitialize();
+}
+
+#pragma endregion INITIALIZATION
+
+#pragma region TRACE
+
+/** Timestamp input applied to the character, unless earlier input is still waiting for its movement */
+void UMovementLatencySubsystem::RecordInput(AMenuSystemCharacter* Character)
+{
+	// A new character starts a new move history, whose time stamps can't be compared with the old one's
+	if (TracedCharacter != Character)
+	{
+		TracedCharacter = Character;
+		UnacknowledgedInputs.Reset();
+		LastAckedTimeStamp = 0.f;
+	}
+
+	if (PendingInputTime == 0.0)
+	{
+		PendingInputTime = FPlatformTime::Seconds();
+	}
+}
+
+/** Count a server correction of the character's predicted movement */
+void UMovementLatencySubsystem::RecordCorrection(AMenuSystemCharacter* Character)
+{
+	if (TracedCharacter == Character)
+	{
+		++IntervalCorrections;
+	}
+}
+
+/** Callback called at the end of every frame, once the frame's movement was applied and handed to rendering */
+void UMovementLatencySubsystem::OnEndFrame()
+{
+	AMenuSystemCharacter* Character = TracedCharacter.Get();
+	if (!Character || !Character->IsLocallyControlled())
+	{
+		PendingInputTime = 0.0;
+		return;
+	}
+
+	// Only autonomous proxies predict and get their moves acknowledged, listen server hosts and standalone games just render
+	const double Now = FPlatformTime::Seconds();
+	UCharacterMovementComponent* MovementComponent = Character->GetCharacterMovement();
+	FNetworkPredictionData_Client_Character* ClientData = MovementComponent && Character->GetLocalRole() == ROLE_AutonomousProxy
+		? MovementComponent->GetPredictionData_Client_Character()
+		: nullptr;
+
+	// Input is applied by the movement of the frame it arrived in, rendered after the render thread and GPU work of a frame,
+	// which are taken from the last measured frame as this one's are still in flight
+	if (PendingInputTime > 0.0)
+	{
+		const double RenderTime = FPlatformTime::ToSeconds(GRenderThreadTime) + FPlatformTime::ToSeconds(RHIGetGPUFrameCycles());
+		const float InputToRenderMs = static_cast<float>((Now - PendingInputTime + RenderTime) * 1000.0);
+		InputToRenderSamples.Add(InputToRenderMs);
+		CSV_CUSTOM_STAT(MovementLatency, InputToRenderMs, InputToRenderMs, ECsvCustomStatOp::Set);
+
+		if (ClientData)
+		{
+			// Time stamps restart every few minutes, dropping inputs that would compare against the old ones
+			if (!UnacknowledgedInputs.IsEmpty() && ClientData->CurrentTimeStamp < UnacknowledgedInputs.Last().MoveTimeStamp)
+			{
+				UnacknowledgedInputs.Reset();
+			}
+			if (UnacknowledgedInputs.Num() >= MaxUnacknowledgedInputs)
+			{
+				UnacknowledgedInputs.RemoveAt(0, 1, false);
+			}
+			UnacknowledgedInputs.Add({ ClientData->CurrentTimeStamp, PendingInputTime });
+		}
+
+		PendingInputTime = 0.0;
+	}
+
+	// Good moves and corrections both acknowledge every move up to the acked one, combined moves included
+	if (ClientData && ClientData->LastAckedMove.IsValid() && ClientData->LastAckedMove->TimeStamp != LastAckedTimeStamp)
+	{
+		LastAckedTimeStamp = ClientData->LastAckedMove->TimeStamp;
+		ProcessAcknowledgedMoves(LastAckedTimeStamp, Now);
+	}
+}
+
+/** Match acknowledged moves with the inputs they carried */
+void UMovementLatencySubsystem::ProcessAcknowledgedMoves(float AckedTimeStamp, double Now)
+{
+	int32 NumAcknowledged = 0;
+	while (NumAcknowledged < UnacknowledgedInputs.Num() && UnacknowledgedInputs[NumAcknowledged].MoveTimeStamp <= AckedTimeStamp)
+	{
+		const float InputToAckMs = static_cast<float>((Now - UnacknowledgedInputs[NumAcknowledged].InputTime) * 1000.0);
+		InputToAckSamples.Add(InputToAckMs);
+		CSV_CUSTOM_STAT(MovementLatency, InputToAckMs, InputToAckMs, ECsvCustomStatOp::Set);
+		++NumAcknowledged;
+	}
+
+	if (NumAcknowledged > 0)
+	{
+		UnacknowledgedInputs.RemoveAt(0, NumAcknowledged, false);
+	}
+}
+
+/** Ticker callback writing the report and updating the stats */
+bool UMovementLatencySubsystem::TickReport(float DeltaTime)
+{
+	IntervalTime += DeltaTime;
+	if (IntervalTime < MovementLatencyReportInterval)
+	{
+		return true;
+	}
+
+	const auto GetAverage = [](const TArray<float>& Samples)
+	{
+		float Total = 0.f;
+		for (const float Sample : Samples)
+		{
+			Total += Sample;
+		}
+		return Samples.IsEmpty() ? 0.f : Total / Samples.Num();
+	};
+
+	const float AvgInputToRenderMs = GetAverage(InputToRenderSamples);
+	const float MaxInputToRenderMs = InputToRenderSamples.IsEmpty() ? 0.f : FMath::Max(InputToRenderSamples);
+	const float P95InputToRenderMs = GetPercentile(InputToRenderSamples, 0.95f);
+	const float AvgInputToAckMs = GetAverage(InputToAckSamples);
+	const float MaxInputToAckMs = InputToAckSamples.IsEmpty() ? 0.f : FMath::Max(InputToAckSamples);
+	const float P95InputToAckMs = GetPercentile(InputToAckSamples, 0.95f);
+	const float CorrectionsPerSecond = IntervalCorrections / IntervalTime;
+
+	SET_FLOAT_STAT(STAT_MovementLatency_InputToRender, AvgInputToRenderMs);
+	SET_FLOAT_STAT(STAT_MovementLatency_InputToRenderP95, P95InputToRenderMs);
+	SET_FLOAT_STAT(STAT_MovementLatency_InputToAck, AvgInputToAckMs);
+	SET_FLOAT_STAT(STAT_MovementLatency_InputToAckP95, P95InputToAckMs);
+	SET_FLOAT_STAT(STAT_MovementLatency_CorrectionRate, CorrectionsPerSecond);
+	CSV_CUSTOM_STAT(MovementLatency, CorrectionsPerSecond, CorrectionsPerSecond, ECsvCustomStatOp::Set);
+
+	// Network conditions the samples were taken under, simulated ones included
+	float PingMs = 0.f;
+	int32 PktLag = 0;
+	int32 PktLagVariance = 0;
+	int32 PktLoss = 0;
+	int32 PktIncomingLoss = 0;
+	if (const AMenuSystemCharacter* Character = TracedCharacter.Get())
+	{
+		if (const APlayerState* PlayerState = Character->GetPlayerState())
+		{
+			PingMs = PlayerState->GetPingInMilliseconds();
+		}
+
+#if DO_ENABLE_NET_TEST
+		const UWorld* World = Character->GetWorld();
+		if (const UNetDriver* NetDriver = World ? World->GetNetDriver() : nullptr)
+		{
+			PktLag = NetDriver->PacketSimulationSettings.PktLag;
+			PktLagVariance = NetDriver->PacketSimulationSettings.PktLagVariance;
+			PktLoss = NetDriver->PacketSimulationSettings.PktLoss;
+			PktIncomingLoss = NetDriver->PacketSimulationSettings.PktIncomingLoss;
+		}
+#endif
+	}
+
+	const FString Line = FString::Printf(
+		TEXT("%.3f,%d,%.2f,%.2f,%.2f,%d,%.2f,%.2f,%.2f,%d,%.2f,%.1f,%d,%d,%d,%d\n"),
+		FPlatformTime::Seconds(),
+		InputToRenderSamples.Num(),
+		AvgInputToRenderMs,
+		P95InputToRenderMs,
+		MaxInputToRenderMs,
+		InputToAckSamples.Num(),
+		AvgInputToAckMs,
+		P95InputToAckMs,
+		MaxInputToAckMs,
+		IntervalCorrections,
+		CorrectionsPerSecond,
+		PingMs,
+		PktLag,
+		PktLagVariance,
+		PktLoss,
+		PktIncomingLoss
+	);
+	FFileHelper::SaveStringToFile(Line, *ReportFilename, FFileHelper::EEncodingOptions::AutoDetect, &IFileManager::Get(), FILEWRITE_Append);
+
+	InputToRenderSamples.Reset();
+	InputToAckSamples.Reset();
+	IntervalCorrections = 0;
+	IntervalTime = 0.f;
+	return true;
+}
+
+/** Value below which the given fraction of the samples fall */
+float UMovementLatencySubsystem::GetPercentile(TArray<float>& Samples, float Fraction)
+{
+	if (Samples.IsEmpty())
+	{
+		return 0.f;
+	}
+
+	Samples.Sort();
+	return Samples[FMath::Clamp(FMath::CeilToInt(Fraction * Samples.Num()) - 1, 0, Samples.Num() - 1)];
+}
+
+#pragma endregion TRACE
@@ -0,0 +1,225 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Stress/LobbyBotSubsystem.h"
+
+// Unreal Engine
+#include "Engine/Engine.h"
+#include "Engine/GameInstance.h"
+#include "Engine/World.h"
+#include "GameFramework/PlayerController.h"
+#include "HAL/FileManager.h"
+#include "Misc/CommandLine.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Parse.h"
+#include "Misc/Paths.h"
+
+// MenuSystem
+#include "MenuSystem.h"
+#include "Characters/MenuSystemCharacter.h"
+
+#pragma region INITIALIZATION
+
+/** Only create the subsystem when running as a bot */
+bool ULobbyBotSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+	return FParse::Param(FCommandLine::Get(), TEXT("LobbyBot")) && Super::ShouldCreateSubsystem(Outer);
+}
+
+/** Initialize subsystem */
+void ULobbyBotSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	const TCHAR* CommandLine = FCommandLine::Get();
+	FParse::Value(CommandLine, TEXT("BotServer="), BotServerAddress);
+	FParse::Value(CommandLine, TEXT("BotJoinDelay="), BotJoinDelay);
+	FParse::Value(CommandLine, TEXT("BotStayTime="), BotStayTime);
+	FParse::Value(CommandLine, TEXT("BotRejoinDelay="), BotRejoinDelay);
+	FParse::Value(CommandLine, TEXT("BotJitter="), BotJitter);
+	FParse::Value(CommandLine, TEXT("BotJoinTimeout="), BotJoinTimeout);
+	FParse::Value(CommandLine, TEXT("BotCycles="), BotCycles);
+
+	// One report per bot process, so many bots can run on the same machine
+	ReportFilename = FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("Stress"), FString::Printf(TEXT("LobbyBot_%u.csv"), FPlatformProcess::GetCurrentProcessId()));
+	FFileHelper::SaveStringToFile(TEXT("Time,Event,LoginLatencyMs\n"), *ReportFilename);
+
+	State = ELobbyBotState::Idle;
+	NextActionTime = FPlatformTime::Seconds() + GetJitteredTime(BotJoinDelay);
+	BotTickerHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateUObject(this, &ULobbyBotSubsystem::TickBot));
+
+	if (GEngine)
+	{
+		NetworkFailureDelegateHandle = GEngine->OnNetworkFailure().AddUObject(this, &ULobbyBotSubsystem::OnNetworkFailure);
+		TravelFailureDelegateHandle = GEngine->OnTravelFailure().AddUObject(this, &ULobbyBotSubsystem::OnTravelFailure);
+	}
+
+	UE_LOG(LogMenuSystem, Log, TEXT("Lobby bot joining %s, reporting to %s"), *BotServerAddress, *ReportFilename);
+}
+
+/** Deinitialize subsystem */
+void ULobbyBotSubsystem::Deinitialize()
+{
+	FTSTicker::GetCoreTicker().RemoveTicker(BotTickerHandle);
+	BotTickerHandle.Reset();
+
+	if (GEngine)
+	{
+		GEngine->OnNetworkFailure().Remove(NetworkFailureDelegateHandle);
+		GEngine->OnTravelFailure().Remove(TravelFailureDelegateHandle);
+	}
+
+	Super::Deinitialize();
+}
+
+#pragma endregion INITIALIZATION
+
+#pragma region BOT
+
+/** Ticker callback driving the bot's schedule and scripted input */
+bool ULobbyBotSubsystem::TickBot(float DeltaTime)
+{
+	const double Now = FPlatformTime::Seconds();
+	const UWorld* World = GetGameInstance()->GetWorld();
+	const APlayerController* PlayerController = World ? World->GetFirstPlayerController() : nullptr;
+	AMenuSystemCharacter* Character = PlayerController ? PlayerController->GetPawn<AMenuSystemCharacter>() : nullptr;
+	const bool bIsConnected = World && World->GetNetMode() == NM_Client;
+
+	switch (State)
+	{
+	case ELobbyBotState::Idle:
+		if (Now >= NextActionTime)
+		{
+			Join();
+		}
+		break;
+
+	case ELobbyBotState::Joining:
+		// Login is complete once the server possessed a character for this client
+		if (bIsConnected && Character)
+		{
+			const double LoginLatency = Now - JoinRequestTime;
+			WriteReportLine(TEXT("Join"), LoginLatency);
+
+			State = ELobbyBotState::Playing;
+			ScriptTime = 0.f;
+			NextActionTime = Now + GetJitteredTime(BotStayTime);
+		}
+		else if (Now - JoinRequestTime > BotJoinTimeout)
+		{
+			WriteReportLine(TEXT("JoinTimeout"));
+			Leave(TEXT("join timed out"));
+		}
+		break;
+
+	case ELobbyBotState::Playing:
+		if (!bIsConnected)
+		{
+			WriteReportLine(TEXT("Disconnected"));
+			Leave(TEXT("disconnected"));
+		}
+		else if (Now >= NextActionTime)
+		{
+			WriteReportLine(TEXT("Leave"));
+			Leave(TEXT("stay time elapsed"));
+		}
+		else if (Character)
+		{
+			// Walk a wobbling circle while slowly turning, so movement and rotation keep replicating
+			ScriptTime += DeltaTime;
+			const FVector2D MovementVector(FMath::Sin(ScriptTime), FMath::Cos(ScriptTime * 0.7f));
+			const FVector2D LookAxisVector(0.5f, 0.f);
+			Character->AddScriptedInput(MovementVector, LookAxisVector);
+		}
+		break;
+	}
+
+	return true;
+}
+
+/** Travel to the lobby server */
+void ULobbyBotSubsystem::Join()
+{
+	UWorld* World = GetGameInstance()->GetWorld();
+	if (!GEngine || !World)
+	{
+		NextActionTime = FPlatformTime::Seconds() + GetJitteredTime(BotRejoinDelay);
+		return;
+	}
+
+	State = ELobbyBotState::Joining;
+	JoinRequestTime = FPlatformTime::Seconds();
+	GEngine->SetClientTravel(World, *BotServerAddress, TRAVEL_Absolute);
+}
+
+/** Disconnect from the lobby server */
+void ULobbyBotSubsystem::Leave(const TCHAR* Reason)
+{
+	UE_LOG(LogMenuSystem, Log, TEXT("Lobby bot leaving: %s"), Reason);
+
+	// Also cancels pending connections, for joins that timed out
+	UWorld* World = GetGameInstance()->GetWorld();
+	if (GEngine && World)
+	{
+		GEngine->Exec(World, TEXT("disconnect"));
+	}
+
+	ScheduleRejoin();
+}
+
+/** Go back to idle, scheduling the next join if the bot has cycles left */
+void ULobbyBotSubsystem::ScheduleRejoin()
+{
+	State = ELobbyBotState::Idle;
+	NextActionTime = FPlatformTime::Seconds() + GetJitteredTime(BotRejoinDelay);
+
+	++CompletedCycles;
+	if (BotCycles > 0 && CompletedCycles >= BotCycles)
+	{
+		FTSTicker::GetCoreTicker().RemoveTicker(BotTickerHandle);
+		BotTickerHandle.Reset();
+		FPlatformMisc::RequestExit(false);
+	}
+}
+
+/** Callback called when a net driver fails, used for detecting failed joins and kicks */
+void ULobbyBotSubsystem::OnNetworkFailure(UWorld* World, UNetDriver* NetDriver, ENetworkFailure::Type FailureType, const FString& ErrorString)
+{
+	if (State == ELobbyBotState::Idle)
+	{
+		return;
+	}
+
+	// The engine already returns to the default map on network failures
+	UE_LOG(LogMenuSystem, Log, TEXT("Lobby bot network failure: %s"), *ErrorString);
+	WriteReportLine(State == ELobbyBotState::Joining ? TEXT("JoinFailed") : TEXT("Disconnected"));
+	ScheduleRejoin();
+}
+
+/** Callback called when a travel fails, used for detecting failed joins */
+void ULobbyBotSubsystem::OnTravelFailure(UWorld* World, ETravelFailure::Type FailureType, const FString& ErrorString)
+{
+	if (State != ELobbyBotState::Joining)
+	{
+		return;
+	}
+
+	UE_LOG(LogMenuSystem, Log, TEXT("Lobby bot travel failure: %s"), *ErrorString);
+	WriteReportLine(TEXT("JoinFailed"));
+	ScheduleRejoin();
+}
+
+/** Time, in seconds, randomized by the configured jitter */
+float ULobbyBotSubsystem::GetJitteredTime(float Time) const
+{
+	const float Jitter = FMath::Clamp(BotJitter, 0.f, 1.f);
+	return FMath::Max(0.f, Time * FMath::FRandRange(1.f - Jitter, 1.f + Jitter));
+}
+
+/** Append event to the bot's report */
+void ULobbyBotSubsystem::WriteReportLine(const TCHAR* Event, double LoginLatency) const
+{
+	const FString Line = FString::Printf(TEXT("%.3f,%s,%.1f\n"), FPlatformTime::Seconds(), Event, LoginLatency * 1000.0);
+	FFileHelper::SaveStringToFile(Line, *ReportFilename, FFileHelper::EEncodingOptions::AutoDetect, &IFileManager::Get(), FILEWRITE_Append);
+}
+
+#pragma endregion BOT
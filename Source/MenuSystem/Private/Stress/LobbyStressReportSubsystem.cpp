@@ -0,0 +1,105 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Stress/LobbyStressReportSubsystem.h"
+
+// Unreal Engine
+#include "Engine/GameInstance.h"
+#include "Engine/NetDriver.h"
+#include "Engine/World.h"
+#include "HAL/FileManager.h"
+#include "Misc/CommandLine.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Parse.h"
+#include "Misc/Paths.h"
+
+// MenuSystem
+#include "MenuSystem.h"
+#include "GameModes/LobbyGameMode.h"
+
+#pragma region INITIALIZATION
+
+/** Only create the subsystem when reporting was requested */
+bool ULobbyStressReportSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+	return FParse::Param(FCommandLine::Get(), TEXT("LobbyStressReport")) && Super::ShouldCreateSubsystem(Outer);
+}
+
+/** Initialize subsystem */
+void ULobbyStressReportSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	FParse::Value(FCommandLine::Get(), TEXT("StressReportInterval="), StressReportInterval);
+	StressReportInterval = FMath::Max(0.1f, StressReportInterval);
+
+	ReportFilename = FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("Stress"), FString::Printf(TEXT("LobbyServer_%u.csv"), FPlatformProcess::GetCurrentProcessId()));
+	FFileHelper::SaveStringToFile(TEXT("Time,Connections,AvgFrameMs,MaxFrameMs,InBytesPerSecond,OutBytesPerSecond,QueueDepth,AvgQueueWaitMs\n"), *ReportFilename);
+
+	ReportTickerHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateUObject(this, &ULobbyStressReportSubsystem::TickReport));
+
+	UE_LOG(LogMenuSystem, Log, TEXT("Lobby stress report written to %s"), *ReportFilename);
+}
+
+/** Deinitialize subsystem */
+void ULobbyStressReportSubsystem::Deinitialize()
+{
+	FTSTicker::GetCoreTicker().RemoveTicker(ReportTickerHandle);
+	ReportTickerHandle.Reset();
+
+	Super::Deinitialize();
+}
+
+#pragma endregion INITIALIZATION
+
+#pragma region REPORT
+
+/** Ticker callback sampling frame times and writing the report */
+bool ULobbyStressReportSubsystem::TickReport(float DeltaTime)
+{
+	IntervalTime += DeltaTime;
+	++IntervalFrames;
+	IntervalMaxFrameTime = FMath::Max(IntervalMaxFrameTime, DeltaTime);
+
+	if (IntervalTime < StressReportInterval)
+	{
+		return true;
+	}
+
+	// Bandwidth is the net driver's own per second average, so it lines up with the frame time window
+	int32 NumConnections = 0;
+	uint32 InBytesPerSecond = 0;
+	uint32 OutBytesPerSecond = 0;
+	const UWorld* World = GetGameInstance()->GetWorld();
+	if (const UNetDriver* NetDriver = World ? World->GetNetDriver() : nullptr)
+	{
+		NumConnections = NetDriver->ClientConnections.Num();
+		InBytesPerSecond = NetDriver->InBytesPerSecond;
+		OutBytesPerSecond = NetDriver->OutBytesPerSecond;
+	}
+
+	FLobbyAdmissionMetrics AdmissionMetrics;
+	if (const ALobbyGameMode* LobbyGameMode = World ? World->GetAuthGameMode<ALobbyGameMode>() : nullptr)
+	{
+		AdmissionMetrics = LobbyGameMode->GetAdmissionMetrics();
+	}
+
+	const FString Line = FString::Printf(
+		TEXT("%.3f,%d,%.2f,%.2f,%u,%u,%d,%.1f\n"),
+		FPlatformTime::Seconds(),
+		NumConnections,
+		IntervalTime / IntervalFrames * 1000.f,
+		IntervalMaxFrameTime * 1000.f,
+		InBytesPerSecond,
+		OutBytesPerSecond,
+		AdmissionMetrics.QueueDepth,
+		AdmissionMetrics.AverageWaitTime * 1000.f
+	);
+	FFileHelper::SaveStringToFile(Line, *ReportFilename, FFileHelper::EEncodingOptions::AutoDetect, &IFileManager::Get(), FILEWRITE_Append);
+
+	IntervalTime = 0.f;
+	IntervalFrames = 0;
+	IntervalMaxFrameTime = 0.f;
+	return true;
+}
+
+#pragma endregion REPORT
@@ -51,6 +51,14 @@ protected:
 
 	/** Called for looking input */
 	void Look(const FInputActionValue& Value);
+
+	/** Timestamp input for the movement latency trace, when it's running */
+	void RecordLatencyInput();
+
+public:
+
+	/** Apply movement and looking input coming from a script (e.g. stress test bots) instead of the input mapping context */
+	void AddScriptedInput(const FVector2D& MovementVector, const FVector2D& LookAxisVector);
 			
 
 protected:
@@ -60,6 +68,15 @@ protected:
 	// To add mapping context
 	virtual void BeginPlay();
 
+public:
+	// AActor interface
+	/** Lower the character's priority on spectators' connections, so their capped bandwidth goes to it less often */
+	virtual float GetNetPriority(const FVector& ViewPos, const FVector& ViewDir, AActor* Viewer, AActor* ViewTarget, UActorChannel* InChannel, float Time, bool bLowBandwidth) override;
+
+	// ACharacter interface
+	/** Count server corrections of the predicted movement for the movement latency trace */
+	virtual void OnClientCorrectionReceived(class FNetworkPredictionData_Client_Character& ClientData, float TimeStamp, FVector NewLocation, FVector NewVelocity, UPrimitiveComponent* NewBase, FName NewBaseBoneName, bool bHasBase, bool bBaseRelativePosition, uint8 ServerMovementMode) override;
+
 public:
 	/** Returns CameraBoom subobject **/
 	FORCEINLINE class USpringArmComponent* GetCameraBoom() const { return CameraBoom; }
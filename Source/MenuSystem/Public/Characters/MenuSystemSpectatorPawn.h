@@ -0,0 +1,25 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+// Unreal Engine
+#include "CoreMinimal.h"
+#include "GameFramework/SpectatorPawn.h"
+
+#include "MenuSystemSpectatorPawn.generated.h"
+
+/**
+ * Pawn spectators watch the lobby with. Only spawned on the spectator's own machine and kept out of collision,
+ * so watching costs the host nothing beyond the spectator's connection.
+ */
+UCLASS()
+class MENUSYSTEM_API AMenuSystemSpectatorPawn : public ASpectatorPawn
+{
+	GENERATED_BODY()
+
+public:
+
+	/** Constructor */
+	AMenuSystemSpectatorPawn(const FObjectInitializer& ObjectInitializer);
+	
+};
@@ -8,7 +8,58 @@
 
 #include "LobbyGameMode.generated.h"
 
-UCLASS()
+/** Admission control metrics of the lobby */
+USTRUCT(BlueprintType)
+struct FLobbyAdmissionMetrics
+{
+	GENERATED_USTRUCT_BODY()
+
+public:
+
+	/** Number of players waiting in the login queue */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+	int32 QueueDepth = 0;
+
+	/** Number of players admitted since the lobby started */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+	int32 NumAdmitted = 0;
+
+	/** Number of connections rejected in PreLogin since the lobby started */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+	int32 NumRejected = 0;
+
+	/** Number of players logged in since the lobby started */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+	int32 NumLogins = 0;
+
+	/** Number of players logged out since the lobby started */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+	int32 NumLogouts = 0;
+
+	/** Number of admitted players that had to wait in the queue */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+	int32 NumQueued = 0;
+
+	/** Average time, in seconds, admitted players that were queued waited in the queue */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+	float AverageWaitTime = 0.f;
+
+	/** Longest time, in seconds, an admitted player waited in the queue */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+	float MaxWaitTime = 0.f;
+};
+
+/** Player waiting in the login queue */
+struct FLobbyQueuedPlayer
+{
+	/** Queued player's controller */
+	TWeakObjectPtr<APlayerController> PlayerController;
+
+	/** Time, in seconds, the player was queued at */
+	double QueueTime = 0.0;
+};
+
+UCLASS(config=Game)
 class MENUSYSTEM_API ALobbyGameMode : public AGameModeBase
 {
 	GENERATED_BODY()
@@ -17,12 +68,141 @@ class MENUSYSTEM_API ALobbyGameMode : public AGameModeBase
 	
 public:
 
+	/** Constructor */
+	ALobbyGameMode();
+
+	/** Accept or reject a player attempting to join the server */
+	virtual void PreLogin(const FString& Options, const FString& Address, const FUniqueNetIdRepl& UniqueId, FString& ErrorMessage) override;
+
 	/** Called after a successful login. This is the first place it is safe to call replicated functions on the PlayerController */
 	virtual void PostLogin(APlayerController* NewPlayer) override;
 
 	/** Called when a Controller with a PlayerState leaves the game or is destroyed */
 	virtual void Logout(AController* Exiting) override;
 
+protected:
+
+	/** Called when the game mode is ready to start, used for starting the admission timer */
+	virtual void BeginPlay() override;
+
+	/** Start new player, or queue them if the login rate is exceeded. Spectators skip the queue */
+	virtual void HandleStartingNewPlayer_Implementation(APlayerController* NewPlayer) override;
+
 #pragma endregion OVERRIDES
+
+#pragma region ADMISSION
+
+public:
+
+	/** Get admission control metrics */
+	UFUNCTION(BlueprintPure)
+	FLobbyAdmissionMetrics GetAdmissionMetrics() const;
+
+private:
+
+	/** Timer callback refilling login tokens and admitting queued players */
+	void UpdateAdmission();
+
+	/** Take a login token, if any is available */
+	bool ConsumeLoginToken();
+
+	/** Start queued player's game */
+	void AdmitPlayer(const FLobbyQueuedPlayer& QueuedPlayer);
+
+	/** Tell queued players their position in the queue */
+	void NotifyQueuePositions(int32 FirstIndex = 0) const;
+
+	/** Maximum number of players, including queued ones. 0 uses the game session's MaxPlayers */
+	int32 GetLobbyCapacity() const;
+
+private:
+
+	/** Maximum number of players, including queued ones. 0 uses the game session's MaxPlayers */
+	UPROPERTY(Config, EditDefaultsOnly, Category = "Admission")
+	int32 MaxLobbyPlayers = 0;
+
+	/** Number of players started per second. Excess players wait in the login queue */
+	UPROPERTY(Config, EditDefaultsOnly, Category = "Admission", meta = (ClampMin = "0.1"))
+	float LoginsPerSecond = 4.f;
+
+	/** Maximum number of players waiting in the login queue. Further connections are rejected in PreLogin */
+	UPROPERTY(Config, EditDefaultsOnly, Category = "Admission")
+	int32 MaxLoginQueueLength = 32;
+
+	/** Time, in seconds, between admission updates */
+	UPROPERTY(Config, EditDefaultsOnly, Category = "Admission")
+	float AdmissionUpdateInterval = 0.1f;
+
+	/** Players waiting in the login queue, in arrival order */
+	TArray<FLobbyQueuedPlayer> LoginQueue;
+
+	/** Login tokens available, refilled at LoginsPerSecond */
+	float LoginTokens = 1.f;
+
+	/** Time, in seconds, of the last admission update */
+	double LastAdmissionUpdateTime = 0.0;
+
+	/** Handle for the timer admitting queued players */
+	FTimerHandle AdmissionTimerHandle;
+
+	/** Number of players admitted */
+	int32 NumAdmittedPlayers = 0;
+
+	/** Number of connections rejected in PreLogin */
+	int32 NumRejectedPlayers = 0;
+
+	/** Number of players logged in */
+	int32 NumLogins = 0;
+
+	/** Number of players logged out */
+	int32 NumLogouts = 0;
+
+	/** Number of admitted players that had to wait in the queue */
+	int32 NumQueuedAdmittedPlayers = 0;
+
+	/** Total time, in seconds, admitted players waited in the queue */
+	double TotalQueueWaitTime = 0.0;
+
+	/** Longest time, in seconds, an admitted player waited in the queue */
+	double MaxQueueWaitTime = 0.0;
+
+#pragma endregion ADMISSION
+
+#pragma region SPECTATORS
+
+public:
+
+	/** Scale applied to the priority of players' characters on spectators' connections */
+	float GetSpectatorNetPriority() const { return SpectatorNetPriority; }
+
+private:
+
+	/** Whether the connection options ask for joining as a spectator */
+	static bool IsSpectatorLogin(const FString& Options);
+
+	/** Make spectator's connection cheap: capped bandwidth and rare updates of its own controller and player state */
+	void ThrottleSpectator(APlayerController* Spectator) const;
+
+	/** Update the session so a spectator's slot counts as a private one instead of a public one, or back when leaving. Returns whether the update was requested */
+	bool MoveSpectatorSlot(bool bIsJoining) const;
+
+private:
+
+	/** Scale applied to the priority of players' characters on spectators' connections, so their capped bandwidth goes to other updates first. 1 treats them like players */
+	UPROPERTY(Config, EditDefaultsOnly, Category = "Spectators", meta = (ClampMin = "0.01", ClampMax = "1.0"))
+	float SpectatorNetPriority = 0.25f;
+
+	/** Bandwidth, in bytes per second, spectators' connections are capped to. 0 doesn't cap it */
+	UPROPERTY(Config, EditDefaultsOnly, Category = "Spectators")
+	int32 SpectatorNetSpeed = 5000;
+
+	/** Number of times per second spectators' own controller and player state are considered for replication */
+	UPROPERTY(Config, EditDefaultsOnly, Category = "Spectators", meta = (ClampMin = "0.1"))
+	float SpectatorNetUpdateFrequency = 1.f;
+
+	/** Spectators whose slot was moved to the session's private ones, which is undone when they leave */
+	TSet<TWeakObjectPtr<AController>> PrivateSlotSpectators;
+
+#pragma endregion SPECTATORS
 	
 };
@@ -0,0 +1,93 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+// Unreal Engine
+#include "CoreMinimal.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+#include "Containers/Ticker.h"
+#include "HttpRouteHandle.h"
+#include "HttpResultCallback.h"
+
+#include "LobbyMetricsSubsystem.generated.h"
+
+// Forward declarations - Unreal Engine
+class IHttpRouter;
+struct FHttpServerRequest;
+
+/**
+ * Serves a lobby server's player count, login rates, session operation latencies, tick time and bandwidth
+ * in Prometheus text format, on http://<bind address>:<MetricsPort>/metrics.
+ * Enabled by setting MetricsPort, or with -MetricsPort= (one port per process when several run on one box)
+ */
+UCLASS(config=Game)
+class MENUSYSTEM_API ULobbyMetricsSubsystem : public UGameInstanceSubsystem
+{
+	GENERATED_BODY()
+
+#pragma region INITIALIZATION
+
+public:
+
+	/** Only create the subsystem when a metrics port was configured */
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+
+	/** Initialize subsystem */
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+
+	/** Deinitialize subsystem */
+	virtual void Deinitialize() override;
+
+private:
+
+	/** Port metrics are served on, 0 if disabled */
+	int32 GetMetricsPort() const;
+
+#pragma endregion INITIALIZATION
+
+#pragma region METRICS
+
+private:
+
+	/** Ticker callback accumulating frame times */
+	bool TickFrameTime(float DeltaTime);
+
+	/** Route callback answering scrapes with the current metrics */
+	bool HandleMetricsRequest(const FHttpServerRequest& Request, const FHttpResultCallback& OnComplete);
+
+	/** Write current metrics in Prometheus text format */
+	FString WriteMetrics() const;
+
+private:
+
+	/** Port metrics are served on. 0 disables the exporter. Overridden by -MetricsPort= */
+	UPROPERTY(Config)
+	int32 MetricsPort = 0;
+
+	/** Router serving the metrics route */
+	TSharedPtr<IHttpRouter> MetricsRouter;
+
+	/** Handle for the metrics route */
+	FHttpRouteHandle MetricsRouteHandle;
+
+	/** Handle for the ticker accumulating frame times */
+	FTSTicker::FDelegateHandle FrameTimeTickerHandle;
+
+	/** Number of frames since the subsystem started */
+	uint64 NumFrames = 0;
+
+	/** Total frame time, in seconds, since the subsystem started */
+	double TotalFrameTime = 0.0;
+
+	/** Longest frame, in seconds, of the current one second window */
+	float CurrentWindowMaxFrameTime = 0.f;
+
+	/** Longest frame, in seconds, of the previous one second window */
+	float PreviousWindowMaxFrameTime = 0.f;
+
+	/** Time, in seconds, accumulated in the current one second window */
+	float CurrentWindowTime = 0.f;
+
+#pragma endregion METRICS
+
+};
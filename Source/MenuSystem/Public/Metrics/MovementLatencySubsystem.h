@@ -0,0 +1,123 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+// Unreal Engine
+#include "CoreMinimal.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+#include "Containers/Ticker.h"
+
+#include "MovementLatencySubsystem.generated.h"
+
+// Forward declarations - MenuSystem
+class AMenuSystemCharacter;
+
+/** Input waiting for the server to acknowledge the move it was sent with */
+struct FMovementLatencyInput
+{
+	/** Client time stamp of the saved move the input was applied by */
+	float MoveTimeStamp = 0.f;
+
+	/** Time, in seconds, the input reached the character */
+	double InputTime = 0.0;
+};
+
+/**
+ * Traces the local character's input through client prediction and the server's acknowledgement:
+ * input-to-render, input-to-server-ack and server corrections, under whatever packet lag and loss is simulated (-PktLag=, -PktLoss=).
+ * Reported as the MovementLatency stat group and CSV profiler category, and as a CSV under Saved/Latency.
+ * Enabled by bTraceMovementLatency, or with -MovementLatencyReport
+ */
+UCLASS(config=Game)
+class MENUSYSTEM_API UMovementLatencySubsystem : public UGameInstanceSubsystem
+{
+	GENERATED_BODY()
+
+#pragma region INITIALIZATION
+
+public:
+
+	/** Only create the subsystem on clients, when tracing was requested */
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+
+	/** Initialize subsystem */
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+
+	/** Deinitialize subsystem */
+	virtual void Deinitialize() override;
+
+#pragma endregion INITIALIZATION
+
+#pragma region TRACE
+
+public:
+
+	/** Timestamp input applied to the character, unless earlier input is still waiting for its movement */
+	void RecordInput(AMenuSystemCharacter* Character);
+
+	/** Count a server correction of the character's predicted movement */
+	void RecordCorrection(AMenuSystemCharacter* Character);
+
+private:
+
+	/** Callback called at the end of every frame, once the frame's movement was applied and handed to rendering */
+	void OnEndFrame();
+
+	/** Match acknowledged moves with the inputs they carried */
+	void ProcessAcknowledgedMoves(float AckedTimeStamp, double Now);
+
+	/** Ticker callback writing the report and updating the stats */
+	bool TickReport(float DeltaTime);
+
+	/** Value below which the given fraction of the samples fall */
+	static float GetPercentile(TArray<float>& Samples, float Fraction);
+
+private:
+
+	/** Whether to trace the local character's movement latency. -MovementLatencyReport enables it too */
+	UPROPERTY(Config)
+	bool bTraceMovementLatency = false;
+
+	/** Time, in seconds, between report lines. Overridden by -MovementLatencyReportInterval= */
+	UPROPERTY(Config)
+	float MovementLatencyReportInterval = 1.f;
+
+	/** Maximum number of inputs waiting for their acknowledgement, the oldest ones being dropped first */
+	static constexpr int32 MaxUnacknowledgedInputs = 256;
+
+	/** Character the input was recorded for */
+	TWeakObjectPtr<AMenuSystemCharacter> TracedCharacter;
+
+	/** Time, in seconds, of the earliest input not yet applied by a frame's movement. 0 if none */
+	double PendingInputTime = 0.0;
+
+	/** Inputs sent to the server, in move order */
+	TArray<FMovementLatencyInput> UnacknowledgedInputs;
+
+	/** Time stamp of the last move acknowledged by the server */
+	float LastAckedTimeStamp = 0.f;
+
+	/** Input-to-render latencies, in milliseconds, since the last report line */
+	TArray<float> InputToRenderSamples;
+
+	/** Input-to-server-ack latencies, in milliseconds, since the last report line */
+	TArray<float> InputToAckSamples;
+
+	/** Number of server corrections since the last report line */
+	int32 IntervalCorrections = 0;
+
+	/** Time, in seconds, accumulated since the last report line */
+	float IntervalTime = 0.f;
+
+	/** File the report is written to */
+	FString ReportFilename;
+
+	/** Handle for the delegate called at the end of every frame */
+	FDelegateHandle EndFrameDelegateHandle;
+
+	/** Handle for the ticker writing the report */
+	FTSTicker::FDelegateHandle ReportTickerHandle;
+
+#pragma endregion TRACE
+
+};
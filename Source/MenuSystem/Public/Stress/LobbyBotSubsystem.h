@@ -0,0 +1,135 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+// Unreal Engine
+#include "CoreMinimal.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+#include "Containers/Ticker.h"
+#include "Engine/EngineBaseTypes.h"
+
+#include "LobbyBotSubsystem.generated.h"
+
+// Forward declarations - Unreal Engine
+class UNetDriver;
+
+/** Progress of a lobby bot through its join/leave schedule */
+enum class ELobbyBotState : uint8
+{
+	Idle,
+	Joining,
+	Playing
+};
+
+/**
+ * Headless client joining a lobby server, moving its character with scripted input and leaving on a schedule, for login throughput stress tests.
+ * Enabled with -LobbyBot, e.g. MenuSystem -game -nullrhi -nosound -nosteam -LobbyBot -BotServer=127.0.0.1:7777 -BotStayTime=30 -BotRejoinDelay=5
+ */
+UCLASS(config=Game)
+class MENUSYSTEM_API ULobbyBotSubsystem : public UGameInstanceSubsystem
+{
+	GENERATED_BODY()
+
+#pragma region INITIALIZATION
+
+public:
+
+	/** Only create the subsystem when running as a bot */
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+
+	/** Initialize subsystem */
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+
+	/** Deinitialize subsystem */
+	virtual void Deinitialize() override;
+
+#pragma endregion INITIALIZATION
+
+#pragma region BOT
+
+private:
+
+	/** Ticker callback driving the bot's schedule and scripted input */
+	bool TickBot(float DeltaTime);
+
+	/** Travel to the lobby server */
+	void Join();
+
+	/** Disconnect from the lobby server */
+	void Leave(const TCHAR* Reason);
+
+	/** Go back to idle, scheduling the next join if the bot has cycles left */
+	void ScheduleRejoin();
+
+	/** Callback called when a net driver fails, used for detecting failed joins and kicks */
+	void OnNetworkFailure(UWorld* World, UNetDriver* NetDriver, ENetworkFailure::Type FailureType, const FString& ErrorString);
+
+	/** Callback called when a travel fails, used for detecting failed joins */
+	void OnTravelFailure(UWorld* World, ETravelFailure::Type FailureType, const FString& ErrorString);
+
+	/** Time, in seconds, randomized by the configured jitter */
+	float GetJitteredTime(float Time) const;
+
+	/** Append event to the bot's report */
+	void WriteReportLine(const TCHAR* Event, double LoginLatency = 0.0) const;
+
+private:
+
+	/** Address (host[:port]) of the lobby server. Overridden by -BotServer= */
+	UPROPERTY(Config)
+	FString BotServerAddress = TEXT("127.0.0.1:7777");
+
+	/** Time, in seconds, before the first join. Overridden by -BotJoinDelay= */
+	UPROPERTY(Config)
+	float BotJoinDelay = 0.f;
+
+	/** Time, in seconds, the bot stays in the lobby before leaving. Overridden by -BotStayTime= */
+	UPROPERTY(Config)
+	float BotStayTime = 30.f;
+
+	/** Time, in seconds, before joining again after leaving. Overridden by -BotRejoinDelay= */
+	UPROPERTY(Config)
+	float BotRejoinDelay = 5.f;
+
+	/** Fraction each scheduled time is randomized by, so bots launched together spread out. Overridden by -BotJitter= */
+	UPROPERTY(Config)
+	float BotJitter = 0.2f;
+
+	/** Time, in seconds, a join may take before it's considered failed. Overridden by -BotJoinTimeout= */
+	UPROPERTY(Config)
+	float BotJoinTimeout = 30.f;
+
+	/** Number of join/leave cycles before the bot exits. 0 cycles forever. Overridden by -BotCycles= */
+	UPROPERTY(Config)
+	int32 BotCycles = 0;
+
+	/** Current state */
+	ELobbyBotState State = ELobbyBotState::Idle;
+
+	/** Time, in seconds, of the next scheduled join or leave */
+	double NextActionTime = 0.0;
+
+	/** Time, in seconds, the current join was requested at */
+	double JoinRequestTime = 0.0;
+
+	/** Time, in seconds, the bot has been moving its character for */
+	float ScriptTime = 0.f;
+
+	/** Number of join/leave cycles done */
+	int32 CompletedCycles = 0;
+
+	/** File the bot's report is written to */
+	FString ReportFilename;
+
+	/** Handle for the ticker driving the bot */
+	FTSTicker::FDelegateHandle BotTickerHandle;
+
+	/** Handle for the delegate called when a net driver fails */
+	FDelegateHandle NetworkFailureDelegateHandle;
+
+	/** Handle for the delegate called when a travel fails */
+	FDelegateHandle TravelFailureDelegateHandle;
+
+#pragma endregion BOT
+
+};
@@ -0,0 +1,66 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+// Unreal Engine
+#include "CoreMinimal.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+#include "Containers/Ticker.h"
+
+#include "LobbyStressReportSubsystem.generated.h"
+
+/**
+ * Periodically reports a lobby server's connection count, frame time and bandwidth, for login throughput stress tests.
+ * Enabled with -LobbyStressReport on the server
+ */
+UCLASS(config=Game)
+class MENUSYSTEM_API ULobbyStressReportSubsystem : public UGameInstanceSubsystem
+{
+	GENERATED_BODY()
+
+#pragma region INITIALIZATION
+
+public:
+
+	/** Only create the subsystem when reporting was requested */
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+
+	/** Initialize subsystem */
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+
+	/** Deinitialize subsystem */
+	virtual void Deinitialize() override;
+
+#pragma endregion INITIALIZATION
+
+#pragma region REPORT
+
+private:
+
+	/** Ticker callback sampling frame times and writing the report */
+	bool TickReport(float DeltaTime);
+
+private:
+
+	/** Time, in seconds, between report lines. Overridden by -StressReportInterval= */
+	UPROPERTY(Config)
+	float StressReportInterval = 1.f;
+
+	/** File the report is written to */
+	FString ReportFilename;
+
+	/** Time, in seconds, accumulated since the last report line */
+	float IntervalTime = 0.f;
+
+	/** Number of frames since the last report line */
+	int32 IntervalFrames = 0;
+
+	/** Longest frame, in seconds, since the last report line */
+	float IntervalMaxFrameTime = 0.f;
+
+	/** Handle for the ticker sampling the server */
+	FTSTicker::FDelegateHandle ReportTickerHandle;
+
+#pragma endregion REPORT
+
+};